@@ -0,0 +1,267 @@
+/**
+ ******************************************************************************
+ *
+ * Copyright (c) 2025 KaiserEngineering, LLC
+ * Author Matthew Kaiser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************
+ */
+
+#include <time.h>
+#include "test_support.h"
+
+#ifdef HAVE_CJSON
+#include "cJSON.h"
+#endif
+
+// Host benchmarks, run by hand: bench_settings [iterations]. Times are wall
+// clock per call over a RAM device, so they compare paths rather than predict
+// target numbers.
+
+static uint32_t iterations = 20000;
+static volatile uint32_t sink;
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+#define BENCH(label, count, body)                                               \
+	do                                                                          \
+	{                                                                           \
+		double start = now_ns();                                                \
+		for (uint32_t n = 0; n < (count); n++)                                  \
+		{                                                                       \
+			body;                                                               \
+		}                                                                       \
+		printf("%-34s %10.1f ns\n", label, (now_ns() - start) / (count));       \
+	} while (0)
+
+static uint8_t byte_read(uint16_t bAdd)
+{
+	return test_device[bAdd];
+}
+
+static void byte_write(uint16_t bAdd, uint8_t bData)
+{
+	test_device[bAdd] = bData;
+}
+
+// load_settings() of a full image: one block read and one decode sweep, the
+// same with the per-byte handlers the original component used, and a lazy
+// boot that defers every section to its first access
+static void bench_boot(void)
+{
+	CHECK(settings_set_backend(&test_backend));
+	load_settings();
+	test_set_sample(2, true);
+
+	test_device_reset_counts();
+	BENCH("boot, block backend", iterations, load_settings());
+	printf("%-34s %10.1f\n", "  device reads per boot", (double)test_device_reads() / iterations);
+
+	settings_set_lazy_load(true);
+	BENCH("boot, lazy", iterations, load_settings());
+	BENCH("boot, lazy, then every section", iterations, {
+		load_settings();
+		for (uint8_t section = 0; section < SETTINGS_SECTION_COUNT; section++)
+			settings_prefetch((SETTINGS_SECTION)section);
+	});
+	settings_set_lazy_load(false);
+
+	settings_setReadHandler(byte_read);
+	settings_setWriteHandler(byte_write);
+	CHECK(settings_set_backend(NULL));
+	BENCH("boot, byte handlers", iterations, load_settings());
+	CHECK(test_sample_matches() == 2);
+}
+
+// Getters are plain array loads once the section is in RAM
+static void bench_getters(void)
+{
+	uint32_t calls = iterations * 500;
+
+	CHECK(settings_set_backend(&test_backend));
+	load_settings();
+
+	BENCH("get_view_gauge_pid", calls, sink += get_view_gauge_pid(n % MAX_VIEWS, n % MAX_GAUGES_PER_VIEW));
+	BENCH("get_alert_threshold", calls, sink += (uint32_t)get_alert_threshold(n % MAX_ALERTS));
+	BENCH("get_dynamic_priority", calls, sink += get_dynamic_priority(n % MAX_DYNAMICS));
+}
+
+static void count_sink(void *context, const char *data, uint32_t len)
+{
+	(void)data;
+	*(uint32_t *)context += len;
+}
+
+#ifdef HAVE_CJSON
+// config_to_json() as it was before the streaming writer, a cJSON tree printed
+// into a heap buffer and copied out
+static uint32_t config_to_json_cjson(char *buffer, uint32_t buffer_size)
+{
+	cJSON *root = cJSON_CreateObject();
+	char str_buf[1024];
+
+	if (!root)
+		return 0;
+
+	cJSON *views = cJSON_AddArrayToObject(root, "view");
+	for (int i = 0; i < MAX_VIEWS; i++)
+	{
+		cJSON *view = cJSON_CreateObject();
+		cJSON_AddStringToObject(view, "enable", view_state_string[get_view_enable(i)]);
+		cJSON_AddNumberToObject(view, "num_gauges", get_view_num_gauges(i));
+		cJSON_AddStringToObject(view, "background", view_background_string[get_view_background(i)]);
+		cJSON_AddNumberToObject(view, "background_color", get_view_background_color(i));
+		cJSON_AddStringToObject(view, "background_type", view_background_type_string[get_view_background_type(i)]);
+
+		cJSON *gauges = cJSON_AddArrayToObject(view, "gauge");
+		for (int j = 0; j < MAX_GAUGES_PER_VIEW; j++)
+		{
+			cJSON *gauge = cJSON_CreateObject();
+			cJSON_AddStringToObject(gauge, "theme", gauge_theme_string[get_view_gauge_theme(i, j)]);
+			get_pid_desc(get_view_gauge_pid(i, j), str_buf);
+			cJSON_AddStringToObject(gauge, "pid", str_buf);
+			get_unit_desc(get_view_gauge_units(i, j), str_buf);
+			cJSON_AddStringToObject(gauge, "units", str_buf);
+			cJSON_AddItemToArray(gauges, gauge);
+		}
+		cJSON_AddItemToArray(views, view);
+	}
+
+	cJSON *alerts = cJSON_AddArrayToObject(root, "alert");
+	for (int i = 0; i < MAX_ALERTS; i++)
+	{
+		cJSON *alert = cJSON_CreateObject();
+		cJSON_AddStringToObject(alert, "enable", alert_state_string[get_alert_enable(i)]);
+		get_pid_desc(get_alert_pid(i), str_buf);
+		cJSON_AddStringToObject(alert, "pid", str_buf);
+		get_unit_desc(get_alert_units(i), str_buf);
+		cJSON_AddStringToObject(alert, "units", str_buf);
+		get_alert_message(i, str_buf);
+		cJSON_AddStringToObject(alert, "message", str_buf);
+		cJSON_AddStringToObject(alert, "compare", alert_comparison_string[get_alert_compare(i)]);
+		cJSON_AddNumberToObject(alert, "threshold", get_alert_threshold(i));
+		cJSON_AddItemToArray(alerts, alert);
+	}
+
+	cJSON *dynamics = cJSON_AddArrayToObject(root, "dynamic");
+	for (int i = 0; i < MAX_DYNAMICS; i++)
+	{
+		cJSON *dynamic = cJSON_CreateObject();
+		cJSON_AddStringToObject(dynamic, "enable", dynamic_state_string[get_dynamic_enable(i)]);
+		cJSON_AddStringToObject(dynamic, "priority", dynamic_priority_string[get_dynamic_priority(i)]);
+		cJSON_AddStringToObject(dynamic, "compare", dynamic_comparison_string[get_dynamic_compare(i)]);
+		cJSON_AddNumberToObject(dynamic, "threshold", get_dynamic_threshold(i));
+		cJSON_AddNumberToObject(dynamic, "view_index", get_dynamic_view_index(i));
+		get_pid_desc(get_dynamic_pid(i), str_buf);
+		cJSON_AddStringToObject(dynamic, "pid", str_buf);
+		get_unit_desc(get_dynamic_units(i), str_buf);
+		cJSON_AddStringToObject(dynamic, "units", str_buf);
+		cJSON_AddItemToArray(dynamics, dynamic);
+	}
+
+	cJSON *generals = cJSON_AddArrayToObject(root, "general");
+	for (int i = 0; i < MAX_GENERALS; i++)
+	{
+		cJSON *general = cJSON_CreateObject();
+		cJSON_AddNumberToObject(general, "EE_Version", get_general_ee_version(i));
+		cJSON_AddNumberToObject(general, "splash", get_general_splash(i));
+		cJSON_AddStringToObject(general, "can_bus_mode", can_bus_mode_string[get_general_can_bus_mode(i)]);
+		cJSON_AddItemToArray(generals, general);
+	}
+
+	char *json = cJSON_PrintUnformatted(root);
+	uint32_t actual_len = 0;
+	if (json)
+	{
+		size_t len = strlen(json);
+		if (len < buffer_size)
+		{
+			memcpy(buffer, json, len + 1);
+			actual_len = (uint32_t)len;
+		}
+		free(json);
+	}
+	cJSON_Delete(root);
+
+	return actual_len;
+}
+#endif
+
+// The whole document in pieces of one small MTU
+static uint32_t config_to_json_pieces(char *buffer)
+{
+	settings_json_cursor cursor = {0};
+	uint32_t len = 0;
+	uint32_t piece;
+
+	while ((piece = config_to_json_next(&cursor, &buffer[len], 20)) > 0)
+		len += piece;
+
+	return len;
+}
+
+static void bench_config_json(void)
+{
+	static char buffer[4096];
+	uint32_t counted = 0;
+
+	CHECK(settings_set_backend(&test_backend));
+	load_settings();
+	test_set_sample(2, true);
+
+	BENCH("config_to_json, writer", iterations, sink += config_to_json(buffer, sizeof(buffer)));
+	BENCH("config_to_json_sink", iterations, sink += config_to_json_sink(count_sink, &counted));
+	BENCH("config_json_length", iterations, sink += config_json_length());
+	BENCH("config_to_json_next, 20 bytes", iterations, sink += config_to_json_pieces(buffer));
+
+#ifdef HAVE_CJSON
+	static char reference[4096];
+
+	CHECK(config_to_json_cjson(reference, sizeof(reference)) > 0);
+	CHECK(config_to_json(buffer, sizeof(buffer)) > 0);
+	CHECK(strcmp(reference, buffer) == 0);
+	BENCH("config_to_json, cJSON tree", iterations, sink += config_to_json_cjson(reference, sizeof(reference)));
+#else
+	printf("%-34s %13s\n", "config_to_json, cJSON tree", "no cJSON");
+#endif
+}
+
+static const test_case benches[] = {
+	TEST_CASE(bench_boot),
+	TEST_CASE(bench_getters),
+	TEST_CASE(bench_config_json)
+};
+
+int main(int argc, char **argv)
+{
+	if (argc > 1)
+		iterations = strtoul(argv[1], NULL, 10);
+	if (iterations == 0)
+		iterations = 1;
+
+	return test_main(benches, sizeof(benches) / sizeof(benches[0]));
+}
@@ -0,0 +1,67 @@
+/**
+ ******************************************************************************
+ *
+ * Copyright (c) 2025 KaiserEngineering, LLC
+ * Author Matthew Kaiser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************
+ */
+
+#include "lib_pid.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint32_t number_after(const char *str, const char *prefix)
+{
+	size_t len = strlen(prefix);
+	char *end;
+
+	if (strncmp(str, prefix, len) != 0)
+		return 0;
+
+	unsigned long value = strtoul(&str[len], &end, 10);
+
+	return ((end == &str[len]) || *end || (value > UINT32_MAX)) ? 0 : (uint32_t)value;
+}
+
+void get_pid_desc(uint32_t pid, char *buf)
+{
+	sprintf(buf, "PID%u", (unsigned)pid);
+}
+
+void get_unit_desc(PID_UNITS unit, char *buf)
+{
+	sprintf(buf, "UNITS%u", (unsigned)unit);
+}
+
+uint32_t get_pid_by_string(const char *str)
+{
+	return number_after(str, "PID");
+}
+
+PID_UNITS get_unit_by_string(const char *str)
+{
+	uint32_t unit = number_after(str, "UNITS");
+
+	return (unit > PID_UNITS_RESERVED) ? PID_UNITS_NOT_APPLICABLE : (PID_UNITS)unit;
+}
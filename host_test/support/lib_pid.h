@@ -0,0 +1,59 @@
+/**
+ ******************************************************************************
+ *
+ * Copyright (c) 2025 KaiserEngineering, LLC
+ * Author Matthew Kaiser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************
+ */
+
+#ifndef LIB_PID_H
+#define LIB_PID_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+// Host stand-in for the lib_pid component with just what ke_config uses. PIDs
+// are named "PID<number>" and units "UNITS<number>", unknown names give 0.
+typedef enum
+{
+    PID_UNITS_NOT_APPLICABLE,
+    PID_UNITS_CELSIUS,
+    PID_UNITS_FAHRENHEIT,
+    PID_UNITS_KPA,
+    PID_UNITS_PSI,
+    PID_UNITS_RESERVED = 255
+} PID_UNITS;
+
+void get_pid_desc(uint32_t pid, char *buf);
+void get_unit_desc(PID_UNITS unit, char *buf);
+uint32_t get_pid_by_string(const char *str);
+PID_UNITS get_unit_by_string(const char *str);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIB_PID_H */
@@ -0,0 +1,244 @@
+/**
+ ******************************************************************************
+ *
+ * Copyright (c) 2025 KaiserEngineering, LLC
+ * Author Matthew Kaiser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************
+ */
+
+#include "test_support.h"
+
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+uint8_t *test_device = NULL;
+
+static uint32_t device_writes = 0;
+static uint32_t device_reads = 0;
+static bool cut_armed = false;
+static bool cut_torn = false;
+static uint32_t cut_remaining = 0;
+
+static void test_read_range(uint16_t bAdd, uint8_t *pData, uint16_t len)
+{
+	device_reads++;
+
+	if ((uint32_t)bAdd + len <= TEST_DEVICE_SIZE)
+		memcpy(pData, &test_device[bAdd], len);
+	else
+		memset(pData, 0xFF, len);
+}
+
+static void test_write_range(uint16_t bAdd, const uint8_t *pData, uint16_t len)
+{
+	CHECK((uint32_t)bAdd + len <= TEST_DEVICE_SIZE);
+	CHECK((bAdd / TEST_PAGE_SIZE) == ((bAdd + len - 1) / TEST_PAGE_SIZE));
+
+	if (cut_armed && (cut_remaining-- == 0))
+	{
+		if (cut_torn)
+			memcpy(&test_device[bAdd], pData, len / 2);
+		_exit(TEST_CUT_STATUS);
+	}
+
+	device_writes++;
+	memcpy(&test_device[bAdd], pData, len);
+}
+
+const SETTINGS_BACKEND test_backend = {
+	.open = NULL,
+	.read_range = test_read_range,
+	.write_range = test_write_range,
+	.erase = NULL,
+	.sync = NULL,
+	.caps = {
+		.page_size = TEST_PAGE_SIZE,
+		.write_granularity = 1,
+		.endurance = 0
+	}
+};
+
+void test_device_erase(void)
+{
+	memset(test_device, 0xFF, TEST_DEVICE_SIZE);
+}
+
+uint32_t test_device_writes(void)
+{
+	return device_writes;
+}
+
+uint32_t test_device_reads(void)
+{
+	return device_reads;
+}
+
+void test_device_reset_counts(void)
+{
+	device_writes = 0;
+	device_reads = 0;
+}
+
+void test_device_cut(uint32_t writes, bool torn)
+{
+	cut_armed = true;
+	cut_torn = torn;
+	cut_remaining = writes;
+}
+
+int test_fork(void (*fn)(void))
+{
+	int status;
+
+	fflush(NULL);
+
+	pid_t pid = fork();
+	CHECK(pid >= 0);
+
+	if (pid == 0)
+	{
+		fn();
+		fflush(NULL);
+		_exit(0);
+	}
+
+	CHECK(waitpid(pid, &status, 0) == pid);
+
+	if (WIFEXITED(status))
+		return WEXITSTATUS(status);
+
+	fprintf(stderr, "child killed by signal %d\n", WTERMSIG(status));
+	return -1;
+}
+
+bool test_set_message(uint8_t idx, const char *text, bool save)
+{
+	char message[ALERT_MESSAGE_LEN];
+
+	// Zero padded and terminated, set_alert_message() stores all 64 bytes
+	memset(message, 0, sizeof(message));
+	memcpy(message, text, strnlen(text, sizeof(message) - 1));
+
+	return set_alert_message(idx, message, save);
+}
+
+void test_set_sample(uint8_t sample, bool save)
+{
+	char message[ALERT_MESSAGE_LEN];
+
+	snprintf(message, sizeof(message), "sample %u", (unsigned)sample);
+
+	CHECK(set_view_background(0, VIEW_BACKGROUND_USER1 + sample, save));
+	CHECK(set_view_gauge_pid(2, 2, 0x100 + sample, save));
+	CHECK(test_set_message(1, message, save));
+	CHECK(set_alert_threshold(4, 10.5f + sample, save));
+	CHECK(set_dynamic_view_index(2, sample, save));
+	CHECK(set_general_splash(0, 10 + sample, save));
+}
+
+static bool sample_is(uint8_t sample)
+{
+	char expected[ALERT_MESSAGE_LEN];
+	char message[ALERT_MESSAGE_LEN];
+
+	snprintf(expected, sizeof(expected), "sample %u", (unsigned)sample);
+	get_alert_message(1, message);
+
+	return (get_view_background(0) == VIEW_BACKGROUND_USER1 + sample)
+		&& (get_view_gauge_pid(2, 2) == 0x100u + sample)
+		&& (strcmp(message, expected) == 0)
+		&& (get_alert_threshold(4) == 10.5f + sample)
+		&& (get_dynamic_view_index(2) == sample)
+		&& (get_general_splash(0) == 10 + sample);
+}
+
+uint8_t test_sample_matches(void)
+{
+	for (uint8_t sample = 1; sample <= 2; sample++)
+		if (sample_is(sample))
+			return sample;
+
+	return 0;
+}
+
+static void (*power_fail_setup)(void);
+static void (*power_fail_update)(void);
+static uint32_t power_fail_cut;
+static bool power_fail_torn;
+
+static void power_fail_round(void)
+{
+	power_fail_setup();
+	test_device_cut(power_fail_cut, power_fail_torn);
+	power_fail_update();
+}
+
+uint32_t test_power_fail(void (*setup)(void), void (*update)(void), void (*check)(void), bool torn)
+{
+	power_fail_setup = setup;
+	power_fail_update = update;
+	power_fail_torn = torn;
+
+	for (power_fail_cut = 0;; power_fail_cut++)
+	{
+		test_device_erase();
+
+		int status = test_fork(power_fail_round);
+		CHECK((status == 0) || (status == TEST_CUT_STATUS));
+
+		if (test_fork(check) != 0)
+		{
+			fprintf(stderr, "check failed after a cut at write %u%s\n", (unsigned)power_fail_cut, torn ? " (torn)" : "");
+			exit(1);
+		}
+
+		if (status == 0)
+			return power_fail_cut;
+	}
+}
+
+int test_main(const test_case *cases, uint32_t count)
+{
+	uint32_t failed = 0;
+
+	test_device = mmap(NULL, TEST_DEVICE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	CHECK(test_device != MAP_FAILED);
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		test_device_erase();
+
+		int status = test_fork(cases[i].run);
+
+		printf("%s %s\n", (status == 0) ? "PASS" : "FAIL", cases[i].name);
+		if (status != 0)
+			failed++;
+	}
+
+	printf("%u of %u passed\n", (unsigned)(count - failed), (unsigned)count);
+
+	munmap(test_device, TEST_DEVICE_SIZE);
+
+	return failed ? 1 : 0;
+}
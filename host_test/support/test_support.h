@@ -0,0 +1,104 @@
+/**
+ ******************************************************************************
+ *
+ * Copyright (c) 2025 KaiserEngineering, LLC
+ * Author Matthew Kaiser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************
+ */
+
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ke_config.h"
+
+// Every test case runs in its own process, so it starts from the library's
+// boot state and a blank device. The device is shared with the processes a
+// case forks, which is how a power cut is replayed: the writer dies part way
+// through and a fresh process boots from whatever reached the device.
+#define TEST_DEVICE_SIZE 0x4000
+#define TEST_PAGE_SIZE 32
+
+// Exit status of a process whose power was cut
+#define TEST_CUT_STATUS 86
+
+#define CHECK(cond)                                                                     \
+	do                                                                                  \
+	{                                                                                   \
+		if (!(cond))                                                                    \
+		{                                                                               \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);   \
+			exit(1);                                                                    \
+		}                                                                               \
+	} while (0)
+
+typedef struct
+{
+	const char *name;
+	void (*run)(void);
+} test_case;
+
+#define TEST_CASE(fn) {#fn, fn}
+
+// Runs each case in a child process and reports the results, returns the exit
+// status for main()
+int test_main(const test_case *cases, uint32_t count);
+
+// RAM EEPROM with 32 byte pages and byte write granularity
+extern uint8_t *test_device;
+extern const SETTINGS_BACKEND test_backend;
+
+void test_device_erase(void);
+uint32_t test_device_writes(void);
+uint32_t test_device_reads(void);
+void test_device_reset_counts(void);
+
+// Cut the power once writes more device writes have landed. The next write
+// is dropped, or with torn only its first half lands, and the process exits
+// with TEST_CUT_STATUS.
+void test_device_cut(uint32_t writes, bool torn);
+
+// Runs fn in a child process and returns its exit status. The child must not
+// inherit an async worker, so fork before selecting async write mode.
+int test_fork(void (*fn)(void));
+
+// set_alert_message() takes a whole ALERT_MESSAGE_LEN buffer, this pads text
+// with zeros so the stored bytes are the same on every run
+bool test_set_message(uint8_t idx, const char *text, bool save);
+
+// Writes one of two sets of values spread over every section and page range
+// of the memory map, and checks which set, if either, the settings hold.
+// test_sample_matches() returns 0 for neither, 1 or 2 for a whole set.
+void test_set_sample(uint8_t sample, bool save);
+uint8_t test_sample_matches(void);
+
+// Replays a power cut after every device write of update. Each round erases
+// the device, runs setup and then update in a child with the cut armed, then
+// boots check in a fresh child. Rounds continue until update completes
+// uncut, returns the number of cuts replayed.
+uint32_t test_power_fail(void (*setup)(void), void (*update)(void), void (*check)(void), bool torn);
+
+#endif /* TEST_SUPPORT_H */
@@ -0,0 +1,469 @@
+/**
+ ******************************************************************************
+ *
+ * Copyright (c) 2025 KaiserEngineering, LLC
+ * Author Matthew Kaiser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************
+ */
+
+#include "test_support.h"
+
+typedef struct
+{
+	char log[2048];
+	uint32_t len;
+} event_log;
+
+static bool log_event(void *context, JSON_EVENT event, const char *text, uint32_t len)
+{
+	static const char codes[] = "{}[]ksnTFN";
+	event_log *log = context;
+
+	log->len += snprintf(&log->log[log->len], sizeof(log->log) - log->len, "%c%s%.*s ",
+		codes[event], text ? ":" : "", text ? (int)len : 0, text ? text : "");
+	return log->len < sizeof(log->log);
+}
+
+// Feeds the document in pieces of step bytes, returns the reader result
+static bool read_document(const char *json, uint32_t step, event_log *log)
+{
+	json_reader reader;
+	uint32_t len = strlen(json);
+
+	memset(log, 0, sizeof(*log));
+	json_reader_init(&reader, log_event, log);
+
+	for (uint32_t offset = 0; offset < len; offset += step)
+		if (!json_reader_feed(&reader, &json[offset], (len - offset < step) ? len - offset : step))
+			return false;
+
+	return json_reader_finish(&reader);
+}
+
+static void reader_events_do_not_depend_on_chunking(void)
+{
+	const char *json = "{\"a\":[1,-2.5e3,true,false,null],\"b\\u00e9\":\"x\\n\\\"y\\\"\",\"c\":{}}";
+	event_log whole;
+	event_log piece;
+
+	CHECK(read_document(json, 1000, &whole));
+	CHECK(strcmp(whole.log, "{ k:a [ n:1 n:-2.5e3 T F N ] k:b\xc3\xa9 s:x\n\"y\" k:c { } } ") == 0);
+
+	for (uint32_t step = 1; step < 8; step++)
+	{
+		CHECK(read_document(json, step, &piece));
+		CHECK(strcmp(whole.log, piece.log) == 0);
+	}
+}
+
+static void reader_rejects_malformed_input(void)
+{
+	static const char *bad[] = {
+		"{\"a\":}",
+		"{\"a\":1,}",
+		"[1 2]",
+		"{\"a\":1}}",
+		"{\"a\":1} x",
+		"\"unterminated",
+		"{\"a\":tru}",
+		"{\"a\":\"\\x\"}",
+		"{\"a\":1",
+		""
+	};
+	event_log log;
+
+	for (uint32_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++)
+		CHECK(!read_document(bad[i], 3, &log));
+
+	CHECK(read_document("{\"a\":1} ", 3, &log));
+}
+
+static void reader_truncates_long_strings(void)
+{
+	char json[512];
+	char expected[JSON_READER_TOKEN_SIZE];
+	event_log log;
+
+	// Two byte characters, the cut must not split one
+	strcpy(json, "[\"");
+	for (uint32_t i = 0; i < 100; i++)
+		strcat(json, "\xc3\xa9");
+	strcat(json, "\",\"\\u00e9");
+	for (uint32_t i = 0; i < 200; i++)
+		strcat(json, "a");
+	strcat(json, "\"]");
+
+	CHECK(read_document(json, 7, &log));
+
+	expected[0] = '\0';
+	for (uint32_t i = 0; i < (JSON_READER_TOKEN_SIZE - 1) / 2; i++)
+		strcat(expected, "\xc3\xa9");
+
+	char *first = strstr(log.log, "s:") + 2;
+	CHECK(strncmp(first, expected, strlen(expected)) == 0);
+	CHECK(first[strlen(expected)] == ' ');
+
+	char *second = strstr(first, "s:") + 2;
+	CHECK(strncmp(second, "\xc3\xa9" "aaaa", 6) == 0);
+	CHECK(strchr(second, ' ') - second == JSON_READER_TOKEN_SIZE - 1);
+
+	// Numbers are never cut
+	memset(json, '1', 200);
+	json[200] = '\0';
+	CHECK(!read_document(json, 7, &log));
+}
+
+static void writer_formats_like_cjson(void)
+{
+	char buffer[128];
+	json_writer writer;
+
+	json_writer_init(&writer, buffer, sizeof(buffer));
+	json_begin_object(&writer, NULL);
+	json_add_number(&writer, "int", 42);
+	json_add_number(&writer, "neg", -7);
+	json_add_number(&writer, "frac", 0.1);
+	json_add_number(&writer, "big", 1e300);
+	json_begin_array(&writer, "list");
+	json_add_string(&writer, NULL, "q\"\\\n\x01");
+	json_begin_object(&writer, NULL);
+	json_end_object(&writer);
+	json_end_array(&writer);
+	json_add_string_n(&writer, "cut", "abcdef", 3);
+	json_end_object(&writer);
+
+	const char *expected = "{\"int\":42,\"neg\":-7,\"frac\":0.1,\"big\":1e+300,\"list\":[\"q\\\"\\\\\\n\\u0001\",{}],\"cut\":\"abc\"}";
+	CHECK(json_writer_finish(&writer) == strlen(expected));
+	CHECK(strcmp(buffer, expected) == 0);
+
+	// Too small a buffer still reports the length it needed
+	json_writer_init(&writer, buffer, 8);
+	json_begin_array(&writer, NULL);
+	json_add_string(&writer, NULL, "0123456789");
+	json_end_array(&writer);
+	CHECK(json_writer_finish(&writer) == 0);
+	CHECK(writer.length == 14);
+}
+
+static void count_sink(void *context, const char *data, uint32_t len)
+{
+	(void)data;
+	*(uint32_t *)context += len;
+}
+
+static void boot(void)
+{
+	CHECK(settings_set_backend(&test_backend));
+	load_settings();
+}
+
+static void config_to_json_reports_short_buffers(void)
+{
+	static char whole[4096];
+	uint32_t counted = 0;
+
+	boot();
+	test_set_sample(2, true);
+
+	uint32_t expected = config_to_json(whole, sizeof(whole));
+	CHECK(expected > 0);
+	CHECK(expected == strlen(whole));
+	CHECK(config_to_json(whole, expected) == 0);
+	CHECK(config_to_json(whole, expected + 1) == expected);
+	CHECK(config_to_json_sink(count_sink, &counted) == expected);
+	CHECK(counted == expected);
+}
+
+static void config_export_lengths_agree(void)
+{
+	static char whole[4096];
+	static char pieces[4096];
+	settings_json_cursor cursor;
+	uint32_t len;
+	uint32_t piece;
+
+	boot();
+	test_set_sample(2, true);
+
+	uint32_t expected = config_to_json(whole, sizeof(whole));
+	CHECK(config_json_length() == expected);
+
+	// Pieces end inside entries, on their edges and past the whole document
+	static const uint32_t sizes[] = {1, 7, 20, 4096};
+	for (uint8_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+	{
+		memset(&cursor, 0, sizeof(cursor));
+		len = 0;
+		while ((piece = config_to_json_next(&cursor, &pieces[len], sizes[i])) > 0)
+		{
+			CHECK(piece <= sizes[i]);
+			len += piece;
+		}
+		CHECK(!cursor.changed);
+		CHECK(len == expected);
+		CHECK(memcmp(whole, pieces, len) == 0);
+	}
+}
+
+static void config_export_restarts_after_a_change(void)
+{
+	static char whole[4096];
+	static char pieces[4096];
+	settings_json_cursor cursor = {0};
+	uint32_t len;
+
+	boot();
+	test_set_sample(1, true);
+
+	// Setting a value it already has does not tear anything
+	len = config_to_json_next(&cursor, pieces, 20);
+	CHECK(len == 20);
+	test_set_sample(1, false);
+	CHECK(config_to_json_next(&cursor, &pieces[len], 20) == 20);
+
+	test_set_sample(2, false);
+	CHECK(config_to_json_next(&cursor, &pieces[len], 20) == 0);
+	CHECK(cursor.changed);
+	CHECK(config_to_json_next(&cursor, &pieces[len], 20) == 0);
+
+	uint32_t expected = config_to_json(whole, sizeof(whole));
+	uint32_t piece;
+
+	memset(&cursor, 0, sizeof(cursor));
+	len = 0;
+	while ((piece = config_to_json_next(&cursor, &pieces[len], 20)) > 0)
+		len += piece;
+	CHECK(!cursor.changed);
+	CHECK(len == expected);
+	CHECK(memcmp(whole, pieces, len) == 0);
+}
+
+static void options_export_is_the_constant(void)
+{
+	static char buffer[4096];
+	static char pieces[4096];
+	settings_json_cursor cursor = {0};
+	uint32_t len = 0;
+	uint32_t piece;
+
+	uint32_t options_len;
+	const char *options = options_json_data(&options_len);
+	CHECK(options_len == strlen(options));
+	CHECK(options_json_length() == options_len);
+	CHECK(options_to_json(buffer, options_len) == 0);
+	CHECK(options_to_json(buffer, sizeof(buffer)) == options_len);
+	CHECK(strcmp(buffer, options) == 0);
+
+	while ((piece = options_to_json_next(&cursor, &pieces[len], 20)) > 0)
+		len += piece;
+	CHECK(len == options_len);
+	CHECK(memcmp(pieces, options, len) == 0);
+}
+
+static void import_restores_an_export(void)
+{
+	static char exported[4096];
+	static char restored[4096];
+
+	boot();
+	test_set_sample(2, true);
+	CHECK(test_set_message(0, "quote \" and \\ backslash", true));
+	CHECK(config_to_json(exported, sizeof(exported)) > 0);
+
+	settings_reset_defaults(SETTINGS_ALL_SECTIONS);
+	CHECK(test_sample_matches() == 0);
+
+	CHECK(json_to_config(exported));
+	CHECK(test_sample_matches() == 2);
+	CHECK(config_to_json(restored, sizeof(restored)) > 0);
+	CHECK(strcmp(exported, restored) == 0);
+
+	// Persisted as well
+	load_settings();
+	CHECK(config_to_json(restored, sizeof(restored)) > 0);
+	CHECK(strcmp(exported, restored) == 0);
+}
+
+static void chunked_import_rolls_back_on_error(void)
+{
+	const char *json = "{\"general\":[{\"splash\":99}],\"alert\":[{\"threshold\":5},{\"message\":\"half\"}";
+
+	boot();
+	test_set_sample(1, true);
+
+	CHECK(settings_json_import_begin());
+	CHECK(!settings_json_import_begin());
+	for (const char *p = json; *p; p++)
+		CHECK(settings_json_import_feed(p, 1));
+	CHECK(get_general_splash(0) == 99);
+	CHECK(!settings_json_import_feed("]]", 2));
+	CHECK(test_sample_matches() == 1);
+
+	// Nothing of the failed import reached the device
+	load_settings();
+	CHECK(test_sample_matches() == 1);
+
+	CHECK(settings_json_import_begin());
+	CHECK(settings_json_import_feed(json, strlen(json)));
+	CHECK(settings_json_import_feed("]}", 2));
+	CHECK(settings_json_import_finish());
+	CHECK(get_general_splash(0) == 99);
+
+	load_settings();
+	CHECK(get_general_splash(0) == 99);
+	CHECK(get_alert_threshold(0) == 5.0f);
+}
+
+static void chunked_import_keeps_other_writers(void)
+{
+	const char *json = "{\"alert\":[{\"threshold\":5}";
+
+	boot();
+	float threshold = get_alert_threshold(0);
+	test_device_reset_counts();
+
+	// Staged privately, a set from elsewhere lands in its own write mode
+	CHECK(settings_json_import_begin());
+	CHECK(settings_json_import_feed(json, strlen(json)));
+	CHECK(settings_get_write_mode() == SETTINGS_WRITE_THROUGH);
+	CHECK(test_device_writes() == 0);
+	CHECK(set_dynamic_threshold(0, 42.0f, true));
+	CHECK(test_device_writes() > 0);
+
+	// and survives the rollback
+	settings_json_import_abort();
+	CHECK(get_alert_threshold(0) == threshold);
+	CHECK(get_dynamic_threshold(0) == 42.0f);
+	load_settings();
+	CHECK(get_alert_threshold(0) == threshold);
+	CHECK(get_dynamic_threshold(0) == 42.0f);
+
+	// and the commit, which lands in write-back mode as well
+	settings_set_write_mode(SETTINGS_WRITE_BACK);
+	CHECK(settings_json_import_begin());
+	CHECK(settings_json_import_feed(json, strlen(json)));
+	CHECK(set_dynamic_threshold(1, 43.0f, true));
+	CHECK(settings_json_import_feed("]}", 2));
+	CHECK(settings_json_import_finish());
+	CHECK(settings_get_write_mode() == SETTINGS_WRITE_BACK);
+
+	load_settings();
+	CHECK(get_alert_threshold(0) == 5.0f);
+	CHECK(get_dynamic_threshold(0) == 42.0f);
+	CHECK(get_dynamic_threshold(1) == 43.0f);
+}
+
+static void import_truncates_long_messages(void)
+{
+	char json[256];
+	char message[ALERT_MESSAGE_LEN];
+
+	boot();
+
+	strcpy(json, "{\"alert\":[{\"message\":\"");
+	for (uint32_t i = 0; i < 100; i++)
+		strcat(json, "m");
+	strcat(json, "\"}]}");
+
+	CHECK(json_to_config(json));
+	get_alert_message(0, message);
+	CHECK(strlen(message) == ALERT_MESSAGE_LEN - 1);
+	CHECK(strspn(message, "m") == ALERT_MESSAGE_LEN - 1);
+}
+
+static void patch_changes_only_named_members(void)
+{
+	char message[ALERT_MESSAGE_LEN];
+
+	boot();
+	test_set_sample(2, true);
+	CHECK(set_view_gauge_theme(1, 2, GAUGE_THEME_RADIAL, true));
+
+	CHECK(json_patch_config("{\"alert\":{\"3\":{\"message\":\"patched\"}},\"view\":{\"1\":{\"gauge\":{\"0\":{\"theme\":\"Linear\"}}}}}"));
+	get_alert_message(3, message);
+	CHECK(strcmp(message, "patched") == 0);
+	CHECK(test_sample_matches() == 2);
+	CHECK(get_view_gauge_theme(1, 2) == GAUGE_THEME_RADIAL);
+
+	// null resets a member, and an array replaces the list it names
+	CHECK(json_patch_config("{\"general\":[{\"splash\":null}]}"));
+	CHECK(get_general_splash(0) == 5);
+	CHECK(json_patch_config("{\"view\":{\"1\":{\"gauge\":[{\"pid\":\"PID77\"}]}}}"));
+	CHECK(get_view_gauge_pid(1, 0) == 77);
+	CHECK(get_view_gauge_theme(1, 2) == GAUGE_THEME_STOCK_ST);
+	CHECK(get_view_gauge_pid(2, 2) == 0x102);
+
+	CHECK(json_set_config_path("alert[4].threshold", "-12.5"));
+	CHECK(get_alert_threshold(4) == -12.5f);
+	CHECK(json_set_config_path("view[2].gauge[2].pid", "null"));
+	CHECK(get_view_gauge_pid(2, 2) == 0);
+	CHECK(!json_set_config_path("alert[9].threshold", "1"));
+	CHECK(!json_set_config_path("alert[0].threshold", "\"text\""));
+	CHECK(!json_set_config_path("alert[0].nothing", "1"));
+
+	load_settings();
+	get_alert_message(3, message);
+	CHECK(strcmp(message, "patched") == 0);
+	CHECK(get_alert_threshold(4) == -12.5f);
+}
+
+static void wear_report_names_hot_pages(void)
+{
+	char buffer[1024];
+
+	boot();
+	settings_reset_wear();
+	for (uint16_t i = 1; i <= 50; i++)
+		CHECK(set_general_splash(0, i, true));
+
+	// Splash and its section crc sit apart on the last page of the map, so
+	// each set programs that page twice
+	CHECK(settings_get_page_writes(15) == 100);
+	CHECK(wear_to_json(buffer, sizeof(buffer), 100) > 0);
+	CHECK(strstr(buffer, "{\"total_writes\":100,\"endurance\":1000000,") == buffer);
+	CHECK(strstr(buffer, "\"pages\":[{\"address\":480,\"writes\":100}]") != NULL);
+	CHECK(strstr(buffer, "{\"field\":\"general_splash\",\"writes\":50}") != NULL);
+	CHECK(strstr(buffer, "\"projected_seconds\":") != NULL);
+	CHECK(wear_to_json(buffer, 16, 100) == 0);
+}
+
+static const test_case cases[] = {
+	TEST_CASE(reader_events_do_not_depend_on_chunking),
+	TEST_CASE(reader_rejects_malformed_input),
+	TEST_CASE(reader_truncates_long_strings),
+	TEST_CASE(writer_formats_like_cjson),
+	TEST_CASE(config_to_json_reports_short_buffers),
+	TEST_CASE(config_export_lengths_agree),
+	TEST_CASE(config_export_restarts_after_a_change),
+	TEST_CASE(options_export_is_the_constant),
+	TEST_CASE(import_restores_an_export),
+	TEST_CASE(chunked_import_rolls_back_on_error),
+	TEST_CASE(chunked_import_keeps_other_writers),
+	TEST_CASE(import_truncates_long_messages),
+	TEST_CASE(patch_changes_only_named_members),
+	TEST_CASE(wear_report_names_hot_pages)
+};
+
+int main(void)
+{
+	return test_main(cases, sizeof(cases) / sizeof(cases[0]));
+}
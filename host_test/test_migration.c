@@ -0,0 +1,234 @@
+/**
+ ******************************************************************************
+ *
+ * Copyright (c) 2025 KaiserEngineering, LLC
+ * Author Matthew Kaiser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************
+ */
+
+#include "test_support.h"
+
+// Memory map addresses from ke_config.c
+#define ALERT_MESSAGE2_BYTE1 0x00AC
+#define ALERT_MESSAGE_SIZE 64
+#define GENERAL_EE_VERSION_BYTE1 0x01EC
+#define SECTION_CRC_BYTE1 0x01F0
+#define SECTION_CRC_SIZE 8
+#define LAYOUT_VERSION_BYTE1 0x01F8
+#define MAP_SIZE 0x0200
+
+#define MESSAGE "Oil pressure low"
+
+static void boot(void)
+{
+	CHECK(settings_set_backend(&test_backend));
+	load_settings();
+}
+
+// Turn the current image into one written before layout 1: alert messages
+// byte-reversed, EE_Version 255, no section crcs and no layout byte
+static void write_baseline_image(void)
+{
+	boot();
+	test_set_sample(2, true);
+	CHECK(test_set_message(1, MESSAGE, true));
+
+	uint8_t *message = &test_device[ALERT_MESSAGE2_BYTE1];
+	for (uint8_t n = 0; n < ALERT_MESSAGE_SIZE / 2; n++)
+	{
+		uint8_t byte = message[n];
+		message[n] = message[ALERT_MESSAGE_SIZE - 1 - n];
+		message[ALERT_MESSAGE_SIZE - 1 - n] = byte;
+	}
+
+	test_device[GENERAL_EE_VERSION_BYTE1] = 0xFF;
+	memset(&test_device[SECTION_CRC_BYTE1], 0xFF, SECTION_CRC_SIZE);
+	test_device[LAYOUT_VERSION_BYTE1] = 0xFF;
+}
+
+static void check_migrated(void)
+{
+	char message[ALERT_MESSAGE_LEN];
+
+	get_alert_message(1, message);
+	CHECK(strcmp(message, MESSAGE) == 0);
+	CHECK(get_view_gauge_pid(2, 2) == 0x102);
+	CHECK(get_general_ee_version(0) == 1);
+	CHECK(settings_get_section_faults() == 0);
+	CHECK(settings_get_field_faults() == 0);
+	CHECK(test_device[LAYOUT_VERSION_BYTE1] == 1);
+	CHECK(test_device[GENERAL_EE_VERSION_BYTE1] == 1);
+}
+
+static void boot_migrated(void)
+{
+	test_device_reset_counts();
+	boot();
+	check_migrated();
+	CHECK(test_device_writes() == 0);
+}
+
+static void boot_migrating(void)
+{
+	test_device_reset_counts();
+	boot();
+	check_migrated();
+	CHECK(test_device_writes() > 0);
+}
+
+static void baseline_image_migrates(void)
+{
+	write_baseline_image();
+	CHECK(test_fork(boot_migrating) == 0);
+
+	// A second boot finds layout 1 and leaves the image alone
+	CHECK(test_fork(boot_migrated) == 0);
+}
+
+// Bytes the baseline firmware never wrote, left over on a part that was not erased
+static void write_baseline_leftovers(void)
+{
+	write_baseline_image();
+	for (uint8_t n = 0; n < SECTION_CRC_SIZE; n++)
+		test_device[SECTION_CRC_BYTE1 + n] = 0x5A + n;
+	test_device[LAYOUT_VERSION_BYTE1] = 1;
+}
+
+static void baseline_leftovers_are_ignored(void)
+{
+	write_baseline_leftovers();
+	CHECK(test_fork(boot_migrating) == 0);
+	CHECK(test_fork(boot_migrated) == 0);
+
+	// A leftover layout byte of 255 with leftover crcs
+	write_baseline_leftovers();
+	test_device[LAYOUT_VERSION_BYTE1] = 0xFF;
+	CHECK(test_fork(boot_migrating) == 0);
+}
+
+static void boot_lazy(void)
+{
+	CHECK(settings_set_backend(&test_backend));
+	settings_set_lazy_load(true);
+	load_settings();
+}
+
+static void boot_lazy_migrating(void)
+{
+	test_device_reset_counts();
+	boot_lazy();
+	check_migrated();
+	CHECK(test_device_writes() > 0);
+}
+
+static void boot_lazy_migrated(void)
+{
+	test_device_reset_counts();
+	boot_lazy();
+	check_migrated();
+	CHECK(test_device_writes() == 0);
+}
+
+static void baseline_image_migrates_lazily(void)
+{
+	write_baseline_image();
+	CHECK(test_fork(boot_lazy_migrating) == 0);
+
+	CHECK(test_fork(boot_lazy_migrated) == 0);
+	CHECK(test_fork(boot_migrated) == 0);
+}
+
+static void baseline_leftovers_are_ignored_lazily(void)
+{
+	write_baseline_leftovers();
+	CHECK(test_fork(boot_lazy_migrating) == 0);
+	CHECK(test_fork(boot_lazy_migrated) == 0);
+}
+
+static void current_image_is_not_migrated(void)
+{
+	uint8_t before[MAP_SIZE];
+
+	boot();
+	test_set_sample(2, true);
+	CHECK(test_set_message(1, MESSAGE, true));
+	memcpy(before, test_device, MAP_SIZE);
+
+	test_device_reset_counts();
+	load_settings();
+	CHECK(test_device_writes() == 0);
+	CHECK(memcmp(before, test_device, MAP_SIZE) == 0);
+	check_migrated();
+}
+
+static void ee_version_is_not_writable(void)
+{
+	boot();
+	CHECK(test_set_message(1, MESSAGE, true));
+
+	CHECK(!set_general_ee_version(0, 0xFF, true));
+	CHECK(!set_general_ee_version(0, 2, true));
+	CHECK(json_to_config("{\"general\":[{\"EE_Version\":255,\"splash\":42}]}"));
+	CHECK(get_general_splash(0) == 42);
+	CHECK(json_set_config_path("general[0].EE_Version", "255") == false);
+	CHECK(get_general_ee_version(0) == 1);
+
+	// An old version number in EE_Version alone does not trigger a migration,
+	// the crcs of the other sections still match
+	test_device[GENERAL_EE_VERSION_BYTE1] = 0xFF;
+	load_settings();
+
+	char message[ALERT_MESSAGE_LEN];
+	get_alert_message(1, message);
+	CHECK(strcmp(message, MESSAGE) == 0);
+	CHECK(get_general_ee_version(0) == 1);
+	CHECK(settings_get_section_faults() == (1 << SETTINGS_SECTION_GENERAL));
+	CHECK(test_device[LAYOUT_VERSION_BYTE1] == 1);
+}
+
+static void unknown_layout_is_left_alone(void)
+{
+	uint8_t before[MAP_SIZE];
+
+	boot();
+	test_set_sample(2, true);
+	test_device[LAYOUT_VERSION_BYTE1] = 7;
+	memcpy(before, test_device, MAP_SIZE);
+
+	load_settings();
+	CHECK(memcmp(before, test_device, MAP_SIZE) == 0);
+}
+
+static const test_case cases[] = {
+	TEST_CASE(baseline_image_migrates),
+	TEST_CASE(baseline_image_migrates_lazily),
+	TEST_CASE(baseline_leftovers_are_ignored),
+	TEST_CASE(baseline_leftovers_are_ignored_lazily),
+	TEST_CASE(current_image_is_not_migrated),
+	TEST_CASE(ee_version_is_not_writable),
+	TEST_CASE(unknown_layout_is_left_alone)
+};
+
+int main(void)
+{
+	return test_main(cases, sizeof(cases) / sizeof(cases[0]));
+}
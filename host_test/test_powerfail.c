@@ -0,0 +1,242 @@
+/**
+ ******************************************************************************
+ *
+ * Copyright (c) 2025 KaiserEngineering, LLC
+ * Author Matthew Kaiser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************
+ */
+
+#include "test_support.h"
+
+#define AB_SLOT_A 0x0800
+#define AB_SLOT_B 0x0C00
+#define JOURNAL_BASE 0x0800
+#define JOURNAL_SIZE 0x1000
+#define INTENT_BASE 0x0800
+#define INTENT_SIZE 544
+
+// Each storage engine gets sample 1 committed, then has the commit of sample 2
+// cut after every device write. Whatever boots next must hold one whole
+// sample, never a mix of the two.
+
+static void boot_ab(void)
+{
+	CHECK(settings_set_backend(&test_backend));
+	CHECK(settings_set_ab_storage(AB_SLOT_A, AB_SLOT_B));
+	settings_set_write_mode(SETTINGS_WRITE_BACK);
+	load_settings();
+}
+
+static void setup_ab(void)
+{
+	boot_ab();
+	test_set_sample(1, true);
+	settings_commit();
+	test_set_sample(2, true);
+	settings_commit();
+	test_set_sample(1, true);
+	settings_commit();
+}
+
+static void update_ab(void)
+{
+	test_set_sample(2, true);
+	settings_commit();
+}
+
+static void check_ab(void)
+{
+	boot_ab();
+	CHECK(test_sample_matches() != 0);
+}
+
+static void ab_commit_is_atomic(void)
+{
+	CHECK(test_power_fail(setup_ab, update_ab, check_ab, false) > 0);
+	CHECK(test_power_fail(setup_ab, update_ab, check_ab, true) > 0);
+}
+
+static void boot_journal(void)
+{
+	CHECK(settings_set_backend(&test_backend));
+	CHECK(settings_set_journal_storage(JOURNAL_BASE, JOURNAL_SIZE));
+	settings_set_write_mode(SETTINGS_WRITE_BACK);
+	load_settings();
+}
+
+// Updates logged before the cut one, varied so that the commit meets a full
+// log and has to run a compaction pass first at every possible point
+static uint16_t journal_fill;
+
+static void setup_journal(void)
+{
+	boot_journal();
+	test_set_sample(1, true);
+	settings_commit();
+
+	for (uint16_t i = 1; i <= journal_fill; i++)
+	{
+		CHECK(set_alert_threshold(0, i, true));
+		settings_commit();
+	}
+}
+
+static void update_journal(void)
+{
+	test_set_sample(2, true);
+	settings_commit();
+}
+
+static void check_journal(void)
+{
+	boot_journal();
+	CHECK(test_sample_matches() != 0);
+	CHECK(get_alert_threshold(0) == journal_fill);
+	CHECK(settings_get_section_faults() == 0);
+}
+
+static void journal_commit_is_atomic(void)
+{
+	for (journal_fill = 150; journal_fill < 160; journal_fill += 5)
+	{
+		CHECK(test_power_fail(setup_journal, update_journal, check_journal, false) > 0);
+		CHECK(test_power_fail(setup_journal, update_journal, check_journal, true) > 0);
+	}
+}
+
+// Write-back sets left uncommitted while compaction runs must not reach the
+// device, a cut after any checkpoint write boots the last commit
+static void setup_journal_compact(void)
+{
+	setup_journal();
+	test_set_sample(2, true);
+}
+
+static void update_journal_compact(void)
+{
+	while (settings_journal_compact())
+		;
+	for (uint16_t i = 0; i < 300; i++)
+		settings_journal_compact();
+}
+
+static void check_journal_compact(void)
+{
+	boot_journal();
+	CHECK(test_sample_matches() == 1);
+	CHECK(get_alert_threshold(0) == journal_fill);
+}
+
+static void journal_compaction_keeps_uncommitted_sets_out(void)
+{
+	uint32_t cuts = 0;
+
+	// Only some fills leave the log with enough superseded records to compact
+	for (journal_fill = 0; journal_fill < 160; journal_fill += 5)
+	{
+		cuts += test_power_fail(setup_journal_compact, update_journal_compact, check_journal_compact, false);
+		cuts += test_power_fail(setup_journal_compact, update_journal_compact, check_journal_compact, true);
+	}
+
+	CHECK(cuts > 0);
+}
+
+static void boot_intent(void)
+{
+	CHECK(settings_set_backend(&test_backend));
+	CHECK(settings_set_intent_log(INTENT_BASE, INTENT_SIZE));
+	settings_set_write_mode(SETTINGS_WRITE_BACK);
+	load_settings();
+}
+
+static void setup_intent(void)
+{
+	boot_intent();
+	test_set_sample(1, true);
+	settings_commit();
+}
+
+static void update_intent(void)
+{
+	test_set_sample(2, true);
+	settings_commit();
+}
+
+static void check_intent(void)
+{
+	boot_intent();
+	CHECK(test_sample_matches() != 0);
+	CHECK(settings_get_section_faults() == 0);
+}
+
+static void intent_log_commit_is_atomic(void)
+{
+	CHECK(test_power_fail(setup_intent, update_intent, check_intent, false) > 0);
+	CHECK(test_power_fail(setup_intent, update_intent, check_intent, true) > 0);
+}
+
+static void boot_intent_through(void)
+{
+	CHECK(settings_set_backend(&test_backend));
+	CHECK(settings_set_intent_log(INTENT_BASE, INTENT_SIZE));
+	load_settings();
+}
+
+static void setup_intent_message(void)
+{
+	boot_intent_through();
+	CHECK(test_set_message(1, "old message that spans a page", true));
+}
+
+static void update_intent_message(void)
+{
+	CHECK(test_set_message(1, "a new message crossing pages", true));
+}
+
+static void check_intent_message(void)
+{
+	char message[ALERT_MESSAGE_LEN];
+
+	boot_intent_through();
+	get_alert_message(1, message);
+	CHECK((strcmp(message, "old message that spans a page") == 0) || (strcmp(message, "a new message crossing pages") == 0));
+	CHECK(settings_get_section_faults() == 0);
+}
+
+static void intent_log_set_is_atomic(void)
+{
+	CHECK(test_power_fail(setup_intent_message, update_intent_message, check_intent_message, false) > 0);
+	CHECK(test_power_fail(setup_intent_message, update_intent_message, check_intent_message, true) > 0);
+}
+
+static const test_case cases[] = {
+	TEST_CASE(journal_commit_is_atomic),
+	TEST_CASE(journal_compaction_keeps_uncommitted_sets_out),
+	TEST_CASE(ab_commit_is_atomic),
+	TEST_CASE(intent_log_commit_is_atomic),
+	TEST_CASE(intent_log_set_is_atomic)
+};
+
+int main(void)
+{
+	return test_main(cases, sizeof(cases) / sizeof(cases[0]));
+}
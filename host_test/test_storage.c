@@ -0,0 +1,574 @@
+/**
+ ******************************************************************************
+ *
+ * Copyright (c) 2025 KaiserEngineering, LLC
+ * Author Matthew Kaiser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include "test_support.h"
+#include "ke_config_mmap.h"
+
+#define JOURNAL_BASE 0x0800
+#define JOURNAL_SIZE 0x1000
+#define AB_SLOT_A 0x0800
+#define AB_SLOT_B 0x0C00
+#define PACKED_BASE 0x0800
+
+// A byte inside the alert section of the memory map
+#define ALERT_SECTION_BYTE 0x0100
+
+static void boot_direct(void)
+{
+	CHECK(settings_set_backend(&test_backend));
+	load_settings();
+}
+
+static void check_sample_2(void)
+{
+	boot_direct();
+	CHECK(test_sample_matches() == 2);
+}
+
+static void write_through_persists(void)
+{
+	boot_direct();
+	CHECK(settings_get_section_faults() == 0);
+
+	test_set_sample(2, true);
+	CHECK(test_fork(check_sample_2) == 0);
+}
+
+static void unsaved_set_stays_in_ram(void)
+{
+	boot_direct();
+	test_device_reset_counts();
+
+	test_set_sample(2, false);
+	CHECK(test_sample_matches() == 2);
+	CHECK(test_device_writes() == 0);
+
+	load_settings();
+	CHECK(test_sample_matches() == 0);
+}
+
+static void write_back_waits_for_commit(void)
+{
+	uint8_t before[0x200];
+
+	boot_direct();
+	settings_set_write_mode(SETTINGS_WRITE_BACK);
+	memcpy(before, test_device, sizeof(before));
+
+	test_set_sample(2, true);
+	CHECK(memcmp(before, test_device, sizeof(before)) == 0);
+
+	// One write per changed page
+	test_device_reset_counts();
+	settings_commit();
+
+	uint32_t pages = 0;
+	for (uint16_t bAdd = 0; bAdd < sizeof(before); bAdd += TEST_PAGE_SIZE)
+		if (memcmp(&before[bAdd], &test_device[bAdd], TEST_PAGE_SIZE) != 0)
+			pages++;
+	CHECK(test_device_writes() == pages);
+	CHECK(test_fork(check_sample_2) == 0);
+}
+
+static void async_flush_lands(void)
+{
+	boot_direct();
+	settings_set_write_mode(SETTINGS_WRITE_ASYNC);
+
+	test_set_sample(2, true);
+	settings_flush();
+
+	settings_set_write_mode(SETTINGS_WRITE_THROUGH);
+	load_settings();
+	CHECK(test_sample_matches() == 2);
+}
+
+static void check_defaults(void)
+{
+	boot_direct();
+	CHECK(test_sample_matches() == 0);
+	CHECK(settings_get_section_faults() == 0);
+}
+
+static void reset_defaults_keeps_the_write_mode(void)
+{
+	boot_direct();
+	test_set_sample(2, true);
+
+	// Staged in write-back mode until the commit
+	settings_set_write_mode(SETTINGS_WRITE_BACK);
+	test_device_reset_counts();
+	settings_reset_defaults(SETTINGS_ALL_SECTIONS);
+	CHECK(settings_get_write_mode() == SETTINGS_WRITE_BACK);
+	CHECK(test_sample_matches() == 0);
+	CHECK(test_device_writes() == 0);
+	settings_commit();
+	CHECK(test_fork(check_defaults) == 0);
+
+	// Committed by the reset itself in write-through mode
+	settings_set_write_mode(SETTINGS_WRITE_THROUGH);
+	test_set_sample(2, true);
+	settings_reset_defaults(SETTINGS_ALL_SECTIONS);
+	CHECK(settings_get_write_mode() == SETTINGS_WRITE_THROUGH);
+	CHECK(test_fork(check_defaults) == 0);
+
+	// Handed to the worker in async mode
+	test_set_sample(2, true);
+	settings_set_write_mode(SETTINGS_WRITE_ASYNC);
+	settings_reset_defaults(SETTINGS_ALL_SECTIONS);
+	CHECK(settings_get_write_mode() == SETTINGS_WRITE_ASYNC);
+	settings_flush();
+
+	settings_set_write_mode(SETTINGS_WRITE_THROUGH);
+	load_settings();
+	CHECK(test_sample_matches() == 0);
+}
+
+static void boot_journal(void)
+{
+	CHECK(settings_set_backend(&test_backend));
+	CHECK(settings_set_journal_storage(JOURNAL_BASE, JOURNAL_SIZE));
+	load_settings();
+}
+
+static void check_journal_sample_2(void)
+{
+	boot_journal();
+	CHECK(test_sample_matches() == 2);
+	CHECK(get_alert_threshold(0) == 999.0f);
+}
+
+static void journal_survives_wrapping(void)
+{
+	boot_journal();
+	test_set_sample(1, true);
+
+	// Enough updates to go round the log several times
+	for (uint16_t i = 0; i < 1000; i++)
+	{
+		CHECK(set_alert_threshold(0, i, true));
+		while (settings_journal_compact())
+			;
+	}
+	test_set_sample(2, true);
+
+	CHECK(test_fork(check_journal_sample_2) == 0);
+
+	// Nothing outside the log is touched
+	for (uint16_t bAdd = 0; bAdd < JOURNAL_BASE; bAdd++)
+		CHECK(test_device[bAdd] == 0xFF);
+}
+
+static void journal_rejects_small_log(void)
+{
+	CHECK(settings_set_backend(&test_backend));
+	CHECK(!settings_set_journal_storage(JOURNAL_BASE, JOURNAL_SIZE - 16));
+	CHECK(!settings_set_journal_storage(JOURNAL_BASE + 1, JOURNAL_SIZE));
+	CHECK(settings_get_storage() == SETTINGS_STORAGE_DIRECT);
+}
+
+static void check_journal_switch(void)
+{
+	boot_journal();
+	CHECK(test_sample_matches() == 2);
+	CHECK(get_alert_threshold(0) == 7.0f);
+	CHECK(settings_get_section_faults() == 0);
+}
+
+static void journal_takes_over_loaded_image(void)
+{
+	boot_journal();
+	for (uint8_t i = 0; i < 3; i++)
+		test_set_sample(1, true);
+
+	// Records already in the log are older than the image switched to
+	settings_set_direct_storage();
+	load_settings();
+	test_set_sample(2, true);
+
+	CHECK(settings_set_journal_storage(JOURNAL_BASE, JOURNAL_SIZE));
+	CHECK(set_alert_threshold(0, 7, true));
+	CHECK(test_fork(check_journal_switch) == 0);
+}
+
+static void boot_ab(void)
+{
+	CHECK(settings_set_backend(&test_backend));
+	CHECK(settings_set_ab_storage(AB_SLOT_A, AB_SLOT_B));
+	settings_set_write_mode(SETTINGS_WRITE_BACK);
+	load_settings();
+}
+
+static void check_ab_sample_2(void)
+{
+	boot_ab();
+	CHECK(test_sample_matches() == 2);
+}
+
+static void ab_alternates_slots(void)
+{
+	boot_ab();
+
+	for (uint8_t i = 0; i < 6; i++)
+	{
+		test_set_sample(1 + (i & 1), true);
+		settings_commit();
+	}
+	CHECK(test_fork(check_ab_sample_2) == 0);
+
+	test_set_sample(1, true);
+	settings_commit();
+	test_set_sample(2, true);
+	settings_commit();
+	CHECK(test_fork(check_ab_sample_2) == 0);
+}
+
+static void ab_takes_over_loaded_image(void)
+{
+	boot_ab();
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		test_set_sample(1, true);
+		settings_commit();
+	}
+
+	// The switch publishes at once, after the newest slot
+	settings_set_direct_storage();
+	load_settings();
+	test_set_sample(2, true);
+	settings_commit();
+
+	CHECK(settings_set_ab_storage(AB_SLOT_A, AB_SLOT_B));
+	CHECK(test_fork(check_ab_sample_2) == 0);
+
+	// The other slot never held the image, a set after the switch still
+	// publishes a complete one
+	CHECK(set_alert_threshold(0, 7, true));
+	settings_commit();
+	CHECK(test_fork(check_ab_sample_2) == 0);
+}
+
+static void boot_packed(void)
+{
+	CHECK(settings_set_backend(&test_backend));
+	CHECK(settings_set_packed_storage(PACKED_BASE));
+	load_settings();
+}
+
+static void check_packed_sample_2(void)
+{
+	boot_packed();
+	CHECK(test_sample_matches() == 2);
+	CHECK(settings_get_section_faults() == 0);
+}
+
+static void packed_round_trip(void)
+{
+	boot_packed();
+	test_set_sample(1, true);
+	test_set_sample(2, true);
+
+	CHECK(test_fork(check_packed_sample_2) == 0);
+}
+
+static void packed_takes_over_loaded_image(void)
+{
+	boot_packed();
+	test_set_sample(1, true);
+
+	// The switch writes the whole image at once, over the stale packed one
+	settings_set_direct_storage();
+	load_settings();
+	test_set_sample(2, true);
+
+	CHECK(settings_set_packed_storage(PACKED_BASE));
+	CHECK(test_fork(check_packed_sample_2) == 0);
+
+	CHECK(set_alert_threshold(0, 7, true));
+	CHECK(test_fork(check_packed_sample_2) == 0);
+}
+
+static void lazy_load_reads_on_demand(void)
+{
+	boot_direct();
+	test_set_sample(2, true);
+
+	settings_set_lazy_load(true);
+	test_device_reset_counts();
+	load_settings();
+	CHECK(test_device_reads() <= 1);
+
+	CHECK(get_general_splash(0) == 12);
+	CHECK(test_device_reads() <= 4);
+	CHECK(test_sample_matches() == 2);
+}
+
+static void save_splash_9(void)
+{
+	boot_direct();
+	CHECK(set_general_splash(0, 9, true));
+}
+
+static void check_splash_9(void)
+{
+	boot_direct();
+	CHECK(get_general_splash(0) == 9);
+	CHECK(settings_get_section_faults() == 0);
+}
+
+// The case runs in a fresh process, so nothing has been loaded yet
+static void getter_before_load_keeps_the_image(void)
+{
+	CHECK(test_fork(save_splash_9) == 0);
+	test_device_reset_counts();
+
+	// No backend yet, the default handlers are not set
+	CHECK(get_general_splash(0) == 5);
+
+	CHECK(settings_set_backend(&test_backend));
+	CHECK(get_general_splash(0) == 5);
+	CHECK(test_device_reads() == 0);
+	CHECK(test_device_writes() == 0);
+
+	load_settings();
+	CHECK(get_general_splash(0) == 9);
+	CHECK(settings_get_section_faults() == 0);
+	CHECK(test_fork(check_splash_9) == 0);
+}
+
+static void corrupt_section_resets_to_defaults(void)
+{
+	boot_direct();
+	test_set_sample(2, true);
+
+	test_device[ALERT_SECTION_BYTE] ^= 0x5A;
+	load_settings();
+
+	CHECK(settings_get_section_faults() == (1 << SETTINGS_SECTION_ALERT));
+	CHECK(get_alert_threshold(4) == 0.0f);
+	CHECK(get_general_splash(0) == 12);
+
+	// The repaired section passes on the next boot
+	load_settings();
+	CHECK(settings_get_section_faults() == 0);
+}
+
+static void check_repaired(void)
+{
+	boot_direct();
+	CHECK(settings_get_section_faults() == 0);
+	CHECK(get_alert_threshold(4) == 0.0f);
+	CHECK(get_general_splash(0) == 12);
+}
+
+// The repair is staged under the lock and drained by the worker
+static void corrupt_section_repairs_in_async_mode(void)
+{
+	boot_direct();
+	test_set_sample(2, true);
+	settings_set_write_mode(SETTINGS_WRITE_ASYNC);
+
+	test_device[ALERT_SECTION_BYTE] ^= 0x5A;
+	load_settings();
+	CHECK(settings_get_section_faults() == (1 << SETTINGS_SECTION_ALERT));
+
+	settings_flush();
+	CHECK(test_fork(check_repaired) == 0);
+}
+
+static void save_splash_7(void)
+{
+	boot_direct();
+	CHECK(set_general_splash(0, 7, true));
+}
+
+static void check_shadow_repaired(void)
+{
+	boot_direct();
+	CHECK(settings_get_section_faults() == 0);
+	CHECK(get_alert_threshold(4) == 0.0f);
+	CHECK(get_general_splash(0) == 7);
+}
+
+static void shadow_refresh_updates_ram(void)
+{
+	boot_direct();
+	test_set_sample(2, true);
+	settings_set_shadow_mode(true, 0);
+
+	// Another writer changes a committed page behind the shadow
+	CHECK(test_fork(save_splash_7) == 0);
+	CHECK(get_general_splash(0) == 12);
+	CHECK(settings_verify_shadow() > 0);
+	CHECK(get_general_splash(0) == 7);
+	CHECK(settings_get_section_faults() == 0);
+	CHECK(settings_verify_shadow() == 0);
+
+	// A refreshed page that fails its crc is repaired like at load
+	test_device[ALERT_SECTION_BYTE] ^= 0x5A;
+	CHECK(settings_verify_shadow() > 0);
+	CHECK(settings_get_section_faults() == (1 << SETTINGS_SECTION_ALERT));
+	CHECK(get_alert_threshold(4) == 0.0f);
+	CHECK(settings_verify_shadow() == 0);
+	CHECK(test_fork(check_shadow_repaired) == 0);
+}
+
+static void snapshot_round_trip(void)
+{
+	uint8_t snapshot[1024];
+
+	boot_direct();
+	test_set_sample(2, true);
+
+	uint32_t size = settings_export_snapshot(snapshot, sizeof(snapshot));
+	CHECK(size == settings_snapshot_size());
+	CHECK(settings_export_snapshot(snapshot, size - 1) == 0);
+
+	test_set_sample(1, true);
+	CHECK(settings_import_snapshot(snapshot, size));
+	CHECK(test_sample_matches() == 2);
+
+	snapshot[size / 2] ^= 1;
+	CHECK(!settings_import_snapshot(snapshot, size));
+	CHECK(test_sample_matches() == 2);
+
+	CHECK(test_fork(check_sample_2) == 0);
+}
+
+static void snapshot_import_keeps_the_write_mode(void)
+{
+	uint8_t snapshot[1024];
+	uint8_t imported[0x200];
+
+	boot_direct();
+	test_set_sample(2, true);
+	uint32_t size = settings_export_snapshot(snapshot, sizeof(snapshot));
+
+	// Persisted by the import in write-back mode as well
+	test_set_sample(1, true);
+	settings_set_write_mode(SETTINGS_WRITE_BACK);
+	CHECK(settings_import_snapshot(snapshot, size));
+	CHECK(settings_get_write_mode() == SETTINGS_WRITE_BACK);
+	CHECK(test_fork(check_sample_2) == 0);
+	memcpy(imported, test_device, sizeof(imported));
+
+	// And landed before the import returns in async mode
+	settings_set_write_mode(SETTINGS_WRITE_THROUGH);
+	test_set_sample(1, true);
+	settings_set_write_mode(SETTINGS_WRITE_ASYNC);
+	CHECK(settings_import_snapshot(snapshot, size));
+	CHECK(settings_get_write_mode() == SETTINGS_WRITE_ASYNC);
+	CHECK(memcmp(imported, test_device, sizeof(imported)) == 0);
+}
+
+static char mmap_path[] = "/tmp/ke_config_mmap_XXXXXX";
+
+static void check_mmap_sample_2(void)
+{
+	CHECK(settings_mmap_open(mmap_path, 0x1000, true));
+	load_settings();
+	CHECK(test_sample_matches() == 2);
+	settings_mmap_close();
+}
+
+static void mmap_image_persists(void)
+{
+	int fd = mkstemp(mmap_path);
+	CHECK(fd >= 0);
+	close(fd);
+
+	CHECK(settings_mmap_open(mmap_path, 0x1000, true));
+	CHECK(settings_mmap_image()[0] == 0xFF);
+	load_settings();
+	test_set_sample(2, true);
+	settings_mmap_close();
+	CHECK(settings_mmap_image() == NULL);
+
+	int status = test_fork(check_mmap_sample_2);
+	unlink(mmap_path);
+	CHECK(status == 0);
+}
+
+static void mmap_checks_size_and_reports_errors(void)
+{
+	char path[] = "/tmp/ke_config_mmap_XXXXXX";
+	int fd = mkstemp(path);
+	CHECK(fd >= 0);
+	close(fd);
+
+	// Smaller than the memory map
+	CHECK(!settings_mmap_open(path, 0, true));
+	CHECK(!settings_mmap_open(path, 0x01FF, true));
+
+	CHECK(settings_mmap_open(path, 0x0200, true));
+	load_settings();
+	test_set_sample(2, true);
+	CHECK(!settings_mmap_error());
+
+	// A log past the end of the image is lost, and says so
+	CHECK(settings_set_journal_storage(JOURNAL_BASE, JOURNAL_SIZE));
+	CHECK(settings_mmap_error());
+	settings_mmap_close();
+	CHECK(settings_mmap_error());
+
+	CHECK(settings_mmap_open(path, 0x0200, true));
+	CHECK(!settings_mmap_error());
+	settings_mmap_close();
+
+	unlink(path);
+}
+
+static const test_case cases[] = {
+	TEST_CASE(write_through_persists),
+	TEST_CASE(unsaved_set_stays_in_ram),
+	TEST_CASE(write_back_waits_for_commit),
+	TEST_CASE(async_flush_lands),
+	TEST_CASE(reset_defaults_keeps_the_write_mode),
+	TEST_CASE(journal_survives_wrapping),
+	TEST_CASE(journal_rejects_small_log),
+	TEST_CASE(journal_takes_over_loaded_image),
+	TEST_CASE(ab_alternates_slots),
+	TEST_CASE(ab_takes_over_loaded_image),
+	TEST_CASE(packed_round_trip),
+	TEST_CASE(packed_takes_over_loaded_image),
+	TEST_CASE(lazy_load_reads_on_demand),
+	TEST_CASE(getter_before_load_keeps_the_image),
+	TEST_CASE(corrupt_section_resets_to_defaults),
+	TEST_CASE(corrupt_section_repairs_in_async_mode),
+	TEST_CASE(shadow_refresh_updates_ram),
+	TEST_CASE(snapshot_round_trip),
+	TEST_CASE(snapshot_import_keeps_the_write_mode),
+	TEST_CASE(mmap_image_persists),
+	TEST_CASE(mmap_checks_size_and_reports_errors)
+};
+
+int main(void)
+{
+	return test_main(cases, sizeof(cases) / sizeof(cases[0]));
+}
@@ -36,8 +36,8 @@ extern "C"
 #include <stdbool.h>
 #include <string.h>
 #include <stdlib.h>
-#include "cJSON.h"
 #include "lib_pid.h"
+#include "ke_config_json.h"
 
 typedef void(settings_write)(uint16_t bAdd, uint8_t bData);
 typedef uint8_t(settings_read)(uint16_t bAdd);
@@ -45,6 +45,203 @@ typedef uint8_t(settings_read)(uint16_t bAdd);
 void settings_setWriteHandler(settings_write *writeHandler);
 void settings_setReadHandler(settings_read *readHandler);
 
+// Optional range handlers, used in place of the byte handlers when registered.
+// Write ranges never cross a 32 byte EEPROM page boundary.
+typedef void(settings_write_block)(uint16_t bAdd, const uint8_t *pData, uint16_t len);
+typedef void(settings_read_block)(uint16_t bAdd, uint8_t *pData, uint16_t len);
+
+void settings_setWriteBlockHandler(settings_write_block *writeBlockHandler);
+void settings_setReadBlockHandler(settings_read_block *readBlockHandler);
+
+// Optional sync handler, called after each write-through store and commit so a
+// backend that buffers writes can make them durable.
+typedef void(settings_sync)(void);
+
+void settings_setSyncHandler(settings_sync *syncHandler);
+
+// Storage backend. The handlers above form the built-in backend, a backend
+// set here replaces them. read_range and write_range move one contiguous
+// range, write ranges never cross caps.page_size (0 for no limit) and are
+// whole multiples of caps.write_granularity, which must divide 8. A backend
+// with erase is erase-before-write, every flush erases and rewrites whole
+// pages of caps.page_size and the memory map must own those pages. open,
+// erase and sync are optional. Journal storage needs a backend without erase,
+// A/B storage one without erase and with byte write granularity.
+typedef void(settings_erase)(uint16_t bAdd, uint16_t len);
+
+typedef struct
+{
+    uint16_t page_size;
+    uint16_t write_granularity;
+    uint32_t endurance; // Rated write cycles per page, 0 when unknown
+} SETTINGS_BACKEND_CAPS;
+
+typedef struct
+{
+    bool (*open)(void);
+    settings_read_block *read_range;
+    settings_write_block *write_range;
+    settings_erase *erase;
+    settings_sync *sync;
+    SETTINGS_BACKEND_CAPS caps;
+} SETTINGS_BACKEND;
+
+// Pass NULL to return to the built-in handler backend
+bool settings_set_backend(const SETTINGS_BACKEND *backend);
+const SETTINGS_BACKEND *settings_get_backend(void);
+
+// Write-through programs the EEPROM on every persisted set. Write-back only
+// marks the touched pages dirty, settings_commit() then programs each dirty
+// page with a single page write. Async queues the dirty pages for a worker
+// thread and returns as soon as the cache is updated, settings_flush() waits
+// until every queued page has been written.
+typedef enum
+{
+    SETTINGS_WRITE_THROUGH,
+    SETTINGS_WRITE_BACK,
+    SETTINGS_WRITE_ASYNC
+} SETTINGS_WRITE_MODE;
+
+void settings_set_write_mode(SETTINGS_WRITE_MODE mode);
+SETTINGS_WRITE_MODE settings_get_write_mode(void);
+void settings_commit(void);
+void settings_flush(void);
+
+// With a trusted shadow, persisted sets compare against cached_settings instead
+// of reading the EEPROM back. A non-zero verify_interval re-reads one page of
+// the EEPROM every verify_interval persisted writes. settings_verify_shadow()
+// checks every page and returns how many pages differed. A mismatch refreshes
+// the cache and the settings it holds, a section failing its crc is repaired.
+void settings_set_shadow_mode(bool trusted, uint16_t verify_interval);
+uint16_t settings_verify_shadow(void);
+
+// Direct storage keeps every field at its fixed address in the memory map.
+// Journal storage appends each update as records to a circular log in
+// [base_address, base_address + size) and rebuilds the image at load time.
+// The log must hold at least 256 records of 16 bytes (4096 bytes).
+// Call settings_journal_compact() from an idle task, it does one record of
+// compaction work per call and returns true while more work is pending.
+// A/B storage keeps two complete images (544 bytes each, page aligned) and
+// switches between them with a single header write per commit. Use it with
+// write-back mode, a write-through set publishes a whole image.
+// Packed storage keeps one image at base_address (page aligned) with every
+// field at the bit width of its valid range, 461 bytes instead of 512. Each
+// set programs only the packed bytes that changed. It is not covered by the
+// intent log, the section crcs catch a torn update.
+// Select the storage before load_settings(). Journal or A/B storage selected
+// after it takes the loaded image over: the journal writes a full checkpoint
+// after the newest record in the log, A/B publishes it to the slot after the
+// newest valid one. The switch itself is not power-fail safe, a cut before it
+// returns boots what the new storage held before, or for the journal part of
+// the image, which the section crcs catch.
+typedef enum
+{
+    SETTINGS_STORAGE_DIRECT,
+    SETTINGS_STORAGE_JOURNAL,
+    SETTINGS_STORAGE_AB,
+    SETTINGS_STORAGE_PACKED
+} SETTINGS_STORAGE;
+
+bool settings_set_journal_storage(uint16_t base_address, uint16_t size);
+bool settings_set_ab_storage(uint16_t slot_a, uint16_t slot_b);
+bool settings_set_packed_storage(uint16_t base_address);
+void settings_set_direct_storage(void);
+SETTINGS_STORAGE settings_get_storage(void);
+bool settings_journal_compact(void);
+
+// An intent log in [base_address, base_address + size) makes each direct
+// storage update atomic. The new bytes are logged before they are programmed
+// in place and load_settings() finishes an update a power loss interrupted.
+// Each update costs one log write plus two header writes, updates that do not
+// fit the log are programmed without it. The log must lie outside the memory
+// map and hold at least 44 bytes, size 0 disables it. 544 bytes cover a commit
+// of the whole image, such as a layout migration at load time. Set it before
+// load_settings().
+bool settings_set_intent_log(uint16_t base_address, uint16_t size);
+
+// Each section of the memory map carries a crc16 checked once by load_settings().
+// A section that fails its crc is reset to defaults, the failures are reported
+// as a bitmask of (1 << SETTINGS_SECTION). Images from firmware without the
+// crcs are recognised by EE_Version 255 and migrated whatever the crc bytes
+// (0x1F0 to 0x1F7) and the layout byte (0x1F8) hold, unless the host changed
+// EE_Version and the layout byte is not erased as well.
+typedef enum
+{
+    SETTINGS_SECTION_VIEW,
+    SETTINGS_SECTION_ALERT,
+    SETTINGS_SECTION_DYNAMIC,
+    SETTINGS_SECTION_GENERAL,
+    SETTINGS_SECTION_COUNT
+} SETTINGS_SECTION;
+
+uint8_t settings_get_section_faults(void);
+
+// Restore the defaults of every section in a (1 << SETTINGS_SECTION) bitmask.
+// Each section image is built in RAM and only the bytes that differ are
+// programmed, in page bursts. load_settings() resets a blank part the same
+// way unless lazy loading leaves the image unread.
+#define SETTINGS_ALL_SECTIONS ((1 << SETTINGS_SECTION_COUNT) - 1)
+void settings_reset_defaults(uint8_t sections);
+
+// Values are range checked once as they enter RAM, at load time or by a set_*,
+// so getters return them without checking. A loaded value that fails its check
+// is replaced by its default in RAM and reported as a bitmask of
+// (1 << SETTINGS_FIELD), fields are numbered in memory map order.
+typedef enum
+{
+    SETTINGS_FIELD_VIEW_ENABLE,
+    SETTINGS_FIELD_VIEW_NUM_GAUGES,
+    SETTINGS_FIELD_VIEW_BACKGROUND,
+    SETTINGS_FIELD_VIEW_BACKGROUND_COLOR,
+    SETTINGS_FIELD_VIEW_BACKGROUND_TYPE,
+    SETTINGS_FIELD_VIEW_GAUGE_THEME,
+    SETTINGS_FIELD_VIEW_GAUGE_PID,
+    SETTINGS_FIELD_VIEW_GAUGE_UNITS,
+    SETTINGS_FIELD_ALERT_ENABLE,
+    SETTINGS_FIELD_ALERT_PID,
+    SETTINGS_FIELD_ALERT_UNITS,
+    SETTINGS_FIELD_ALERT_MESSAGE,
+    SETTINGS_FIELD_ALERT_COMPARE,
+    SETTINGS_FIELD_ALERT_THRESHOLD,
+    SETTINGS_FIELD_DYNAMIC_ENABLE,
+    SETTINGS_FIELD_DYNAMIC_PRIORITY,
+    SETTINGS_FIELD_DYNAMIC_COMPARE,
+    SETTINGS_FIELD_DYNAMIC_THRESHOLD,
+    SETTINGS_FIELD_DYNAMIC_VIEW_INDEX,
+    SETTINGS_FIELD_DYNAMIC_PID,
+    SETTINGS_FIELD_DYNAMIC_UNITS,
+    SETTINGS_FIELD_GENERAL_EE_VERSION,
+    SETTINGS_FIELD_GENERAL_SPLASH,
+    SETTINGS_FIELD_GENERAL_CAN_BUS_MODE,
+    SETTINGS_FIELD_COUNT
+} SETTINGS_FIELD;
+
+uint32_t settings_get_field_faults(void);
+
+// With lazy loading, load_settings() on direct storage reads nothing and each
+// section is fetched, decoded and crc checked by the first get_* or set_* that
+// touches it. settings_prefetch() loads a section ahead of time. The section
+// faults only cover the sections loaded so far.
+void settings_set_lazy_load(bool lazy);
+void settings_prefetch(SETTINGS_SECTION section);
+
+// Write endurance accounting kept in RAM since boot or the last reset. Each
+// 32 byte device page counts one cycle per program (one per byte with the byte
+// handlers) and each field counts the writes that actually changed it.
+// wear_to_json() reports the totals, the hottest pages and fields and, given
+// the seconds the counters cover, the projected lifetime of the hottest page
+// against the backend endurance (1000000 cycles when unknown).
+uint32_t settings_get_page_writes(uint16_t page);
+void settings_reset_wear(void);
+
+// Binary snapshot of the complete settings image for backup and provisioning.
+// Export returns the bytes written, 0 when the buffer is smaller than
+// settings_snapshot_size(). Import rejects a snapshot with a bad header, crc
+// or a different layout version, and otherwise persists and applies the image.
+uint32_t settings_snapshot_size(void);
+uint32_t settings_export_snapshot(uint8_t *buffer, uint32_t buffer_size);
+bool settings_import_snapshot(const uint8_t *buffer, uint32_t size);
+
 #define MAX_GAUGES_PER_VIEW 3
 #define MAX_ALERTS 5
 #define ALERT_MESSAGE_LEN 64
@@ -54,12 +251,71 @@ void settings_setReadHandler(settings_read *readHandler);
 
 void load_settings(void);
 void write_eeprom(uint16_t bAdd, uint8_t bData);
+void read_eeprom_block(uint16_t bAdd, uint8_t *pData, uint16_t len);
+void write_eeprom_block(uint16_t bAdd, const uint8_t *pData, uint16_t len);
 uint8_t get_eeprom_byte(uint16_t bAdd);
+// The JSON exports return the length without the terminator, 0 only when the
+// buffer is shorter than the *_json_length() result plus one.
 uint32_t options_to_json(char *buffer, uint32_t buffer_size);
 uint32_t config_to_json(char *buffer, uint32_t buffer_size);
+uint32_t options_json_length(void);
+// Options document as a constant in flash, terminated, no copy
+const char *options_json_data(uint32_t *len);
+uint32_t config_json_length(void);
+// Streams the same JSON to the sink in chunks without a heap or output buffer,
+// returns the total length
+uint32_t config_to_json_sink(json_sink *sink, void *context);
+
+// Resumable export for MTU sized transfers. Start from a zeroed cursor, each
+// call copies the next piece without a terminator and returns its length, 0
+// once everything has been sent. The configuration resumes at the entry the
+// last piece ended in, so each call costs about one piece. A setting that
+// changes between the first and the last piece would tear the document, the
+// call then returns 0 with changed set and the export has to start again from
+// a zeroed cursor.
+typedef struct
+{
+    uint32_t offset;
+    uint32_t values;
+    uint16_t item;
+    uint8_t depth;
+    uint8_t first;
+    bool changed;
+} settings_json_cursor;
+
+uint32_t options_to_json_next(settings_json_cursor *cursor, char *buffer, uint32_t buffer_size);
+uint32_t config_to_json_next(settings_json_cursor *cursor, char *buffer, uint32_t buffer_size);
+uint32_t wear_to_json(char *buffer, uint32_t buffer_size, uint32_t elapsed_seconds);
 bool json_to_config(const char *json_str)
 ;
 
+// Incremental JSON import for chunked transports, takes the same document as
+// json_to_config() in pieces of any size and applies each field as it
+// completes. Begin fails while another import is running. Feed and finish
+// return false on malformed input, which rolls every field of the import
+// back. The import is staged privately and finish commits it in any write
+// mode. Writes by other tasks during an import keep their own write mode and
+// are neither rolled back nor overwritten unless the import names the field.
+bool settings_json_import_begin(void);
+bool settings_json_import_feed(const char *data, uint32_t len);
+bool settings_json_import_finish(void);
+void settings_json_import_abort(void);
+
+// JSON merge patch (RFC 7396) against the config document, only the members
+// named in the patch are written. Sections and gauge lists also accept objects
+// keyed by element index, {"view":{"1":{"gauge":{"2":{"pid":"..."}}}}}, which
+// merge into the stored elements. An array replaces the whole list and resets
+// the elements and members it leaves out. null resets a member, element or
+// section to its defaults. EE_Version is never changed. A chunked patch starts
+// with settings_json_patch_begin() and continues with feed and finish.
+bool json_patch_config(const char *patch);
+bool settings_json_patch_begin(void);
+
+// Set one field by path, "view[1].gauge[2].pid" or "alert[0].threshold", to a
+// JSON scalar such as "\"Enabled\"", "42.5" or "null" for the default. Returns
+// false for an unknown path, a value of the wrong type or one the setter refuses.
+bool json_set_config_path(const char *path, const char *json_value);
+
 /********************************************************************************
 *                                  View enable                                  
 *
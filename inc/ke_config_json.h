@@ -0,0 +1,144 @@
+/**
+ ******************************************************************************
+ *
+ * Copyright (c) 2025 KaiserEngineering, LLC
+ * Author Matthew Kaiser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************
+ */
+
+#ifndef KE_CONFIG_JSON_H
+#define KE_CONFIG_JSON_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Receives the output of a sink writer in order, a chunk at a time
+typedef void(json_sink)(void *context, const char *data, uint32_t len);
+
+#define JSON_WRITER_MAX_DEPTH 8
+#define JSON_WRITER_CHUNK_SIZE 64
+
+// Streaming JSON writer with no heap use. Members are emitted in call order
+// and formatted like cJSON_PrintUnformatted(). A buffer writer keeps counting
+// past the end of the buffer so the required length is still known.
+typedef struct
+{
+	char *buffer;
+	uint32_t buffer_size;
+	json_sink *sink;
+	void *context;
+	uint32_t length;
+	uint16_t chunk_len;
+	uint8_t depth;
+	uint8_t first;
+	char chunk[JSON_WRITER_CHUNK_SIZE];
+} json_writer;
+
+void json_writer_init(json_writer *writer, char *buffer, uint32_t buffer_size);
+void json_writer_init_sink(json_writer *writer, json_sink *sink, void *context);
+
+// A NULL key adds the value as an array element or as the root
+void json_begin_object(json_writer *writer, const char *key);
+void json_end_object(json_writer *writer);
+void json_begin_array(json_writer *writer, const char *key);
+void json_end_array(json_writer *writer);
+void json_add_string(json_writer *writer, const char *key, const char *value);
+void json_add_string_n(json_writer *writer, const char *key, const char *value, uint32_t max_len);
+void json_add_number(json_writer *writer, const char *key, double value);
+
+// Terminates the output and flushes the sink. Returns the length without the
+// terminator, 0 when a buffer writer ran out of room.
+uint32_t json_writer_finish(json_writer *writer);
+
+// Sink that keeps only the output from offset up to offset + size, so a
+// document produced again on each call can be sent a piece at a time
+typedef struct
+{
+	char *buffer;
+	uint32_t size;
+	uint32_t offset;
+	uint32_t position;
+	uint32_t written;
+} json_window;
+
+void json_window_init(json_window *window, char *buffer, uint32_t size, uint32_t offset);
+void json_window_sink(void *context, const char *data, uint32_t len);
+
+typedef enum
+{
+	JSON_EVENT_OBJECT_BEGIN,
+	JSON_EVENT_OBJECT_END,
+	JSON_EVENT_ARRAY_BEGIN,
+	JSON_EVENT_ARRAY_END,
+	JSON_EVENT_KEY,
+	JSON_EVENT_STRING,
+	JSON_EVENT_NUMBER,
+	JSON_EVENT_TRUE,
+	JSON_EVENT_FALSE,
+	JSON_EVENT_NULL
+} JSON_EVENT;
+
+// Called for each complete token. Keys and strings arrive unescaped and
+// numbers as their source text, both NUL terminated, text is NULL for the
+// other events. Returning false stops the document with an error.
+typedef bool(json_handler)(void *context, JSON_EVENT event, const char *text, uint32_t len);
+
+#define JSON_READER_MAX_DEPTH 32
+#define JSON_READER_TOKEN_SIZE 128
+
+// Event driven JSON parser fed in chunks of any size, the memory it needs is
+// this struct whatever the document size. Keys and strings longer than
+// JSON_READER_TOKEN_SIZE - 1 bytes are truncated on a character boundary,
+// longer numbers are rejected.
+typedef struct
+{
+	json_handler *handler;
+	void *context;
+	uint32_t arrays;
+	uint16_t unicode;
+	uint16_t high_surrogate;
+	uint16_t token_len;
+	uint8_t state;
+	uint8_t depth;
+	uint8_t digits;
+	bool key;
+	bool truncated;
+	const char *literal;
+	char token[JSON_READER_TOKEN_SIZE];
+} json_reader;
+
+void json_reader_init(json_reader *reader, json_handler *handler, void *context);
+// Returns false once the input is not valid JSON or the handler stopped it
+bool json_reader_feed(json_reader *reader, const char *data, uint32_t len);
+// Returns true when exactly one complete document was read
+bool json_reader_finish(json_reader *reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KE_CONFIG_JSON_H */
@@ -0,0 +1,64 @@
+/**
+ ******************************************************************************
+ *
+ * Copyright (c) 2025 KaiserEngineering, LLC
+ * Author Matthew Kaiser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************
+ */
+
+#ifndef KE_CONFIG_MMAP_H
+#define KE_CONFIG_MMAP_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef ESP_PLATFORM
+
+// Host EEPROM backend, maps an image file and installs it as the settings
+// backend. size must cover the 512 byte memory map and every range the chosen
+// storage uses, at most 64 KiB. A missing or short file is extended with 0xFF
+// like a blank EEPROM. With sync_on_commit every write-through store and
+// commit is followed by msync and fsync, otherwise the kernel writes the image
+// back on its own.
+bool settings_mmap_open(const char *path, uint32_t size, bool sync_on_commit);
+void settings_mmap_close(void);
+
+// Direct view of the mapped image, NULL while closed
+uint8_t *settings_mmap_image(void);
+
+// True once a store or load fell outside the image or msync or fsync failed,
+// cleared by the next open. A failed sync leaves the data in the mapping
+// without any guarantee that it reached the file.
+bool settings_mmap_error(void);
+
+#endif /* ESP_PLATFORM */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KE_CONFIG_MMAP_H */
@@ -26,6 +26,9 @@
  */
 
 #include "ke_config.h"
+#include <limits.h>
+#include <pthread.h>
+#include <strings.h>
 
 #define DEFAULT_VIEW_ENABLE VIEW_STATE_DISABLED
 #define DEFAULT_VIEW_NUM_GAUGES 0
@@ -48,7 +51,7 @@
 #define DEFAULT_DYNAMIC_VIEW_INDEX 0
 #define DEFAULT_DYNAMIC_PID 0
 #define DEFAULT_DYNAMIC_UNITS PID_UNITS_RESERVED
-#define DEFAULT_GENERAL_EE_VERSION 255
+#define DEFAULT_GENERAL_EE_VERSION 1
 #define DEFAULT_GENERAL_SPLASH 5
 #define DEFAULT_GENERAL_CAN_BUS_MODE CAN_BUS_MODE_NORMAL_MODE
 
@@ -77,6 +80,67 @@
 #define EE_SIZE_GENERAL_SPLASH 2
 #define EE_SIZE_GENERAL_CAN_BUS_MODE 1
 
+// Option strings, each list expands into its *_string table and into the
+// constant options JSON. FIRST takes the first entry and NEXT the others.
+#define VIEW_STATE_STRINGS(FIRST, NEXT) \
+    FIRST("Disabled") \
+    NEXT("Enabled")
+#define VIEW_BACKGROUND_STRINGS(FIRST, NEXT) \
+    FIRST("User1") \
+    NEXT("User2") \
+    NEXT("User3") \
+    NEXT("User4") \
+    NEXT("User5") \
+    NEXT("User6") \
+    NEXT("User7") \
+    NEXT("User8") \
+    NEXT("User9") \
+    NEXT("User10")
+#define VIEW_BACKGROUND_TYPE_STRINGS(FIRST, NEXT) \
+    FIRST("Color") \
+    NEXT("Image")
+#define GAUGE_THEME_STRINGS(FIRST, NEXT) \
+    FIRST("Stock ST") \
+    NEXT("Stock RS") \
+    NEXT("Grumpy Cat") \
+    NEXT("Linear") \
+    NEXT("Radial") \
+    NEXT("Digital") \
+    NEXT("Arc")
+#define ALERT_STATE_STRINGS(FIRST, NEXT) \
+    FIRST("Disabled") \
+    NEXT("Enabled")
+#define ALERT_COMPARISON_STRINGS(FIRST, NEXT) \
+    FIRST("Less Than") \
+    NEXT("Less Than Or Equal To") \
+    NEXT("Greater Than") \
+    NEXT("Greater Than Or Equal To") \
+    NEXT("Equal") \
+    NEXT("Not Equal")
+#define DYNAMIC_STATE_STRINGS(FIRST, NEXT) \
+    FIRST("Disabled") \
+    NEXT("Enabled")
+#define DYNAMIC_PRIORITY_STRINGS(FIRST, NEXT) \
+    FIRST("Low") \
+    NEXT("Medium") \
+    NEXT("High")
+#define DYNAMIC_COMPARISON_STRINGS(FIRST, NEXT) \
+    FIRST("Less Than") \
+    NEXT("Less Than Or Equal To") \
+    NEXT("Greater Than") \
+    NEXT("Greater Than Or Equal To") \
+    NEXT("Equal") \
+    NEXT("Not Equal")
+#define CAN_BUS_MODE_STRINGS(FIRST, NEXT) \
+    FIRST("Normal Mode") \
+    NEXT("Listen Only")
+
+#define OPTION_STRING(s) s
+#define OPTION_STRING_NEXT(s) , s
+#define OPTION_JSON(s) "\"" s "\""
+#define OPTION_JSON_NEXT(s) ",\"" s "\""
+#define OPTION_JSON_LIST(key, STRINGS) "\"" key "\":[" STRINGS(OPTION_JSON, OPTION_JSON_NEXT) "]"
+
 // EEPROM Memory Map - view enable
 #define EEPROM_VIEW_ENABLE1_BYTE1 (uint16_t)0x0000
 #define EEPROM_VIEW_ENABLE2_BYTE1 (uint16_t)0x0001
@@ -126,24 +190,6 @@ static const uint16_t map_view_background_color_byte1[MAX_VIEWS] = {
     EEPROM_VIEW_BACKGROUND_COLOR3_BYTE1
     };
 
-static const uint16_t map_view_background_color_byte2[MAX_VIEWS] = {
-    EEPROM_VIEW_BACKGROUND_COLOR1_BYTE2,
-    EEPROM_VIEW_BACKGROUND_COLOR2_BYTE2,
-    EEPROM_VIEW_BACKGROUND_COLOR3_BYTE2
-    };
-
-static const uint16_t map_view_background_color_byte3[MAX_VIEWS] = {
-    EEPROM_VIEW_BACKGROUND_COLOR1_BYTE3,
-    EEPROM_VIEW_BACKGROUND_COLOR2_BYTE3,
-    EEPROM_VIEW_BACKGROUND_COLOR3_BYTE3
-    };
-
-static const uint16_t map_view_background_color_byte4[MAX_VIEWS] = {
-    EEPROM_VIEW_BACKGROUND_COLOR1_BYTE4,
-    EEPROM_VIEW_BACKGROUND_COLOR2_BYTE4,
-    EEPROM_VIEW_BACKGROUND_COLOR3_BYTE4
-    };
-
 // EEPROM Memory Map - view background_type
 #define EEPROM_VIEW_BACKGROUND_TYPE1_BYTE1 (uint16_t)0x0015
 #define EEPROM_VIEW_BACKGROUND_TYPE2_BYTE1 (uint16_t)0x0016
@@ -219,33 +265,6 @@ static const uint16_t map_view_gauge_pid_byte1[MAX_VIEWS][MAX_GAUGES_PER_VIEW] =
     EEPROM_VIEW3_GAUGE_PID_BYTE1
     };
 
-#define EEPROM_VIEW1_GAUGE_PID_BYTE2 {EEPROM_VIEW1_GAUGE_PID1_BYTE2, EEPROM_VIEW1_GAUGE_PID2_BYTE2, EEPROM_VIEW1_GAUGE_PID3_BYTE2}
-#define EEPROM_VIEW2_GAUGE_PID_BYTE2 {EEPROM_VIEW2_GAUGE_PID1_BYTE2, EEPROM_VIEW2_GAUGE_PID2_BYTE2, EEPROM_VIEW2_GAUGE_PID3_BYTE2}
-#define EEPROM_VIEW3_GAUGE_PID_BYTE2 {EEPROM_VIEW3_GAUGE_PID1_BYTE2, EEPROM_VIEW3_GAUGE_PID2_BYTE2, EEPROM_VIEW3_GAUGE_PID3_BYTE2}
-static const uint16_t map_view_gauge_pid_byte2[MAX_VIEWS][MAX_GAUGES_PER_VIEW] = {
-    EEPROM_VIEW1_GAUGE_PID_BYTE2,
-    EEPROM_VIEW2_GAUGE_PID_BYTE2,
-    EEPROM_VIEW3_GAUGE_PID_BYTE2
-    };
-
-#define EEPROM_VIEW1_GAUGE_PID_BYTE3 {EEPROM_VIEW1_GAUGE_PID1_BYTE3, EEPROM_VIEW1_GAUGE_PID2_BYTE3, EEPROM_VIEW1_GAUGE_PID3_BYTE3}
-#define EEPROM_VIEW2_GAUGE_PID_BYTE3 {EEPROM_VIEW2_GAUGE_PID1_BYTE3, EEPROM_VIEW2_GAUGE_PID2_BYTE3, EEPROM_VIEW2_GAUGE_PID3_BYTE3}
-#define EEPROM_VIEW3_GAUGE_PID_BYTE3 {EEPROM_VIEW3_GAUGE_PID1_BYTE3, EEPROM_VIEW3_GAUGE_PID2_BYTE3, EEPROM_VIEW3_GAUGE_PID3_BYTE3}
-static const uint16_t map_view_gauge_pid_byte3[MAX_VIEWS][MAX_GAUGES_PER_VIEW] = {
-    EEPROM_VIEW1_GAUGE_PID_BYTE3,
-    EEPROM_VIEW2_GAUGE_PID_BYTE3,
-    EEPROM_VIEW3_GAUGE_PID_BYTE3
-    };
-
-#define EEPROM_VIEW1_GAUGE_PID_BYTE4 {EEPROM_VIEW1_GAUGE_PID1_BYTE4, EEPROM_VIEW1_GAUGE_PID2_BYTE4, EEPROM_VIEW1_GAUGE_PID3_BYTE4}
-#define EEPROM_VIEW2_GAUGE_PID_BYTE4 {EEPROM_VIEW2_GAUGE_PID1_BYTE4, EEPROM_VIEW2_GAUGE_PID2_BYTE4, EEPROM_VIEW2_GAUGE_PID3_BYTE4}
-#define EEPROM_VIEW3_GAUGE_PID_BYTE4 {EEPROM_VIEW3_GAUGE_PID1_BYTE4, EEPROM_VIEW3_GAUGE_PID2_BYTE4, EEPROM_VIEW3_GAUGE_PID3_BYTE4}
-static const uint16_t map_view_gauge_pid_byte4[MAX_VIEWS][MAX_GAUGES_PER_VIEW] = {
-    EEPROM_VIEW1_GAUGE_PID_BYTE4,
-    EEPROM_VIEW2_GAUGE_PID_BYTE4,
-    EEPROM_VIEW3_GAUGE_PID_BYTE4
-    };
-
 // EEPROM Memory Map - view_gauge units
 #define EEPROM_VIEW1_GAUGE_UNITS1_BYTE1 (uint16_t)0x0045
 #define EEPROM_VIEW1_GAUGE_UNITS2_BYTE1 (uint16_t)0x0046
@@ -308,30 +327,6 @@ static const uint16_t map_alert_pid_byte1[MAX_ALERTS] = {
     EEPROM_ALERT_PID5_BYTE1
     };
 
-static const uint16_t map_alert_pid_byte2[MAX_ALERTS] = {
-    EEPROM_ALERT_PID1_BYTE2,
-    EEPROM_ALERT_PID2_BYTE2,
-    EEPROM_ALERT_PID3_BYTE2,
-    EEPROM_ALERT_PID4_BYTE2,
-    EEPROM_ALERT_PID5_BYTE2
-    };
-
-static const uint16_t map_alert_pid_byte3[MAX_ALERTS] = {
-    EEPROM_ALERT_PID1_BYTE3,
-    EEPROM_ALERT_PID2_BYTE3,
-    EEPROM_ALERT_PID3_BYTE3,
-    EEPROM_ALERT_PID4_BYTE3,
-    EEPROM_ALERT_PID5_BYTE3
-    };
-
-static const uint16_t map_alert_pid_byte4[MAX_ALERTS] = {
-    EEPROM_ALERT_PID1_BYTE4,
-    EEPROM_ALERT_PID2_BYTE4,
-    EEPROM_ALERT_PID3_BYTE4,
-    EEPROM_ALERT_PID4_BYTE4,
-    EEPROM_ALERT_PID5_BYTE4
-    };
-
 // EEPROM Memory Map - alert units
 #define EEPROM_ALERT_UNITS1_BYTE1 (uint16_t)0x0067
 #define EEPROM_ALERT_UNITS2_BYTE1 (uint16_t)0x0068
@@ -675,510 +670,6 @@ static const uint16_t map_alert_message_byte1[MAX_ALERTS] = {
     EEPROM_ALERT_MESSAGE5_BYTE1
     };
 
-static const uint16_t map_alert_message_byte2[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE2,
-    EEPROM_ALERT_MESSAGE2_BYTE2,
-    EEPROM_ALERT_MESSAGE3_BYTE2,
-    EEPROM_ALERT_MESSAGE4_BYTE2,
-    EEPROM_ALERT_MESSAGE5_BYTE2
-    };
-
-static const uint16_t map_alert_message_byte3[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE3,
-    EEPROM_ALERT_MESSAGE2_BYTE3,
-    EEPROM_ALERT_MESSAGE3_BYTE3,
-    EEPROM_ALERT_MESSAGE4_BYTE3,
-    EEPROM_ALERT_MESSAGE5_BYTE3
-    };
-
-static const uint16_t map_alert_message_byte4[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE4,
-    EEPROM_ALERT_MESSAGE2_BYTE4,
-    EEPROM_ALERT_MESSAGE3_BYTE4,
-    EEPROM_ALERT_MESSAGE4_BYTE4,
-    EEPROM_ALERT_MESSAGE5_BYTE4
-    };
-
-static const uint16_t map_alert_message_byte5[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE5,
-    EEPROM_ALERT_MESSAGE2_BYTE5,
-    EEPROM_ALERT_MESSAGE3_BYTE5,
-    EEPROM_ALERT_MESSAGE4_BYTE5,
-    EEPROM_ALERT_MESSAGE5_BYTE5
-    };
-
-static const uint16_t map_alert_message_byte6[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE6,
-    EEPROM_ALERT_MESSAGE2_BYTE6,
-    EEPROM_ALERT_MESSAGE3_BYTE6,
-    EEPROM_ALERT_MESSAGE4_BYTE6,
-    EEPROM_ALERT_MESSAGE5_BYTE6
-    };
-
-static const uint16_t map_alert_message_byte7[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE7,
-    EEPROM_ALERT_MESSAGE2_BYTE7,
-    EEPROM_ALERT_MESSAGE3_BYTE7,
-    EEPROM_ALERT_MESSAGE4_BYTE7,
-    EEPROM_ALERT_MESSAGE5_BYTE7
-    };
-
-static const uint16_t map_alert_message_byte8[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE8,
-    EEPROM_ALERT_MESSAGE2_BYTE8,
-    EEPROM_ALERT_MESSAGE3_BYTE8,
-    EEPROM_ALERT_MESSAGE4_BYTE8,
-    EEPROM_ALERT_MESSAGE5_BYTE8
-    };
-
-static const uint16_t map_alert_message_byte9[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE9,
-    EEPROM_ALERT_MESSAGE2_BYTE9,
-    EEPROM_ALERT_MESSAGE3_BYTE9,
-    EEPROM_ALERT_MESSAGE4_BYTE9,
-    EEPROM_ALERT_MESSAGE5_BYTE9
-    };
-
-static const uint16_t map_alert_message_byte10[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE10,
-    EEPROM_ALERT_MESSAGE2_BYTE10,
-    EEPROM_ALERT_MESSAGE3_BYTE10,
-    EEPROM_ALERT_MESSAGE4_BYTE10,
-    EEPROM_ALERT_MESSAGE5_BYTE10
-    };
-
-static const uint16_t map_alert_message_byte11[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE11,
-    EEPROM_ALERT_MESSAGE2_BYTE11,
-    EEPROM_ALERT_MESSAGE3_BYTE11,
-    EEPROM_ALERT_MESSAGE4_BYTE11,
-    EEPROM_ALERT_MESSAGE5_BYTE11
-    };
-
-static const uint16_t map_alert_message_byte12[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE12,
-    EEPROM_ALERT_MESSAGE2_BYTE12,
-    EEPROM_ALERT_MESSAGE3_BYTE12,
-    EEPROM_ALERT_MESSAGE4_BYTE12,
-    EEPROM_ALERT_MESSAGE5_BYTE12
-    };
-
-static const uint16_t map_alert_message_byte13[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE13,
-    EEPROM_ALERT_MESSAGE2_BYTE13,
-    EEPROM_ALERT_MESSAGE3_BYTE13,
-    EEPROM_ALERT_MESSAGE4_BYTE13,
-    EEPROM_ALERT_MESSAGE5_BYTE13
-    };
-
-static const uint16_t map_alert_message_byte14[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE14,
-    EEPROM_ALERT_MESSAGE2_BYTE14,
-    EEPROM_ALERT_MESSAGE3_BYTE14,
-    EEPROM_ALERT_MESSAGE4_BYTE14,
-    EEPROM_ALERT_MESSAGE5_BYTE14
-    };
-
-static const uint16_t map_alert_message_byte15[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE15,
-    EEPROM_ALERT_MESSAGE2_BYTE15,
-    EEPROM_ALERT_MESSAGE3_BYTE15,
-    EEPROM_ALERT_MESSAGE4_BYTE15,
-    EEPROM_ALERT_MESSAGE5_BYTE15
-    };
-
-static const uint16_t map_alert_message_byte16[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE16,
-    EEPROM_ALERT_MESSAGE2_BYTE16,
-    EEPROM_ALERT_MESSAGE3_BYTE16,
-    EEPROM_ALERT_MESSAGE4_BYTE16,
-    EEPROM_ALERT_MESSAGE5_BYTE16
-    };
-
-static const uint16_t map_alert_message_byte17[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE17,
-    EEPROM_ALERT_MESSAGE2_BYTE17,
-    EEPROM_ALERT_MESSAGE3_BYTE17,
-    EEPROM_ALERT_MESSAGE4_BYTE17,
-    EEPROM_ALERT_MESSAGE5_BYTE17
-    };
-
-static const uint16_t map_alert_message_byte18[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE18,
-    EEPROM_ALERT_MESSAGE2_BYTE18,
-    EEPROM_ALERT_MESSAGE3_BYTE18,
-    EEPROM_ALERT_MESSAGE4_BYTE18,
-    EEPROM_ALERT_MESSAGE5_BYTE18
-    };
-
-static const uint16_t map_alert_message_byte19[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE19,
-    EEPROM_ALERT_MESSAGE2_BYTE19,
-    EEPROM_ALERT_MESSAGE3_BYTE19,
-    EEPROM_ALERT_MESSAGE4_BYTE19,
-    EEPROM_ALERT_MESSAGE5_BYTE19
-    };
-
-static const uint16_t map_alert_message_byte20[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE20,
-    EEPROM_ALERT_MESSAGE2_BYTE20,
-    EEPROM_ALERT_MESSAGE3_BYTE20,
-    EEPROM_ALERT_MESSAGE4_BYTE20,
-    EEPROM_ALERT_MESSAGE5_BYTE20
-    };
-
-static const uint16_t map_alert_message_byte21[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE21,
-    EEPROM_ALERT_MESSAGE2_BYTE21,
-    EEPROM_ALERT_MESSAGE3_BYTE21,
-    EEPROM_ALERT_MESSAGE4_BYTE21,
-    EEPROM_ALERT_MESSAGE5_BYTE21
-    };
-
-static const uint16_t map_alert_message_byte22[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE22,
-    EEPROM_ALERT_MESSAGE2_BYTE22,
-    EEPROM_ALERT_MESSAGE3_BYTE22,
-    EEPROM_ALERT_MESSAGE4_BYTE22,
-    EEPROM_ALERT_MESSAGE5_BYTE22
-    };
-
-static const uint16_t map_alert_message_byte23[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE23,
-    EEPROM_ALERT_MESSAGE2_BYTE23,
-    EEPROM_ALERT_MESSAGE3_BYTE23,
-    EEPROM_ALERT_MESSAGE4_BYTE23,
-    EEPROM_ALERT_MESSAGE5_BYTE23
-    };
-
-static const uint16_t map_alert_message_byte24[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE24,
-    EEPROM_ALERT_MESSAGE2_BYTE24,
-    EEPROM_ALERT_MESSAGE3_BYTE24,
-    EEPROM_ALERT_MESSAGE4_BYTE24,
-    EEPROM_ALERT_MESSAGE5_BYTE24
-    };
-
-static const uint16_t map_alert_message_byte25[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE25,
-    EEPROM_ALERT_MESSAGE2_BYTE25,
-    EEPROM_ALERT_MESSAGE3_BYTE25,
-    EEPROM_ALERT_MESSAGE4_BYTE25,
-    EEPROM_ALERT_MESSAGE5_BYTE25
-    };
-
-static const uint16_t map_alert_message_byte26[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE26,
-    EEPROM_ALERT_MESSAGE2_BYTE26,
-    EEPROM_ALERT_MESSAGE3_BYTE26,
-    EEPROM_ALERT_MESSAGE4_BYTE26,
-    EEPROM_ALERT_MESSAGE5_BYTE26
-    };
-
-static const uint16_t map_alert_message_byte27[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE27,
-    EEPROM_ALERT_MESSAGE2_BYTE27,
-    EEPROM_ALERT_MESSAGE3_BYTE27,
-    EEPROM_ALERT_MESSAGE4_BYTE27,
-    EEPROM_ALERT_MESSAGE5_BYTE27
-    };
-
-static const uint16_t map_alert_message_byte28[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE28,
-    EEPROM_ALERT_MESSAGE2_BYTE28,
-    EEPROM_ALERT_MESSAGE3_BYTE28,
-    EEPROM_ALERT_MESSAGE4_BYTE28,
-    EEPROM_ALERT_MESSAGE5_BYTE28
-    };
-
-static const uint16_t map_alert_message_byte29[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE29,
-    EEPROM_ALERT_MESSAGE2_BYTE29,
-    EEPROM_ALERT_MESSAGE3_BYTE29,
-    EEPROM_ALERT_MESSAGE4_BYTE29,
-    EEPROM_ALERT_MESSAGE5_BYTE29
-    };
-
-static const uint16_t map_alert_message_byte30[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE30,
-    EEPROM_ALERT_MESSAGE2_BYTE30,
-    EEPROM_ALERT_MESSAGE3_BYTE30,
-    EEPROM_ALERT_MESSAGE4_BYTE30,
-    EEPROM_ALERT_MESSAGE5_BYTE30
-    };
-
-static const uint16_t map_alert_message_byte31[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE31,
-    EEPROM_ALERT_MESSAGE2_BYTE31,
-    EEPROM_ALERT_MESSAGE3_BYTE31,
-    EEPROM_ALERT_MESSAGE4_BYTE31,
-    EEPROM_ALERT_MESSAGE5_BYTE31
-    };
-
-static const uint16_t map_alert_message_byte32[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE32,
-    EEPROM_ALERT_MESSAGE2_BYTE32,
-    EEPROM_ALERT_MESSAGE3_BYTE32,
-    EEPROM_ALERT_MESSAGE4_BYTE32,
-    EEPROM_ALERT_MESSAGE5_BYTE32
-    };
-
-static const uint16_t map_alert_message_byte33[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE33,
-    EEPROM_ALERT_MESSAGE2_BYTE33,
-    EEPROM_ALERT_MESSAGE3_BYTE33,
-    EEPROM_ALERT_MESSAGE4_BYTE33,
-    EEPROM_ALERT_MESSAGE5_BYTE33
-    };
-
-static const uint16_t map_alert_message_byte34[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE34,
-    EEPROM_ALERT_MESSAGE2_BYTE34,
-    EEPROM_ALERT_MESSAGE3_BYTE34,
-    EEPROM_ALERT_MESSAGE4_BYTE34,
-    EEPROM_ALERT_MESSAGE5_BYTE34
-    };
-
-static const uint16_t map_alert_message_byte35[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE35,
-    EEPROM_ALERT_MESSAGE2_BYTE35,
-    EEPROM_ALERT_MESSAGE3_BYTE35,
-    EEPROM_ALERT_MESSAGE4_BYTE35,
-    EEPROM_ALERT_MESSAGE5_BYTE35
-    };
-
-static const uint16_t map_alert_message_byte36[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE36,
-    EEPROM_ALERT_MESSAGE2_BYTE36,
-    EEPROM_ALERT_MESSAGE3_BYTE36,
-    EEPROM_ALERT_MESSAGE4_BYTE36,
-    EEPROM_ALERT_MESSAGE5_BYTE36
-    };
-
-static const uint16_t map_alert_message_byte37[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE37,
-    EEPROM_ALERT_MESSAGE2_BYTE37,
-    EEPROM_ALERT_MESSAGE3_BYTE37,
-    EEPROM_ALERT_MESSAGE4_BYTE37,
-    EEPROM_ALERT_MESSAGE5_BYTE37
-    };
-
-static const uint16_t map_alert_message_byte38[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE38,
-    EEPROM_ALERT_MESSAGE2_BYTE38,
-    EEPROM_ALERT_MESSAGE3_BYTE38,
-    EEPROM_ALERT_MESSAGE4_BYTE38,
-    EEPROM_ALERT_MESSAGE5_BYTE38
-    };
-
-static const uint16_t map_alert_message_byte39[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE39,
-    EEPROM_ALERT_MESSAGE2_BYTE39,
-    EEPROM_ALERT_MESSAGE3_BYTE39,
-    EEPROM_ALERT_MESSAGE4_BYTE39,
-    EEPROM_ALERT_MESSAGE5_BYTE39
-    };
-
-static const uint16_t map_alert_message_byte40[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE40,
-    EEPROM_ALERT_MESSAGE2_BYTE40,
-    EEPROM_ALERT_MESSAGE3_BYTE40,
-    EEPROM_ALERT_MESSAGE4_BYTE40,
-    EEPROM_ALERT_MESSAGE5_BYTE40
-    };
-
-static const uint16_t map_alert_message_byte41[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE41,
-    EEPROM_ALERT_MESSAGE2_BYTE41,
-    EEPROM_ALERT_MESSAGE3_BYTE41,
-    EEPROM_ALERT_MESSAGE4_BYTE41,
-    EEPROM_ALERT_MESSAGE5_BYTE41
-    };
-
-static const uint16_t map_alert_message_byte42[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE42,
-    EEPROM_ALERT_MESSAGE2_BYTE42,
-    EEPROM_ALERT_MESSAGE3_BYTE42,
-    EEPROM_ALERT_MESSAGE4_BYTE42,
-    EEPROM_ALERT_MESSAGE5_BYTE42
-    };
-
-static const uint16_t map_alert_message_byte43[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE43,
-    EEPROM_ALERT_MESSAGE2_BYTE43,
-    EEPROM_ALERT_MESSAGE3_BYTE43,
-    EEPROM_ALERT_MESSAGE4_BYTE43,
-    EEPROM_ALERT_MESSAGE5_BYTE43
-    };
-
-static const uint16_t map_alert_message_byte44[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE44,
-    EEPROM_ALERT_MESSAGE2_BYTE44,
-    EEPROM_ALERT_MESSAGE3_BYTE44,
-    EEPROM_ALERT_MESSAGE4_BYTE44,
-    EEPROM_ALERT_MESSAGE5_BYTE44
-    };
-
-static const uint16_t map_alert_message_byte45[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE45,
-    EEPROM_ALERT_MESSAGE2_BYTE45,
-    EEPROM_ALERT_MESSAGE3_BYTE45,
-    EEPROM_ALERT_MESSAGE4_BYTE45,
-    EEPROM_ALERT_MESSAGE5_BYTE45
-    };
-
-static const uint16_t map_alert_message_byte46[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE46,
-    EEPROM_ALERT_MESSAGE2_BYTE46,
-    EEPROM_ALERT_MESSAGE3_BYTE46,
-    EEPROM_ALERT_MESSAGE4_BYTE46,
-    EEPROM_ALERT_MESSAGE5_BYTE46
-    };
-
-static const uint16_t map_alert_message_byte47[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE47,
-    EEPROM_ALERT_MESSAGE2_BYTE47,
-    EEPROM_ALERT_MESSAGE3_BYTE47,
-    EEPROM_ALERT_MESSAGE4_BYTE47,
-    EEPROM_ALERT_MESSAGE5_BYTE47
-    };
-
-static const uint16_t map_alert_message_byte48[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE48,
-    EEPROM_ALERT_MESSAGE2_BYTE48,
-    EEPROM_ALERT_MESSAGE3_BYTE48,
-    EEPROM_ALERT_MESSAGE4_BYTE48,
-    EEPROM_ALERT_MESSAGE5_BYTE48
-    };
-
-static const uint16_t map_alert_message_byte49[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE49,
-    EEPROM_ALERT_MESSAGE2_BYTE49,
-    EEPROM_ALERT_MESSAGE3_BYTE49,
-    EEPROM_ALERT_MESSAGE4_BYTE49,
-    EEPROM_ALERT_MESSAGE5_BYTE49
-    };
-
-static const uint16_t map_alert_message_byte50[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE50,
-    EEPROM_ALERT_MESSAGE2_BYTE50,
-    EEPROM_ALERT_MESSAGE3_BYTE50,
-    EEPROM_ALERT_MESSAGE4_BYTE50,
-    EEPROM_ALERT_MESSAGE5_BYTE50
-    };
-
-static const uint16_t map_alert_message_byte51[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE51,
-    EEPROM_ALERT_MESSAGE2_BYTE51,
-    EEPROM_ALERT_MESSAGE3_BYTE51,
-    EEPROM_ALERT_MESSAGE4_BYTE51,
-    EEPROM_ALERT_MESSAGE5_BYTE51
-    };
-
-static const uint16_t map_alert_message_byte52[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE52,
-    EEPROM_ALERT_MESSAGE2_BYTE52,
-    EEPROM_ALERT_MESSAGE3_BYTE52,
-    EEPROM_ALERT_MESSAGE4_BYTE52,
-    EEPROM_ALERT_MESSAGE5_BYTE52
-    };
-
-static const uint16_t map_alert_message_byte53[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE53,
-    EEPROM_ALERT_MESSAGE2_BYTE53,
-    EEPROM_ALERT_MESSAGE3_BYTE53,
-    EEPROM_ALERT_MESSAGE4_BYTE53,
-    EEPROM_ALERT_MESSAGE5_BYTE53
-    };
-
-static const uint16_t map_alert_message_byte54[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE54,
-    EEPROM_ALERT_MESSAGE2_BYTE54,
-    EEPROM_ALERT_MESSAGE3_BYTE54,
-    EEPROM_ALERT_MESSAGE4_BYTE54,
-    EEPROM_ALERT_MESSAGE5_BYTE54
-    };
-
-static const uint16_t map_alert_message_byte55[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE55,
-    EEPROM_ALERT_MESSAGE2_BYTE55,
-    EEPROM_ALERT_MESSAGE3_BYTE55,
-    EEPROM_ALERT_MESSAGE4_BYTE55,
-    EEPROM_ALERT_MESSAGE5_BYTE55
-    };
-
-static const uint16_t map_alert_message_byte56[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE56,
-    EEPROM_ALERT_MESSAGE2_BYTE56,
-    EEPROM_ALERT_MESSAGE3_BYTE56,
-    EEPROM_ALERT_MESSAGE4_BYTE56,
-    EEPROM_ALERT_MESSAGE5_BYTE56
-    };
-
-static const uint16_t map_alert_message_byte57[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE57,
-    EEPROM_ALERT_MESSAGE2_BYTE57,
-    EEPROM_ALERT_MESSAGE3_BYTE57,
-    EEPROM_ALERT_MESSAGE4_BYTE57,
-    EEPROM_ALERT_MESSAGE5_BYTE57
-    };
-
-static const uint16_t map_alert_message_byte58[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE58,
-    EEPROM_ALERT_MESSAGE2_BYTE58,
-    EEPROM_ALERT_MESSAGE3_BYTE58,
-    EEPROM_ALERT_MESSAGE4_BYTE58,
-    EEPROM_ALERT_MESSAGE5_BYTE58
-    };
-
-static const uint16_t map_alert_message_byte59[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE59,
-    EEPROM_ALERT_MESSAGE2_BYTE59,
-    EEPROM_ALERT_MESSAGE3_BYTE59,
-    EEPROM_ALERT_MESSAGE4_BYTE59,
-    EEPROM_ALERT_MESSAGE5_BYTE59
-    };
-
-static const uint16_t map_alert_message_byte60[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE60,
-    EEPROM_ALERT_MESSAGE2_BYTE60,
-    EEPROM_ALERT_MESSAGE3_BYTE60,
-    EEPROM_ALERT_MESSAGE4_BYTE60,
-    EEPROM_ALERT_MESSAGE5_BYTE60
-    };
-
-static const uint16_t map_alert_message_byte61[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE61,
-    EEPROM_ALERT_MESSAGE2_BYTE61,
-    EEPROM_ALERT_MESSAGE3_BYTE61,
-    EEPROM_ALERT_MESSAGE4_BYTE61,
-    EEPROM_ALERT_MESSAGE5_BYTE61
-    };
-
-static const uint16_t map_alert_message_byte62[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE62,
-    EEPROM_ALERT_MESSAGE2_BYTE62,
-    EEPROM_ALERT_MESSAGE3_BYTE62,
-    EEPROM_ALERT_MESSAGE4_BYTE62,
-    EEPROM_ALERT_MESSAGE5_BYTE62
-    };
-
-static const uint16_t map_alert_message_byte63[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE63,
-    EEPROM_ALERT_MESSAGE2_BYTE63,
-    EEPROM_ALERT_MESSAGE3_BYTE63,
-    EEPROM_ALERT_MESSAGE4_BYTE63,
-    EEPROM_ALERT_MESSAGE5_BYTE63
-    };
-
-static const uint16_t map_alert_message_byte64[MAX_ALERTS] = {
-    EEPROM_ALERT_MESSAGE1_BYTE64,
-    EEPROM_ALERT_MESSAGE2_BYTE64,
-    EEPROM_ALERT_MESSAGE3_BYTE64,
-    EEPROM_ALERT_MESSAGE4_BYTE64,
-    EEPROM_ALERT_MESSAGE5_BYTE64
-    };
-
 // EEPROM Memory Map - alert compare
 #define EEPROM_ALERT_COMPARE1_BYTE1 (uint16_t)0x01AC
 #define EEPROM_ALERT_COMPARE2_BYTE1 (uint16_t)0x01AD
@@ -1222,30 +713,6 @@ static const uint16_t map_alert_threshold_byte1[MAX_ALERTS] = {
     EEPROM_ALERT_THRESHOLD5_BYTE1
     };
 
-static const uint16_t map_alert_threshold_byte2[MAX_ALERTS] = {
-    EEPROM_ALERT_THRESHOLD1_BYTE2,
-    EEPROM_ALERT_THRESHOLD2_BYTE2,
-    EEPROM_ALERT_THRESHOLD3_BYTE2,
-    EEPROM_ALERT_THRESHOLD4_BYTE2,
-    EEPROM_ALERT_THRESHOLD5_BYTE2
-    };
-
-static const uint16_t map_alert_threshold_byte3[MAX_ALERTS] = {
-    EEPROM_ALERT_THRESHOLD1_BYTE3,
-    EEPROM_ALERT_THRESHOLD2_BYTE3,
-    EEPROM_ALERT_THRESHOLD3_BYTE3,
-    EEPROM_ALERT_THRESHOLD4_BYTE3,
-    EEPROM_ALERT_THRESHOLD5_BYTE3
-    };
-
-static const uint16_t map_alert_threshold_byte4[MAX_ALERTS] = {
-    EEPROM_ALERT_THRESHOLD1_BYTE4,
-    EEPROM_ALERT_THRESHOLD2_BYTE4,
-    EEPROM_ALERT_THRESHOLD3_BYTE4,
-    EEPROM_ALERT_THRESHOLD4_BYTE4,
-    EEPROM_ALERT_THRESHOLD5_BYTE4
-    };
-
 // EEPROM Memory Map - dynamic enable
 #define EEPROM_DYNAMIC_ENABLE1_BYTE1 (uint16_t)0x01C5
 #define EEPROM_DYNAMIC_ENABLE2_BYTE1 (uint16_t)0x01C6
@@ -1295,24 +762,6 @@ static const uint16_t map_dynamic_threshold_byte1[MAX_DYNAMICS] = {
     EEPROM_DYNAMIC_THRESHOLD3_BYTE1
     };
 
-static const uint16_t map_dynamic_threshold_byte2[MAX_DYNAMICS] = {
-    EEPROM_DYNAMIC_THRESHOLD1_BYTE2,
-    EEPROM_DYNAMIC_THRESHOLD2_BYTE2,
-    EEPROM_DYNAMIC_THRESHOLD3_BYTE2
-    };
-
-static const uint16_t map_dynamic_threshold_byte3[MAX_DYNAMICS] = {
-    EEPROM_DYNAMIC_THRESHOLD1_BYTE3,
-    EEPROM_DYNAMIC_THRESHOLD2_BYTE3,
-    EEPROM_DYNAMIC_THRESHOLD3_BYTE3
-    };
-
-static const uint16_t map_dynamic_threshold_byte4[MAX_DYNAMICS] = {
-    EEPROM_DYNAMIC_THRESHOLD1_BYTE4,
-    EEPROM_DYNAMIC_THRESHOLD2_BYTE4,
-    EEPROM_DYNAMIC_THRESHOLD3_BYTE4
-    };
-
 // EEPROM Memory Map - dynamic view_index
 #define EEPROM_DYNAMIC_VIEW_INDEX1_BYTE1 (uint16_t)0x01DA
 #define EEPROM_DYNAMIC_VIEW_INDEX2_BYTE1 (uint16_t)0x01DB
@@ -1342,24 +791,6 @@ static const uint16_t map_dynamic_pid_byte1[MAX_DYNAMICS] = {
     EEPROM_DYNAMIC_PID3_BYTE1
     };
 
-static const uint16_t map_dynamic_pid_byte2[MAX_DYNAMICS] = {
-    EEPROM_DYNAMIC_PID1_BYTE2,
-    EEPROM_DYNAMIC_PID2_BYTE2,
-    EEPROM_DYNAMIC_PID3_BYTE2
-    };
-
-static const uint16_t map_dynamic_pid_byte3[MAX_DYNAMICS] = {
-    EEPROM_DYNAMIC_PID1_BYTE3,
-    EEPROM_DYNAMIC_PID2_BYTE3,
-    EEPROM_DYNAMIC_PID3_BYTE3
-    };
-
-static const uint16_t map_dynamic_pid_byte4[MAX_DYNAMICS] = {
-    EEPROM_DYNAMIC_PID1_BYTE4,
-    EEPROM_DYNAMIC_PID2_BYTE4,
-    EEPROM_DYNAMIC_PID3_BYTE4
-    };
-
 // EEPROM Memory Map - dynamic units
 #define EEPROM_DYNAMIC_UNITS1_BYTE1 (uint16_t)0x01E9
 #define EEPROM_DYNAMIC_UNITS2_BYTE1 (uint16_t)0x01EA
@@ -1383,16 +814,50 @@ static const uint16_t map_general_splash_byte1[MAX_GENERALS] = {
     EEPROM_GENERAL_SPLASH1_BYTE1
     };
 
-static const uint16_t map_general_splash_byte2[MAX_GENERALS] = {
-    EEPROM_GENERAL_SPLASH1_BYTE2
-    };
-
 // EEPROM Memory Map - general can_bus_mode
 #define EEPROM_GENERAL_CAN_BUS_MODE1_BYTE1 (uint16_t)0x01EF
 static const uint16_t map_general_can_bus_mode_byte1[MAX_GENERALS] = {
     EEPROM_GENERAL_CAN_BUS_MODE1_BYTE1
     };
 
+// EEPROM Memory Map - section crc
+#define EEPROM_SECTION_CRC_VIEW_BYTE1 (uint16_t)0x01F0
+#define EEPROM_SECTION_CRC_VIEW_BYTE2 (uint16_t)0x01F1
+#define EEPROM_SECTION_CRC_ALERT_BYTE1 (uint16_t)0x01F2
+#define EEPROM_SECTION_CRC_ALERT_BYTE2 (uint16_t)0x01F3
+#define EEPROM_SECTION_CRC_DYNAMIC_BYTE1 (uint16_t)0x01F4
+#define EEPROM_SECTION_CRC_DYNAMIC_BYTE2 (uint16_t)0x01F5
+#define EEPROM_SECTION_CRC_GENERAL_BYTE1 (uint16_t)0x01F6
+#define EEPROM_SECTION_CRC_GENERAL_BYTE2 (uint16_t)0x01F7
+#define EE_SIZE_SECTION_CRC 2
+static const uint16_t map_section_crc_byte1[SETTINGS_SECTION_COUNT] = {
+    EEPROM_SECTION_CRC_VIEW_BYTE1,
+    EEPROM_SECTION_CRC_ALERT_BYTE1,
+    EEPROM_SECTION_CRC_DYNAMIC_BYTE1,
+    EEPROM_SECTION_CRC_GENERAL_BYTE1
+    };
+
+// Range of the memory map covered by each section crc
+static const uint16_t map_section_start[SETTINGS_SECTION_COUNT] = {
+    EEPROM_VIEW_ENABLE1_BYTE1,
+    EEPROM_ALERT_ENABLE1_BYTE1,
+    EEPROM_DYNAMIC_ENABLE1_BYTE1,
+    EEPROM_GENERAL_EE_VERSION1_BYTE1
+    };
+
+static const uint16_t map_section_end[SETTINGS_SECTION_COUNT] = {
+    EEPROM_ALERT_ENABLE1_BYTE1,
+    EEPROM_DYNAMIC_ENABLE1_BYTE1,
+    EEPROM_GENERAL_EE_VERSION1_BYTE1,
+    EEPROM_SECTION_CRC_VIEW_BYTE1
+    };
+
+// EEPROM Memory Map - layout version, outside every section. Images written
+// before it existed hold 0xFF here whatever their EE_Version says. The map is
+// padded to 0x0200 so it stays a multiple of the backend write granularity.
+#define EEPROM_LAYOUT_VERSION_BYTE1 (uint16_t)0x01F8
+#define EE_SIZE_LAYOUT_VERSION 1
+
 
 static VIEW_STATE settings_view_enable[MAX_VIEWS] = {DEFAULT_VIEW_ENABLE};
 static uint8_t settings_view_num_gauges[MAX_GAUGES_PER_VIEW] = {DEFAULT_VIEW_NUM_GAUGES};
@@ -1444,417 +909,3950 @@ static void load_dynamic_units(uint8_t idx, PID_UNITS *dynamic_units_val);
 static void load_general_ee_version(uint8_t idx, uint8_t *general_ee_version_val);
 static void load_general_splash(uint8_t idx, uint16_t *general_splash_val);
 static void load_general_can_bus_mode(uint8_t idx, CAN_BUS_MODE *general_can_bus_mode_val);
+static void save_view_enable(uint8_t idx, VIEW_STATE *view_enable);
+static void save_view_num_gauges(uint8_t idx, uint8_t *view_num_gauges);
+static void save_view_background(uint8_t idx, VIEW_BACKGROUND *view_background);
+static void save_view_background_color(uint8_t idx, uint32_t *view_background_color);
+static void save_view_background_type(uint8_t idx, VIEW_BACKGROUND_TYPE *view_background_type);
+static void save_view_gauge_theme(uint8_t idx_view, uint8_t idx_gauge, GAUGE_THEME *view_gauge_theme);
+static void save_view_gauge_pid(uint8_t idx_view, uint8_t idx_gauge, uint32_t *view_gauge_pid);
+static void save_view_gauge_units(uint8_t idx_view, uint8_t idx_gauge, PID_UNITS *view_gauge_units);
+static void save_alert_enable(uint8_t idx, ALERT_STATE *alert_enable);
+static void save_alert_pid(uint8_t idx, uint32_t *alert_pid);
+static void save_alert_units(uint8_t idx, PID_UNITS *alert_units);
+static void save_alert_message(uint8_t idx, char *alert_message);
+static void save_alert_compare(uint8_t idx, ALERT_COMPARISON *alert_compare);
+static void save_alert_threshold(uint8_t idx, float *alert_threshold);
+static void save_dynamic_enable(uint8_t idx, DYNAMIC_STATE *dynamic_enable);
+static void save_dynamic_priority(uint8_t idx, DYNAMIC_PRIORITY *dynamic_priority);
+static void save_dynamic_compare(uint8_t idx, DYNAMIC_COMPARISON *dynamic_compare);
+static void save_dynamic_threshold(uint8_t idx, float *dynamic_threshold);
+static void save_dynamic_view_index(uint8_t idx, uint8_t *dynamic_view_index);
+static void save_dynamic_pid(uint8_t idx, uint32_t *dynamic_pid);
+static void save_dynamic_units(uint8_t idx, PID_UNITS *dynamic_units);
+static void save_general_ee_version(uint8_t idx, uint8_t *general_ee_version);
+static void save_general_splash(uint8_t idx, uint16_t *general_splash);
+static void save_general_can_bus_mode(uint8_t idx, CAN_BUS_MODE *general_can_bus_mode);
+static uint32_t settings_values_hash(void);
+
+// The options never change at runtime, so the whole document is a string
+// constant in flash assembled from the option lists
+static const char options_json[] = "{"
+    OPTION_JSON_LIST("view_state", VIEW_STATE_STRINGS) ","
+    OPTION_JSON_LIST("view_background", VIEW_BACKGROUND_STRINGS) ","
+    OPTION_JSON_LIST("view_background_type", VIEW_BACKGROUND_TYPE_STRINGS) ","
+    OPTION_JSON_LIST("gauge_theme", GAUGE_THEME_STRINGS) ","
+    OPTION_JSON_LIST("alert_state", ALERT_STATE_STRINGS) ","
+    OPTION_JSON_LIST("alert_comparison", ALERT_COMPARISON_STRINGS) ","
+    OPTION_JSON_LIST("dynamic_state", DYNAMIC_STATE_STRINGS) ","
+    OPTION_JSON_LIST("dynamic_priority", DYNAMIC_PRIORITY_STRINGS) ","
+    OPTION_JSON_LIST("dynamic_comparison", DYNAMIC_COMPARISON_STRINGS) ","
+    OPTION_JSON_LIST("can_bus_mode", CAN_BUS_MODE_STRINGS)
+    "}";
+
+const char *options_json_data(uint32_t *len) {
+    if (len) *len = sizeof(options_json) - 1;
+
+    return options_json;
+}
 
 uint32_t options_to_json(char *buffer, uint32_t buffer_size) {
-    cJSON *root = cJSON_CreateObject();
+    if (!buffer || (sizeof(options_json) > buffer_size)) return 0; // 0 means the buffer was too small
+
+    memcpy(buffer, options_json, sizeof(options_json)); // Copy including null terminator
+
+    return sizeof(options_json) - 1;
+}
+
+uint32_t options_json_length(void) {
+    return sizeof(options_json) - 1;
+}
+
+uint32_t options_to_json_next(settings_json_cursor *cursor, char *buffer, uint32_t buffer_size) {
+    uint32_t len = 0;
+
+    if (cursor->offset < sizeof(options_json) - 1) {
+        len = sizeof(options_json) - 1 - cursor->offset;
+        if (len > buffer_size) len = buffer_size;
+
+        memcpy(buffer, &options_json[cursor->offset], len);
+        cursor->offset += len;
+    }
+
+    return len;
+}
+
+// Items of the configuration document in order: every view, alert, dynamic
+// and general entry, each with the brackets that open its array, then the
+// closing brackets. The resumable export renders one item at a time.
+#define CONFIG_JSON_ITEMS (MAX_VIEWS + MAX_ALERTS + MAX_DYNAMICS + MAX_GENERALS + 1)
+
+static void write_config_json_item(json_writer *writer, uint16_t item) {
+    char str_buf[1024];
+
+    // Serialize view
+    if (item < MAX_VIEWS) {
+        int i = item;
+        if (i == 0) {
+            json_begin_object(writer, NULL);
+            json_begin_array(writer, "view");
+        }
+        json_begin_object(writer, NULL);
+        json_add_string(writer, "enable", view_state_string[get_view_enable(i)]);
+        json_add_number(writer, "num_gauges", get_view_num_gauges(i));
+        json_add_string(writer, "background", view_background_string[get_view_background(i)]);
+        json_add_number(writer, "background_color", get_view_background_color(i));
+        json_add_string(writer, "background_type", view_background_type_string[get_view_background_type(i)]);
+
+        // Serialize gauge within view
+        json_begin_array(writer, "gauge");
+        for(int j = 0; j < MAX_GAUGES_PER_VIEW; j++) {
+            json_begin_object(writer, NULL);
+            json_add_string(writer, "theme", gauge_theme_string[get_view_gauge_theme(i, j)]);
+            get_pid_desc(get_view_gauge_pid(i, j), str_buf);
+            json_add_string(writer, "pid", str_buf);
+            get_unit_desc(get_view_gauge_units(i, j), str_buf);
+            json_add_string(writer, "units", str_buf);
+            json_end_object(writer);
+        }
+        json_end_array(writer);
+        json_end_object(writer);
+        return;
+    }
+    item -= MAX_VIEWS;
+
+    // Serialize alert
+    if (item < MAX_ALERTS) {
+        int i = item;
+        if (i == 0) {
+            json_end_array(writer);
+            json_begin_array(writer, "alert");
+        }
+        json_begin_object(writer, NULL);
+        json_add_string(writer, "enable", alert_state_string[get_alert_enable(i)]);
+        get_pid_desc(get_alert_pid(i), str_buf);
+        json_add_string(writer, "pid", str_buf);
+        get_unit_desc(get_alert_units(i), str_buf);
+        json_add_string(writer, "units", str_buf);
+        get_alert_message(i, str_buf);
+        json_add_string_n(writer, "message", str_buf, ALERT_MESSAGE_LEN);
+        json_add_string(writer, "compare", alert_comparison_string[get_alert_compare(i)]);
+        json_add_number(writer, "threshold", get_alert_threshold(i));
+        json_end_object(writer);
+        return;
+    }
+    item -= MAX_ALERTS;
+
+    // Serialize dynamic
+    if (item < MAX_DYNAMICS) {
+        int i = item;
+        if (i == 0) {
+            json_end_array(writer);
+            json_begin_array(writer, "dynamic");
+        }
+        json_begin_object(writer, NULL);
+        json_add_string(writer, "enable", dynamic_state_string[get_dynamic_enable(i)]);
+        json_add_string(writer, "priority", dynamic_priority_string[get_dynamic_priority(i)]);
+        json_add_string(writer, "compare", dynamic_comparison_string[get_dynamic_compare(i)]);
+        json_add_number(writer, "threshold", get_dynamic_threshold(i));
+        json_add_number(writer, "view_index", get_dynamic_view_index(i));
+        get_pid_desc(get_dynamic_pid(i), str_buf);
+        json_add_string(writer, "pid", str_buf);
+        get_unit_desc(get_dynamic_units(i), str_buf);
+        json_add_string(writer, "units", str_buf);
+        json_end_object(writer);
+        return;
+    }
+    item -= MAX_DYNAMICS;
+
+    // Serialize general
+    if (item < MAX_GENERALS) {
+        int i = item;
+        if (i == 0) {
+            json_end_array(writer);
+            json_begin_array(writer, "general");
+        }
+        json_begin_object(writer, NULL);
+        json_add_number(writer, "EE_Version", get_general_ee_version(i));
+        json_add_number(writer, "splash", get_general_splash(i));
+        json_add_string(writer, "can_bus_mode", can_bus_mode_string[get_general_can_bus_mode(i)]);
+        json_end_object(writer);
+        return;
+    }
+
+    json_end_array(writer);
+    json_end_object(writer);
+}
+
+// Streams the configuration through the writer in the key order the cJSON
+// version produced, so the output is unchanged and nothing is allocated
+static void write_config_json(json_writer *writer) {
+    for(uint16_t item = 0; item < CONFIG_JSON_ITEMS; item++)
+        write_config_json_item(writer, item);
+}
+
+uint32_t config_to_json(char *buffer, uint32_t buffer_size) {
+    json_writer writer;
+
+    json_writer_init(&writer, buffer, buffer_size);
+    write_config_json(&writer);
+
+    return json_writer_finish(&writer); // 0 means the buffer was too small
+}
+
+uint32_t config_to_json_sink(json_sink *sink, void *context) {
+    json_writer writer;
+
+    if (!sink) return 0;
+
+    json_writer_init_sink(&writer, sink, context);
+    write_config_json(&writer);
+
+    return json_writer_finish(&writer);
+}
+
+uint32_t config_json_length(void) {
+    json_writer writer;
+
+    json_writer_init(&writer, NULL, 0);
+    write_config_json(&writer);
+
+    return writer.length;
+}
+
+uint32_t config_to_json_next(settings_json_cursor *cursor, char *buffer, uint32_t buffer_size) {
+    json_writer writer;
+    json_window window;
+    uint32_t written = 0;
+
+    if (cursor->changed) return 0;
+
+    // The first piece fixes the values the whole document describes, lazy
+    // loading must not change them part way through
+    if ((cursor->item == 0) && (cursor->offset == 0)) {
+        for(uint8_t section = 0; section < SETTINGS_SECTION_COUNT; section++)
+            settings_prefetch((SETTINGS_SECTION)section);
+        cursor->values = settings_values_hash();
+    }
+
+    // Resume inside the current item, the writer state at its start is kept
+    // in the cursor so the items already sent are not produced again
+    while ((cursor->item < CONFIG_JSON_ITEMS) && (written < buffer_size)) {
+        json_window_init(&window, &buffer[written], buffer_size - written, cursor->offset);
+        json_writer_init_sink(&writer, json_window_sink, &window);
+        writer.depth = cursor->depth;
+        writer.first = cursor->first;
+        write_config_json_item(&writer, cursor->item);
+        json_writer_finish(&writer);
+
+        written += window.written;
+        if (window.position > cursor->offset + window.written) {
+            cursor->offset += window.written;
+            break;
+        }
+
+        cursor->item++;
+        cursor->offset = 0;
+        cursor->depth = writer.depth;
+        cursor->first = writer.first;
+    }
+
+    // A set since the first piece would tear the document
+    if (settings_values_hash() != cursor->values) {
+        cursor->changed = true;
+        return 0;
+    }
+
+    return written;
+}
+
+bool json_to_config(const char *json_str) {
+    if (!json_str || !settings_json_import_begin()) return false;
+
+    settings_json_import_feed(json_str, strlen(json_str));
+
+    return settings_json_import_finish();
+}
 
-    if (!root) return 0;
+bool json_patch_config(const char *patch) {
+    if (!patch || !settings_json_patch_begin()) return false;
+
+    settings_json_import_feed(patch, strlen(patch));
+
+    return settings_json_import_finish();
+}
+
+#define EEPROM_MAP_SIZE (uint16_t)0x0200
+#define EEPROM_PAGE_SIZE 32
+#define EEPROM_PAGE_COUNT ((EEPROM_MAP_SIZE + EEPROM_PAGE_SIZE - 1) / EEPROM_PAGE_SIZE)
+
+static uint8_t cached_settings[EEPROM_MAP_SIZE];
+
+static settings_write *write;
+static settings_read *read;
+static settings_write_block *write_block;
+static settings_read_block *read_block;
+static settings_sync *sync;
+
+// Write-back state, one bit per EEPROM page holding data not yet committed
+static SETTINGS_WRITE_MODE write_mode = SETTINGS_WRITE_THROUGH;
+static uint32_t dirty_pages = 0;
+
+// Async state, the dirty page set doubles as the write queue so repeated
+// writes to a page coalesce and the queue can never overflow
+static pthread_mutex_t settings_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t device_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t async_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t async_idle = PTHREAD_COND_INITIALIZER;
+static pthread_t async_thread;
+static bool async_started = false;
+static bool async_busy = false;
+static bool async_unsynced = false;
+
+// Trusted shadow state, cached_settings stands in for EEPROM reads once loaded
+static bool shadow_trusted = false;
+static bool shadow_valid = false;
+static uint16_t shadow_verify_interval = 0;
+static uint16_t shadow_writes = 0;
+static uint16_t shadow_verify_page = 0;
+
+// Sections that failed their crc, and fields holding a value that was replaced
+// by its default as it entered RAM
+static uint8_t settings_section_faults = 0;
+static uint32_t settings_field_faults = 0;
+
+// Lazy loading, a section is fetched and decoded by the first access to it
+static bool lazy_load = false;
+static bool lazy_fetch = false;
+static uint8_t settings_loaded_sections = 0;
+
+// Set once load_settings() has filled the cache, a storage switch after that
+// carries the cache over to the new storage
+static bool image_loaded = false;
+#define SECTION_LOAD(section) do { if (!(settings_loaded_sections & (1 << (section)))) settings_prefetch(section); } while (0)
+
+// Active storage engine for the settings image
+static SETTINGS_STORAGE storage = SETTINGS_STORAGE_DIRECT;
+
+// Journal record: crc8, length and flags, image address, sequence number, data
+#define JOURNAL_RECORD_SIZE 16
+#define JOURNAL_DATA_SIZE 8
+#define JOURNAL_OFFSET_CRC 0
+#define JOURNAL_OFFSET_FLAGS 1
+#define JOURNAL_OFFSET_ADDRESS 2
+#define JOURNAL_OFFSET_SEQ 4
+#define JOURNAL_OFFSET_DATA 8
+#define JOURNAL_LEN_MASK 0x0F
+#define JOURNAL_FLAG_FIRST 0x20 // First record of an update
+#define JOURNAL_FLAG_CHECKPOINT 0x40 // Record belongs to a compaction pass
+#define JOURNAL_FLAG_OPEN 0x80 // More records of the same update follow
+#define JOURNAL_CHECKPOINT_RECORDS ((EEPROM_MAP_SIZE + JOURNAL_DATA_SIZE - 1) / JOURNAL_DATA_SIZE)
+#define JOURNAL_MIN_RECORDS (4 * JOURNAL_CHECKPOINT_RECORDS)
+
+// Journal state, sequence numbers are absolute and map to slot seq % journal_records
+static uint16_t journal_base_address = 0;
+static uint32_t journal_records = 0;
+static uint32_t journal_head = 0; // Next sequence number to write
+static uint32_t journal_base = 0; // Oldest record still needed to rebuild the image
+static bool journal_pass_active = false;
+static uint32_t journal_pass_start = 0;
+static uint16_t journal_pass_next = 0; // Next checkpoint chunk of the active pass
+
+// Image the log rebuilds to, checkpoints copy it so uncommitted sets never reach the log
+static uint8_t journal_image[EEPROM_MAP_SIZE];
+
+// A/B slot: header page (magic, sequence number, image crc32, header crc8) followed by the image
+#define AB_HEADER_SIZE 11
+#define AB_OFFSET_MAGIC 0
+#define AB_OFFSET_SEQ 2
+#define AB_OFFSET_CRC 6
+#define AB_OFFSET_HEADER_CRC 10
+#define AB_MAGIC 0x4B45
+#define AB_SLOT_SIZE (EEPROM_PAGE_SIZE + EEPROM_MAP_SIZE)
+
+// A/B state, the inactive slot lags the active one by the pages in ab_stale_pages
+static uint16_t ab_slot_address[2] = {0, 0};
+static uint8_t ab_active = 0;
+static uint32_t ab_seq = 0;
+static uint32_t ab_stale_pages = 0;
+
+// Packed image: magic, then every field element at its packed bit width in
+// table order, then the section crcs
+#define PACKED_HEADER_SIZE 2
+#define PACKED_MAGIC 0x4B50
+#define PACKED_IMAGE_MAX (PACKED_HEADER_SIZE + EEPROM_MAP_SIZE)
+
+// Packed state, packed_image mirrors the packed image on the device
+static uint16_t packed_base_address = 0;
+static uint16_t packed_size = 0;
+static bool packed_formatted = false;
+static uint8_t packed_image[PACKED_IMAGE_MAX];
+
+// Intent log header: magic, payload length, payload crc16, header crc8. The
+// payload holds entries of image address, length and the new bytes.
+#define INTENT_HEADER_SIZE 8
+#define INTENT_OFFSET_MAGIC 0
+#define INTENT_OFFSET_LEN 2
+#define INTENT_OFFSET_CRC 4
+#define INTENT_OFFSET_HEADER_CRC 6
+#define INTENT_ENTRY_HEADER_SIZE 4
+#define INTENT_MAGIC 0x4B49
+#define INTENT_MIN_SIZE (INTENT_HEADER_SIZE + INTENT_ENTRY_HEADER_SIZE + EEPROM_PAGE_SIZE)
+
+// Intent log area, disabled while intent_size is 0
+static uint16_t intent_base_address = 0;
+static uint16_t intent_size = 0;
+
+void settings_setWriteHandler(settings_write *writeHandler) { write = writeHandler; }
+void settings_setReadHandler(settings_read *readHandler) { read = readHandler; }
+void settings_setWriteBlockHandler(settings_write_block *writeBlockHandler) { write_block = writeBlockHandler; }
+void settings_setReadBlockHandler(settings_read_block *readBlockHandler) { read_block = readBlockHandler; }
+void settings_setSyncHandler(settings_sync *syncHandler) { sync = syncHandler; }
+
+// Built-in backend wrapping the registered handlers, used until settings_set_backend()
+static void handler_read_range(uint16_t bAdd, uint8_t *pData, uint16_t len)
+{
+	if (read_block)
+		read_block(bAdd, pData, len); // One transaction for the range
+	else
+		for (uint16_t i = 0; i < len; i++)
+			pData[i] = read(bAdd + i); // Fall back to byte reads
+}
+
+static void handler_write_range(uint16_t bAdd, const uint8_t *pData, uint16_t len)
+{
+	if (write_block)
+		write_block(bAdd, pData, len);
+	else
+		for (uint16_t i = 0; i < len; i++)
+			write(bAdd + i, pData[i]); // Fall back to byte writes
+}
+
+static void handler_sync(void)
+{
+	if (sync)
+		sync();
+}
+
+static const SETTINGS_BACKEND handler_backend = {
+	.open = NULL,
+	.read_range = handler_read_range,
+	.write_range = handler_write_range,
+	.erase = NULL,
+	.sync = handler_sync,
+	.caps = {
+		.page_size = EEPROM_PAGE_SIZE,
+		.write_granularity = 1,
+		.endurance = 0
+	}
+};
+
+static const SETTINGS_BACKEND *backend = &handler_backend;
+
+// Converts an EEPROM address to a linear array index
+static uint16_t eeprom_address_to_linear_index(uint16_t address) {
+    uint16_t page = address >> 5;
+    uint16_t offset = address & 0x1F; // Mask lower 5 bits (0-31)
+    return (page * 32) + offset;
+
+}
+
+uint8_t read_eeprom(uint16_t bAdd)
+{
+	uint8_t byte = 0xFF;
+	read_eeprom_block(bAdd, &byte, 1);
+	return byte;
+}
+
+void write_eeprom(uint16_t bAdd, uint8_t bData)
+{
+	write_eeprom_block(bAdd, &bData, 1);
+}
+
+static void mark_eeprom_dirty(uint16_t bAdd, uint16_t len)
+{
+	for (uint16_t page = bAdd / EEPROM_PAGE_SIZE; page <= (bAdd + len - 1) / EEPROM_PAGE_SIZE; page++)
+		dirty_pages |= (uint32_t)1 << page;
+}
+
+static bool eeprom_range_dirty(uint16_t bAdd, uint16_t len)
+{
+	for (uint16_t page = bAdd / EEPROM_PAGE_SIZE; page <= (bAdd + len - 1) / EEPROM_PAGE_SIZE; page++)
+		if (dirty_pages & ((uint32_t)1 << page))
+			return true;
+
+	return false;
+}
+
+static void read_device(uint16_t bAdd, uint8_t *pData, uint16_t len)
+{
+	pthread_mutex_lock(&device_mutex);
+	backend->read_range(bAdd, pData, len);
+	pthread_mutex_unlock(&device_mutex);
+}
+
+// Refresh a range of the cache from the EEPROM
+static void fetch_eeprom_block(uint16_t bAdd, uint16_t len)
+{
+	read_device(bAdd, &cached_settings[bAdd], len);
+}
+
+// Load every section a range of the cache touches, including its crc bytes
+static void prefetch_range(uint16_t bAdd, uint16_t len)
+{
+	for (uint8_t section = 0; section < SETTINGS_SECTION_COUNT; section++)
+	{
+		if (settings_loaded_sections & (1 << section))
+			continue;
+
+		bool data = (bAdd < map_section_end[section]) && (bAdd + len > map_section_start[section]);
+		bool crc = (bAdd < map_section_crc_byte1[section] + EE_SIZE_SECTION_CRC) && (bAdd + len > map_section_crc_byte1[section]);
+		if (data || crc)
+			settings_prefetch((SETTINGS_SECTION)section);
+	}
+}
+
+void read_eeprom_block(uint16_t bAdd, uint8_t *pData, uint16_t len)
+{
+	prefetch_range(bAdd, len);
+
+	pthread_mutex_lock(&settings_mutex);
+
+	// Uncommitted data in the cache is newer than the EEPROM, and a trusted
+	// shadow replaces the read entirely. Async writes may still be in
+	// flight, so the cache is authoritative in async mode too.
+	if (!eeprom_range_dirty(bAdd, len) && !(shadow_trusted && shadow_valid)
+		&& (storage == SETTINGS_STORAGE_DIRECT) && (write_mode != SETTINGS_WRITE_ASYNC))
+		fetch_eeprom_block(bAdd, len);
+
+	memcpy(pData, &cached_settings[bAdd], len);
+
+	pthread_mutex_unlock(&settings_mutex);
+}
+
+/********************************************************************************
+*                                Wear accounting
+*
+* RAM estimate of the program cycles each 32 byte device page has taken since
+* boot or the last settings_reset_wear(), plus how often each field actually
+* changed. Counting in RAM keeps the accounting itself from wearing the part.
+*
+********************************************************************************/
+#ifndef SETTINGS_WEAR_TRACKED_SIZE
+#define SETTINGS_WEAR_TRACKED_SIZE 0x2000 // 64 kbit EEPROM
+#endif
+#define WEAR_PAGE_COUNT (SETTINGS_WEAR_TRACKED_SIZE / EEPROM_PAGE_SIZE)
+#define WEAR_FIELD_COUNT SETTINGS_FIELD_COUNT
+#define WEAR_DEFAULT_ENDURANCE 1000000
+#define WEAR_REPORT_TOP 5
+
+static uint32_t wear_page_writes[WEAR_PAGE_COUNT];
+static uint32_t wear_field_writes[WEAR_FIELD_COUNT];
+static uint32_t wear_total_writes = 0;
+
+// Count the program cycles of one range write, called with device_mutex held
+static void wear_account(uint16_t bAdd, uint16_t len)
+{
+	// Byte handlers program each byte as its own cycle
+	bool byte_writes = (backend == &handler_backend) && !write_block;
+
+	for (uint16_t page = bAdd / EEPROM_PAGE_SIZE; page <= (bAdd + len - 1) / EEPROM_PAGE_SIZE; page++)
+	{
+		uint32_t cycles = 1;
+
+		if (byte_writes)
+		{
+			uint16_t start = (page * EEPROM_PAGE_SIZE > bAdd) ? page * EEPROM_PAGE_SIZE : bAdd;
+			uint16_t end = ((page + 1) * EEPROM_PAGE_SIZE < bAdd + len) ? (page + 1) * EEPROM_PAGE_SIZE : bAdd + len;
+			cycles = end - start;
+		}
+
+		if (page < WEAR_PAGE_COUNT)
+			wear_page_writes[page] += cycles;
+		wear_total_writes += cycles;
+	}
+}
+
+static void write_device(uint16_t bAdd, const uint8_t *pData, uint16_t len)
+{
+	uint16_t page_size = backend->caps.page_size;
+
+	pthread_mutex_lock(&device_mutex);
+
+	// Never let a range write cross a backend page boundary
+	while (len > 0)
+	{
+		uint16_t chunk = page_size ? page_size - (bAdd % page_size) : len;
+		if (chunk > len)
+			chunk = len;
+
+		backend->write_range(bAdd, pData, chunk);
+		wear_account(bAdd, chunk);
+
+		bAdd += chunk;
+		pData += chunk;
+		len -= chunk;
+	}
+
+	pthread_mutex_unlock(&device_mutex);
+}
+
+// Make every completed write durable, for backends that buffer writes
+static void sync_device(void)
+{
+	if (!backend->sync)
+		return;
+
+	pthread_mutex_lock(&device_mutex);
+	backend->sync();
+	pthread_mutex_unlock(&device_mutex);
+}
+
+// Program a range of the cache into the EEPROM, widened to the backend write
+// granularity. An erase-before-write backend erases and rewrites whole pages.
+static void flush_eeprom_block(uint16_t bAdd, uint16_t len)
+{
+	uint32_t align = backend->erase ? backend->caps.page_size : backend->caps.write_granularity;
+	uint32_t end = (uint32_t)bAdd + len;
+
+	if (align > 1)
+	{
+		bAdd -= bAdd % align;
+		end = ((end + align - 1) / align) * align;
+	}
+
+	if (backend->erase)
+	{
+		pthread_mutex_lock(&device_mutex);
+		backend->erase(bAdd, (uint16_t)(end - bAdd));
+		pthread_mutex_unlock(&device_mutex);
+	}
+
+	if (end > EEPROM_MAP_SIZE)
+		end = EEPROM_MAP_SIZE;
+
+	write_device(bAdd, &cached_settings[bAdd], (uint16_t)(end - bAdd));
+}
+
+static uint8_t crc8(const uint8_t *pData, uint16_t len)
+{
+	uint8_t crc = 0;
+
+	for (uint16_t i = 0; i < len; i++)
+	{
+		crc ^= pData[i];
+		for (uint8_t bit = 0; bit < 8; bit++)
+			crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+	}
+
+	return crc;
+}
+
+static uint16_t crc16_update(uint16_t crc, const uint8_t *pData, uint16_t len)
+{
+	for (uint16_t i = 0; i < len; i++)
+	{
+		crc ^= (uint16_t)pData[i] << 8;
+		for (uint8_t bit = 0; bit < 8; bit++)
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+	}
+
+	return crc;
+}
+
+static uint16_t crc16(const uint8_t *pData, uint16_t len)
+{
+	return crc16_update(0xFFFF, pData, len);
+}
+
+// The cache is carried over to the storage being switched to, so finish
+// loading the sections lazy loading has not fetched yet
+static void storage_take_image(void)
+{
+	if (!lazy_fetch)
+		return;
+
+	for (uint8_t section = 0; section < SETTINGS_SECTION_COUNT; section++)
+		settings_prefetch((SETTINGS_SECTION)section);
+	lazy_fetch = false;
+}
+
+/********************************************************************************
+*                                Journal storage
+*
+* Every persisted range is appended as one or more records to a circular log.
+* A compaction pass re-appends the whole image in checkpoint records, after
+* which everything older than the pass can be overwritten. load_settings()
+* rebuilds the image by replaying the log in sequence order.
+*
+********************************************************************************/
+static uint16_t journal_slot_address(uint32_t seq)
+{
+	return journal_base_address + (uint16_t)((seq % journal_records) * JOURNAL_RECORD_SIZE);
+}
+
+static void journal_write_record(const uint8_t *image, uint16_t bAdd, uint8_t len, uint8_t flags)
+{
+	uint8_t record[JOURNAL_RECORD_SIZE];
+	uint32_t seq = journal_head;
+
+	memset(record, 0xFF, JOURNAL_RECORD_SIZE);
+	record[JOURNAL_OFFSET_FLAGS] = len | flags;
+	record[JOURNAL_OFFSET_ADDRESS] = (uint8_t)bAdd;
+	record[JOURNAL_OFFSET_ADDRESS + 1] = (uint8_t)(bAdd >> 8);
+	for (uint8_t i = 0; i < 4; i++)
+		record[JOURNAL_OFFSET_SEQ + i] = (uint8_t)(seq >> (8 * i));
+	memcpy(&record[JOURNAL_OFFSET_DATA], &image[bAdd], len);
+	record[JOURNAL_OFFSET_CRC] = crc8(&record[JOURNAL_OFFSET_FLAGS], JOURNAL_RECORD_SIZE - 1);
+
+	write_device(journal_slot_address(seq), record, JOURNAL_RECORD_SIZE);
+	journal_head++;
+}
+
+// Read a record back, returns false if the slot does not hold a valid record for seq
+static bool journal_read_record(uint32_t seq, uint8_t *record)
+{
+	read_device(journal_slot_address(seq), record, JOURNAL_RECORD_SIZE);
+
+	if (crc8(&record[JOURNAL_OFFSET_FLAGS], JOURNAL_RECORD_SIZE - 1) != record[JOURNAL_OFFSET_CRC])
+		return false;
+
+	uint32_t record_seq = 0;
+	for (uint8_t i = 0; i < 4; i++)
+		record_seq |= (uint32_t)record[JOURNAL_OFFSET_SEQ + i] << (8 * i);
+
+	uint16_t bAdd = record[JOURNAL_OFFSET_ADDRESS] | (record[JOURNAL_OFFSET_ADDRESS + 1] << 8);
+	uint8_t len = record[JOURNAL_OFFSET_FLAGS] & JOURNAL_LEN_MASK;
+
+	return (record_seq == seq) && (len <= JOURNAL_DATA_SIZE) && (bAdd + len <= EEPROM_MAP_SIZE);
+}
+
+static uint16_t journal_record_count(uint16_t len)
+{
+	return (len + JOURNAL_DATA_SIZE - 1) / JOURNAL_DATA_SIZE;
+}
+
+// Records still needed by the current or next compaction pass
+static uint32_t journal_pass_remaining(void)
+{
+	return JOURNAL_CHECKPOINT_RECORDS - (journal_pass_active ? journal_pass_next : 0);
+}
+
+// Append one checkpoint chunk of the image
+static void journal_pass_step(void)
+{
+	if (!journal_pass_active)
+	{
+		journal_pass_active = true;
+		journal_pass_start = journal_head;
+		journal_pass_next = 0;
+	}
+
+	uint16_t bAdd = journal_pass_next * JOURNAL_DATA_SIZE;
+	uint16_t len = JOURNAL_DATA_SIZE;
+	if (bAdd + len > EEPROM_MAP_SIZE)
+		len = EEPROM_MAP_SIZE - bAdd;
+
+	journal_write_record(journal_image, bAdd, (uint8_t)len, JOURNAL_FLAG_CHECKPOINT);
+
+	// A finished pass holds the whole image, older records are no longer needed
+	if (++journal_pass_next >= JOURNAL_CHECKPOINT_RECORDS)
+	{
+		journal_pass_active = false;
+		journal_base = journal_pass_start;
+	}
+}
+
+// Make room for count records without ever overwriting the records the image still depends on
+static void journal_reserve(uint32_t count)
+{
+	while (journal_head + count + journal_pass_remaining() > journal_base + journal_records)
+	{
+		do
+			journal_pass_step();
+		while (journal_pass_active);
+	}
+}
+
+// Append the cached range [bAdd, bAdd + len) to an update, first and close mark its ends.
+// journal_reserve() runs before an update, so no checkpoint falls inside one
+// and the committed image can take each range as it is appended.
+static void journal_append(uint16_t bAdd, uint16_t len, bool first, bool close)
+{
+	memcpy(&journal_image[bAdd], &cached_settings[bAdd], len);
+
+	while (len > 0)
+	{
+		uint8_t chunk = (len > JOURNAL_DATA_SIZE) ? JOURNAL_DATA_SIZE : (uint8_t)len;
+		uint8_t flags = 0;
+		len -= chunk;
+
+		if (first)
+			flags |= JOURNAL_FLAG_FIRST;
+		if (len || !close)
+			flags |= JOURNAL_FLAG_OPEN;
+
+		journal_write_record(cached_settings, bAdd, chunk, flags);
+		bAdd += chunk;
+		first = false;
+	}
+}
+
+// Apply the records of one complete update
+static void journal_apply(uint32_t first, uint32_t last)
+{
+	uint8_t record[JOURNAL_RECORD_SIZE];
+
+	for (uint32_t seq = first; seq <= last; seq++)
+	{
+		journal_read_record(seq, record);
+
+		uint16_t bAdd = record[JOURNAL_OFFSET_ADDRESS] | (record[JOURNAL_OFFSET_ADDRESS + 1] << 8);
+		memcpy(&cached_settings[bAdd], &record[JOURNAL_OFFSET_DATA], record[JOURNAL_OFFSET_FLAGS] & JOURNAL_LEN_MASK);
+	}
+}
+
+// Find the newest valid record, returns false if the log holds none
+static bool journal_find_newest(uint32_t *newest)
+{
+	uint8_t record[JOURNAL_RECORD_SIZE];
+	bool found = false;
+
+	for (uint32_t slot = 0; slot < journal_records; slot++)
+	{
+		read_device(journal_base_address + (uint16_t)(slot * JOURNAL_RECORD_SIZE), record, JOURNAL_RECORD_SIZE);
+		if (crc8(&record[JOURNAL_OFFSET_FLAGS], JOURNAL_RECORD_SIZE - 1) != record[JOURNAL_OFFSET_CRC])
+			continue;
+
+		uint32_t seq = 0;
+		for (uint8_t i = 0; i < 4; i++)
+			seq |= (uint32_t)record[JOURNAL_OFFSET_SEQ + i] << (8 * i);
+
+		if ((seq % journal_records == slot) && (!found || seq > *newest))
+		{
+			*newest = seq;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+// Rebuild the cache from the log
+static void journal_replay(void)
+{
+	uint8_t record[JOURNAL_RECORD_SIZE];
+	uint32_t newest = 0;
+
+	memset(cached_settings, 0xFF, EEPROM_MAP_SIZE);
+
+	bool found = journal_find_newest(&newest);
+
+	journal_pass_active = false;
+	journal_head = found ? newest + 1 : 0;
+	journal_base = (journal_head > journal_records) ? journal_head - journal_records : 0;
+
+	if (!found)
+	{
+		memcpy(journal_image, cached_settings, EEPROM_MAP_SIZE);
+		return;
+	}
+
+	// Replay the window oldest first, applying each update only once it is complete
+	bool in_update = false;
+	uint32_t update_start = 0;
+	bool in_pass = false;
+	uint32_t pass_start = 0;
+	uint16_t pass_next = 0;
+
+	for (uint32_t seq = journal_base; seq < journal_head; seq++)
+	{
+		if (!journal_read_record(seq, record))
+		{
+			in_update = false; // Torn or stale slot, drop the partial update
+			continue;
+		}
+
+		uint8_t flags = record[JOURNAL_OFFSET_FLAGS];
+		uint16_t bAdd = record[JOURNAL_OFFSET_ADDRESS] | (record[JOURNAL_OFFSET_ADDRESS + 1] << 8);
+
+		if (flags & JOURNAL_FLAG_CHECKPOINT)
+		{
+			in_update = false;
+			memcpy(&cached_settings[bAdd], &record[JOURNAL_OFFSET_DATA], flags & JOURNAL_LEN_MASK);
+
+			// Track the newest complete pass so compaction resumes where it left off
+			if (bAdd == 0)
+			{
+				in_pass = true;
+				pass_start = seq;
+				pass_next = 0;
+			}
+			if (in_pass && (bAdd == pass_next * JOURNAL_DATA_SIZE))
+			{
+				if (++pass_next >= JOURNAL_CHECKPOINT_RECORDS)
+				{
+					journal_base = pass_start;
+					in_pass = false;
+				}
+			}
+			else
+				in_pass = false;
+			continue;
+		}
+
+		// A new update abandons any earlier one that never closed
+		if (flags & JOURNAL_FLAG_FIRST)
+		{
+			in_update = true;
+			update_start = seq;
+		}
+
+		if (in_update && !(flags & JOURNAL_FLAG_OPEN))
+		{
+			journal_apply(update_start, seq);
+			in_update = false;
+		}
+	}
+
+	memcpy(journal_image, cached_settings, EEPROM_MAP_SIZE);
+}
+
+// Storage switched to the journal after load_settings(), continue after the
+// newest record already in the log and checkpoint the cache as the whole image
+static void journal_seed(void)
+{
+	uint32_t newest = 0;
+
+	journal_head = journal_find_newest(&newest) ? newest + 1 : 0;
+	journal_base = journal_head;
+	journal_pass_active = false;
+	memcpy(journal_image, cached_settings, EEPROM_MAP_SIZE);
+
+	do
+		journal_pass_step();
+	while (journal_pass_active);
+}
+
+// Records are programmed in place, so the backend must not need an erase
+static bool journal_backend_supported(const SETTINGS_BACKEND *candidate)
+{
+	return !candidate->erase && !(JOURNAL_RECORD_SIZE % candidate->caps.write_granularity);
+}
+
+bool settings_set_journal_storage(uint16_t base_address, uint16_t size)
+{
+	if ((base_address % JOURNAL_RECORD_SIZE) || (size / JOURNAL_RECORD_SIZE < JOURNAL_MIN_RECORDS))
+		return false;
+	if (!journal_backend_supported(backend))
+		return false;
+
+	settings_commit();
+	storage_take_image();
+
+	pthread_mutex_lock(&settings_mutex);
+	journal_base_address = base_address;
+	journal_records = size / JOURNAL_RECORD_SIZE;
+	storage = SETTINGS_STORAGE_JOURNAL;
+	shadow_valid = false;
+	if (image_loaded)
+		journal_seed();
+	pthread_mutex_unlock(&settings_mutex);
+
+	return true;
+}
+
+void settings_set_direct_storage(void)
+{
+	settings_commit();
+
+	storage = SETTINGS_STORAGE_DIRECT;
+	shadow_valid = false;
+}
+
+SETTINGS_STORAGE settings_get_storage(void)
+{
+	return storage;
+}
+
+bool settings_journal_compact(void)
+{
+	pthread_mutex_lock(&settings_mutex);
+
+	// Nothing to do until half of the log holds superseded records
+	if ((storage != SETTINGS_STORAGE_JOURNAL)
+		|| (!journal_pass_active && (journal_head - journal_base < journal_records / 2)))
+	{
+		pthread_mutex_unlock(&settings_mutex);
+		return false;
+	}
+
+	// Checkpoints copy the committed image, so pages still dirty in
+	// write-back mode stay out of the log
+	journal_reserve(1);
+	journal_pass_step();
+
+	bool pending = journal_pass_active;
+	pthread_mutex_unlock(&settings_mutex);
+
+	return pending;
+}
+
+/********************************************************************************
+*                                 A/B storage
+*
+* Two slots each hold a header and a complete image. A commit writes the image
+* to the inactive slot first and then its header with the next sequence
+* number, so the switch is a single header write. load_settings() picks the
+* newest slot whose header and image crc are both valid.
+*
+********************************************************************************/
+static uint32_t crc32(uint32_t crc, const uint8_t *pData, uint16_t len)
+{
+	crc = ~crc;
+
+	for (uint16_t i = 0; i < len; i++)
+	{
+		crc ^= pData[i];
+		for (uint8_t bit = 0; bit < 8; bit++)
+			crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : (crc >> 1);
+	}
+
+	return ~crc;
+}
+
+// Read a slot header, returns false unless it is intact
+static bool ab_read_header(uint8_t slot, uint32_t *seq, uint32_t *crc)
+{
+	uint8_t header[AB_HEADER_SIZE];
+
+	read_device(ab_slot_address[slot], header, AB_HEADER_SIZE);
+
+	if (crc8(header, AB_OFFSET_HEADER_CRC) != header[AB_OFFSET_HEADER_CRC])
+		return false;
+	if ((header[AB_OFFSET_MAGIC] | (header[AB_OFFSET_MAGIC + 1] << 8)) != AB_MAGIC)
+		return false;
+
+	*seq = 0;
+	*crc = 0;
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		*seq |= (uint32_t)header[AB_OFFSET_SEQ + i] << (8 * i);
+		*crc |= (uint32_t)header[AB_OFFSET_CRC + i] << (8 * i);
+	}
+
+	return true;
+}
+
+// Load the newest valid slot into the cache
+static void ab_select(void)
+{
+	uint32_t seq[2];
+	uint32_t crc[2];
+	bool valid[2];
+
+	for (uint8_t slot = 0; slot < 2; slot++)
+		valid[slot] = ab_read_header(slot, &seq[slot], &crc[slot]);
+
+	// Try the newest header first, fall back to the other slot if its image is torn
+	uint8_t order[2] = {0, 1};
+	if (valid[1] && (!valid[0] || (seq[1] > seq[0])))
+	{
+		order[0] = 1;
+		order[1] = 0;
+	}
+
+	for (uint8_t i = 0; i < 2; i++)
+	{
+		uint8_t slot = order[i];
+		if (!valid[slot])
+			continue;
+
+		read_device(ab_slot_address[slot] + EEPROM_PAGE_SIZE, cached_settings, EEPROM_MAP_SIZE);
+		if (crc32(0, cached_settings, EEPROM_MAP_SIZE) != crc[slot])
+			continue;
+
+		ab_active = slot;
+		ab_seq = seq[slot];
+		ab_stale_pages = 0xFFFFFFFF; // Contents of the other slot are unknown
+		return;
+	}
+
+	// Blank part, the first commit goes to slot A
+	memset(cached_settings, 0xFF, EEPROM_MAP_SIZE);
+	ab_active = 1;
+	ab_seq = 0;
+	ab_stale_pages = 0xFFFFFFFF;
+}
+
+static void ab_commit(void);
+
+// Storage switched to A/B after load_settings(), publish the cache as an image
+// newer than anything the slots already hold
+static void ab_seed(void)
+{
+	uint32_t seq;
+	uint32_t crc;
+
+	ab_active = 1;
+	ab_seq = 0;
+	for (uint8_t slot = 0; slot < 2; slot++)
+	{
+		if (ab_read_header(slot, &seq, &crc) && (seq > ab_seq))
+		{
+			ab_active = slot;
+			ab_seq = seq;
+		}
+	}
+
+	ab_stale_pages = 0xFFFFFFFF;
+	ab_commit();
+	ab_stale_pages = 0xFFFFFFFF; // The other slot never held this image
+}
+
+// Publish the cache as the next image
+static void ab_commit(void)
+{
+	uint8_t header[AB_HEADER_SIZE];
+	uint8_t slot = ab_active ^ 1;
+	uint32_t seq = ab_seq + 1;
+	uint32_t crc = crc32(0, cached_settings, EEPROM_MAP_SIZE);
+
+	// Bring the inactive slot up to date, only pages that changed since it was written
+	uint32_t pages = ab_stale_pages | dirty_pages;
+	for (uint16_t page = 0; page < EEPROM_PAGE_COUNT; page++)
+	{
+		if (!(pages & ((uint32_t)1 << page)))
+			continue;
+
+		uint16_t bAdd = page * EEPROM_PAGE_SIZE;
+		uint16_t len = EEPROM_PAGE_SIZE;
+		if (bAdd + len > EEPROM_MAP_SIZE)
+			len = EEPROM_MAP_SIZE - bAdd;
+
+		write_device(ab_slot_address[slot] + EEPROM_PAGE_SIZE + bAdd, &cached_settings[bAdd], len);
+	}
+
+	// The header write is the switch-over
+	header[AB_OFFSET_MAGIC] = (uint8_t)AB_MAGIC;
+	header[AB_OFFSET_MAGIC + 1] = (uint8_t)(AB_MAGIC >> 8);
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		header[AB_OFFSET_SEQ + i] = (uint8_t)(seq >> (8 * i));
+		header[AB_OFFSET_CRC + i] = (uint8_t)(crc >> (8 * i));
+	}
+	header[AB_OFFSET_HEADER_CRC] = crc8(header, AB_OFFSET_HEADER_CRC);
+	write_device(ab_slot_address[slot], header, AB_HEADER_SIZE);
+
+	// The old slot now misses exactly the pages changed by this commit
+	ab_stale_pages = dirty_pages;
+	dirty_pages = 0;
+	ab_active = slot;
+	ab_seq = seq;
+}
+
+// Slot headers are programmed in place and are not granule sized
+static bool ab_backend_supported(const SETTINGS_BACKEND *candidate)
+{
+	return !candidate->erase && (candidate->caps.write_granularity == 1);
+}
+
+bool settings_set_ab_storage(uint16_t slot_a, uint16_t slot_b)
+{
+	if ((slot_a % EEPROM_PAGE_SIZE) || (slot_b % EEPROM_PAGE_SIZE))
+		return false;
+	if (!ab_backend_supported(backend))
+		return false;
+	if ((slot_a < slot_b) ? (slot_b - slot_a < AB_SLOT_SIZE) : (slot_a - slot_b < AB_SLOT_SIZE))
+		return false;
+
+	settings_commit();
+	storage_take_image();
+
+	pthread_mutex_lock(&settings_mutex);
+	ab_slot_address[0] = slot_a;
+	ab_slot_address[1] = slot_b;
+	storage = SETTINGS_STORAGE_AB;
+	shadow_valid = false;
+	if (image_loaded)
+		ab_seed();
+	pthread_mutex_unlock(&settings_mutex);
+
+	return true;
+}
+
+// Changed ranges of one write, the last run holds the section crc bytes
+#define EEPROM_RUN_MAX 8
+
+typedef struct
+{
+	uint16_t bAdd;
+	uint16_t len;
+} eeprom_run;
+
+static void wear_account_fields(const eeprom_run *runs, uint8_t count);
+static void packed_store(const eeprom_run *runs, uint8_t count);
+static void packed_load(void);
+static void packed_seed(void);
+static uint16_t packed_image_size(void);
+
+// Packed fields share bytes and are programmed in place
+static bool packed_backend_supported(const SETTINGS_BACKEND *candidate)
+{
+	return !candidate->erase && (candidate->caps.write_granularity == 1);
+}
+
+bool settings_set_packed_storage(uint16_t base_address)
+{
+	if (base_address % EEPROM_PAGE_SIZE)
+		return false;
+	if (!packed_backend_supported(backend))
+		return false;
+
+	settings_commit();
+	storage_take_image();
+
+	pthread_mutex_lock(&settings_mutex);
+	packed_base_address = base_address;
+	packed_size = packed_image_size();
+	packed_formatted = false;
+	storage = SETTINGS_STORAGE_PACKED;
+	shadow_valid = false;
+	if (image_loaded)
+		packed_seed();
+	pthread_mutex_unlock(&settings_mutex);
+
+	return true;
+}
+
+/********************************************************************************
+*                                  Intent log
+*
+* Direct storage programs every field in place, so a brown-out part way through
+* an update can leave a torn value behind. With an intent log the new bytes of
+* an update are first written to the log and published by a header write, then
+* programmed in place, and finally the header is cleared. load_settings()
+* reapplies an update that was published but never cleared, while an update
+* whose log or header is torn never touched the image. Updates larger than the
+* log are programmed without it.
+*
+********************************************************************************/
+// Entries and headers are programmed in place and are not granule sized
+static bool intent_backend_supported(const SETTINGS_BACKEND *candidate)
+{
+	return !candidate->erase && (candidate->caps.write_granularity == 1);
+}
+
+static void intent_write_header(uint16_t len, uint16_t crc)
+{
+	uint8_t header[INTENT_HEADER_SIZE];
+
+	memset(header, 0xFF, INTENT_HEADER_SIZE);
+	header[INTENT_OFFSET_MAGIC] = (uint8_t)INTENT_MAGIC;
+	header[INTENT_OFFSET_MAGIC + 1] = (uint8_t)(INTENT_MAGIC >> 8);
+	header[INTENT_OFFSET_LEN] = (uint8_t)len;
+	header[INTENT_OFFSET_LEN + 1] = (uint8_t)(len >> 8);
+	header[INTENT_OFFSET_CRC] = (uint8_t)crc;
+	header[INTENT_OFFSET_CRC + 1] = (uint8_t)(crc >> 8);
+	header[INTENT_OFFSET_HEADER_CRC] = crc8(header, INTENT_OFFSET_HEADER_CRC);
+
+	write_device(intent_base_address, header, INTENT_HEADER_SIZE);
+}
+
+static void intent_clear(void)
+{
+	uint8_t header[INTENT_HEADER_SIZE];
+
+	memset(header, 0xFF, INTENT_HEADER_SIZE);
+	write_device(intent_base_address, header, INTENT_HEADER_SIZE);
+}
+
+// Log the cached bytes of an update and publish them, returns false if the update is not logged
+static bool intent_begin(const eeprom_run *runs, uint8_t count)
+{
+	uint32_t len = 0;
+
+	if (!intent_size)
+		return false;
+
+	for (uint8_t i = 0; i < count; i++)
+		len += INTENT_ENTRY_HEADER_SIZE + runs[i].len;
+	if (len > (uint32_t)(intent_size - INTENT_HEADER_SIZE))
+		return false;
+
+	uint16_t bAdd = intent_base_address + INTENT_HEADER_SIZE;
+	uint16_t crc = 0xFFFF;
+
+	for (uint8_t i = 0; i < count; i++)
+	{
+		uint8_t entry[INTENT_ENTRY_HEADER_SIZE] = {
+			(uint8_t)runs[i].bAdd, (uint8_t)(runs[i].bAdd >> 8),
+			(uint8_t)runs[i].len, (uint8_t)(runs[i].len >> 8)
+		};
+
+		write_device(bAdd, entry, INTENT_ENTRY_HEADER_SIZE);
+		write_device(bAdd + INTENT_ENTRY_HEADER_SIZE, &cached_settings[runs[i].bAdd], runs[i].len);
+		crc = crc16_update(crc, entry, INTENT_ENTRY_HEADER_SIZE);
+		crc = crc16_update(crc, &cached_settings[runs[i].bAdd], runs[i].len);
+		bAdd += INTENT_ENTRY_HEADER_SIZE + runs[i].len;
+	}
+
+	// The entries must be durable before the header publishes them
+	sync_device();
+	intent_write_header((uint16_t)len, crc);
+	sync_device();
+
+	return true;
+}
+
+// Retire a logged update once it is programmed in place. Replaying it again
+// is harmless, so the clear itself needs no sync of its own.
+static void intent_end(void)
+{
+	sync_device();
+	intent_clear();
+}
+
+// Reapply a published update that was never retired, then clear the log
+static void intent_recover(void)
+{
+	uint8_t header[INTENT_HEADER_SIZE];
+	uint8_t chunk[EEPROM_PAGE_SIZE];
+
+	if (!intent_size)
+		return;
+
+	pthread_mutex_lock(&settings_mutex);
+
+	read_device(intent_base_address, header, INTENT_HEADER_SIZE);
+
+	uint16_t magic = header[INTENT_OFFSET_MAGIC] | (header[INTENT_OFFSET_MAGIC + 1] << 8);
+	uint16_t len = header[INTENT_OFFSET_LEN] | (header[INTENT_OFFSET_LEN + 1] << 8);
+	uint16_t crc = header[INTENT_OFFSET_CRC] | (header[INTENT_OFFSET_CRC + 1] << 8);
+
+	// A cleared log has nothing pending
+	if ((magic == 0xFFFF) && (len == 0xFFFF))
+	{
+		pthread_mutex_unlock(&settings_mutex);
+		return;
+	}
+
+	bool valid = (magic == INTENT_MAGIC)
+		&& (crc8(header, INTENT_OFFSET_HEADER_CRC) == header[INTENT_OFFSET_HEADER_CRC])
+		&& (len <= intent_size - INTENT_HEADER_SIZE);
+
+	// Check the whole payload before the image is touched
+	uint16_t bAdd = intent_base_address + INTENT_HEADER_SIZE;
+	uint16_t check = 0xFFFF;
+	for (uint16_t offset = 0; valid && (offset < len); offset += EEPROM_PAGE_SIZE)
+	{
+		uint16_t chunk_len = (len - offset < EEPROM_PAGE_SIZE) ? len - offset : EEPROM_PAGE_SIZE;
+		read_device(bAdd + offset, chunk, chunk_len);
+		check = crc16_update(check, chunk, chunk_len);
+	}
+
+	if (valid && (check == crc))
+	{
+		uint16_t offset = 0;
+
+		while (offset + INTENT_ENTRY_HEADER_SIZE <= len)
+		{
+			read_device(bAdd + offset, chunk, INTENT_ENTRY_HEADER_SIZE);
+			uint16_t address = chunk[0] | (chunk[1] << 8);
+			uint16_t remaining = chunk[2] | (chunk[3] << 8);
+			offset += INTENT_ENTRY_HEADER_SIZE;
+
+			if ((address + remaining > EEPROM_MAP_SIZE) || (offset + remaining > len))
+				break;
+
+			while (remaining > 0)
+			{
+				uint16_t chunk_len = (remaining < EEPROM_PAGE_SIZE) ? remaining : EEPROM_PAGE_SIZE;
+				read_device(bAdd + offset, chunk, chunk_len);
+				write_device(address, chunk, chunk_len);
+				address += chunk_len;
+				offset += chunk_len;
+				remaining -= chunk_len;
+			}
+		}
+		sync_device();
+	}
+
+	intent_clear();
+	sync_device();
+
+	pthread_mutex_unlock(&settings_mutex);
+}
+
+bool settings_set_intent_log(uint16_t base_address, uint16_t size)
+{
+	if (size && ((size < INTENT_MIN_SIZE) || (base_address < EEPROM_MAP_SIZE) || ((uint32_t)base_address + size > 0x10000)))
+		return false;
+	if (size && !intent_backend_supported(backend))
+		return false;
+
+	settings_commit();
+
+	pthread_mutex_lock(&settings_mutex);
+	intent_base_address = base_address;
+	intent_size = size;
+	pthread_mutex_unlock(&settings_mutex);
+
+	return true;
+}
+
+// Persist the changed runs of the cache as one update
+static void store_eeprom_runs(const eeprom_run *runs, uint8_t count)
+{
+	// Data and crc form one update so a torn write never pairs new data with an old crc
+	if (storage == SETTINGS_STORAGE_JOURNAL)
+	{
+		uint32_t records = 0;
+		for (uint8_t i = 0; i < count; i++)
+			records += journal_record_count(runs[i].len);
+
+		journal_reserve(records);
+		for (uint8_t i = 0; i < count; i++)
+			journal_append(runs[i].bAdd, runs[i].len, i == 0, i == count - 1);
+		return;
+	}
+
+	// Every A/B update publishes a complete image
+	if (storage == SETTINGS_STORAGE_AB)
+	{
+		for (uint8_t i = 0; i < count; i++)
+			mark_eeprom_dirty(runs[i].bAdd, runs[i].len);
+		ab_commit();
+		return;
+	}
+
+	if (storage == SETTINGS_STORAGE_PACKED)
+	{
+		packed_store(runs, count);
+		return;
+	}
+
+	// An erase-before-write backend rewrites every run with one erase
+	if (backend->erase)
+	{
+		uint16_t start = runs[0].bAdd;
+		uint16_t end = runs[0].bAdd + runs[0].len;
+		for (uint8_t i = 1; i < count; i++)
+		{
+			if (runs[i].bAdd < start)
+				start = runs[i].bAdd;
+			if (runs[i].bAdd + runs[i].len > end)
+				end = runs[i].bAdd + runs[i].len;
+		}
+		flush_eeprom_block(start, end - start);
+		return;
+	}
+
+	bool logged = intent_begin(runs, count);
+
+	for (uint8_t i = 0; i < count; i++)
+		flush_eeprom_block(runs[i].bAdd, runs[i].len);
+
+	if (logged)
+		intent_end();
+}
+
+// Split a write into the runs that differ from the cache. Runs in the same
+// page merge into one page write unless the device is programmed byte by byte.
+static uint8_t diff_eeprom_block(uint16_t bAdd, const uint8_t *pData, uint16_t len, eeprom_run *runs)
+{
+	bool byte_writes = (backend == &handler_backend) && !write_block;
+	uint8_t count = 0;
+	uint16_t i = 0;
+
+	while (i < len)
+	{
+		if (cached_settings[bAdd + i] == pData[i])
+		{
+			i++;
+			continue;
+		}
+
+		uint16_t start = i;
+		while ((i < len) && (cached_settings[bAdd + i] != pData[i]))
+			i++;
+
+		eeprom_run *prev = count ? &runs[count - 1] : NULL;
+		if (prev && ((count == EEPROM_RUN_MAX - 1)
+			|| (!byte_writes && (prev->bAdd / EEPROM_PAGE_SIZE == (bAdd + start) / EEPROM_PAGE_SIZE))))
+		{
+			prev->len = bAdd + i - prev->bAdd;
+			continue;
+		}
+
+		runs[count].bAdd = bAdd + start;
+		runs[count].len = i - start;
+		count++;
+	}
+
+	return count;
+}
+
+// Recompute the crc of every section overlapping a changed range, returns the crc bytes that changed
+static void refresh_section_crcs(uint16_t bAdd, uint16_t len, uint16_t *crcAdd, uint16_t *crcLen)
+{
+	uint16_t first = EEPROM_MAP_SIZE;
+	uint16_t last = 0;
+
+	for (uint8_t section = 0; section < SETTINGS_SECTION_COUNT; section++)
+	{
+		if ((bAdd >= map_section_end[section]) || (bAdd + len <= map_section_start[section]))
+			continue;
+
+		uint16_t crc = crc16(&cached_settings[map_section_start[section]], map_section_end[section] - map_section_start[section]);
+		uint16_t crc_byte1 = map_section_crc_byte1[section];
+
+		if ((cached_settings[crc_byte1] == (uint8_t)(crc >> 8)) && (cached_settings[crc_byte1 + 1] == (uint8_t)crc))
+			continue;
+
+		cached_settings[crc_byte1] = (uint8_t)(crc >> 8);
+		cached_settings[crc_byte1 + 1] = (uint8_t)crc;
+
+		if (crc_byte1 < first)
+			first = crc_byte1;
+		if (crc_byte1 + EE_SIZE_SECTION_CRC > last)
+			last = crc_byte1 + EE_SIZE_SECTION_CRC;
+	}
+
+	*crcAdd = first;
+	*crcLen = (last > first) ? last - first : 0;
+}
+
+static void decode_section(SETTINGS_SECTION section);
+static void sanitize_section(SETTINGS_SECTION section);
+static void check_section(SETTINGS_SECTION section);
+
+// Compare one committed page of the shadow against the EEPROM, returns true on
+// a mismatch. Called with settings_mutex held.
+static bool verify_shadow_page(uint16_t page)
+{
+	uint8_t bytes[EEPROM_PAGE_SIZE];
+	uint16_t bAdd = page * EEPROM_PAGE_SIZE;
+	uint16_t len = EEPROM_PAGE_SIZE;
+	if (bAdd + len > EEPROM_MAP_SIZE)
+		len = EEPROM_MAP_SIZE - bAdd;
+
+	// Pending write-back data is expected to differ, and journal or A/B storage has no fixed image to compare
+	if (eeprom_range_dirty(bAdd, len) || (storage != SETTINGS_STORAGE_DIRECT))
+		return false;
+
+	read_device(bAdd, bytes, len);
+	if (memcmp(bytes, &cached_settings[bAdd], len) == 0)
+		return false;
+
+	// The EEPROM is authoritative for committed pages. Every loaded section the
+	// page touches is decoded and checked again, so RAM follows the refreshed
+	// cache and a page that fails its crc is repaired like at load.
+	memcpy(&cached_settings[bAdd], bytes, len);
+
+	for (uint8_t section = 0; section < SETTINGS_SECTION_COUNT; section++)
+	{
+		if (!(settings_loaded_sections & (1 << section)))
+			continue;
+
+		bool data = (bAdd < map_section_end[section]) && (bAdd + len > map_section_start[section]);
+		bool crc = (bAdd < map_section_crc_byte1[section] + EE_SIZE_SECTION_CRC) && (bAdd + len > map_section_crc_byte1[section]);
+		if (!data && !crc)
+			continue;
+
+		decode_section((SETTINGS_SECTION)section);
+		sanitize_section((SETTINGS_SECTION)section);
+		check_section((SETTINGS_SECTION)section);
+	}
+
+	return true;
+}
+
+// Copy the bytes of a write that differ into the cache and refresh the section
+// crcs, called with settings_mutex held. Returns the runs to program.
+static uint8_t cache_eeprom_block(uint16_t bAdd, const uint8_t *pData, uint16_t len, eeprom_run *runs)
+{
+	uint16_t crcAdd;
+	uint16_t crcLen;
+
+	// Only the bytes that differ from the cache are programmed
+	uint8_t count = diff_eeprom_block(bAdd, pData, len, runs);
+	if (!count)
+		return 0;
+
+	for (uint8_t i = 0; i < count; i++)
+	{
+		uint16_t offset = runs[i].bAdd - bAdd;
+		memcpy(&cached_settings[runs[i].bAdd], &pData[offset], runs[i].len); // cache the data
+	}
+	wear_account_fields(runs, count);
+
+	refresh_section_crcs(runs[0].bAdd, runs[count - 1].bAdd + runs[count - 1].len - runs[0].bAdd, &crcAdd, &crcLen);
+	if (crcLen)
+	{
+		runs[count].bAdd = crcAdd;
+		runs[count].len = crcLen;
+		count++;
+	}
+
+	return count;
+}
+
+void write_eeprom_block(uint16_t bAdd, const uint8_t *pData, uint16_t len)
+{
+	eeprom_run runs[EEPROM_RUN_MAX];
+
+	prefetch_range(bAdd, len);
+
+	pthread_mutex_lock(&settings_mutex);
+
+	uint8_t count = cache_eeprom_block(bAdd, pData, len, runs);
+	if (!count)
+	{
+		pthread_mutex_unlock(&settings_mutex);
+		return;
+	}
+
+	// Defer the EEPROM write until settings_commit() or the async worker
+	if (write_mode != SETTINGS_WRITE_THROUGH)
+	{
+		for (uint8_t i = 0; i < count; i++)
+			mark_eeprom_dirty(runs[i].bAdd, runs[i].len);
+		if (write_mode == SETTINGS_WRITE_ASYNC)
+			pthread_cond_signal(&async_work);
+	}
+	else
+	{
+		store_eeprom_runs(runs, count);
+		sync_device();
+	}
+
+	// Spread the periodic shadow check over the writes, one page at a time
+	if (shadow_trusted && shadow_verify_interval && (++shadow_writes >= shadow_verify_interval))
+	{
+		shadow_writes = 0;
+		verify_shadow_page(shadow_verify_page);
+		shadow_verify_page = (shadow_verify_page + 1) % EEPROM_PAGE_COUNT;
+	}
+
+	pthread_mutex_unlock(&settings_mutex);
+}
+
+void settings_set_shadow_mode(bool trusted, uint16_t verify_interval)
+{
+	shadow_trusted = trusted;
+	shadow_verify_interval = verify_interval;
+	shadow_writes = 0;
+}
+
+uint16_t settings_verify_shadow(void)
+{
+	uint16_t mismatches = 0;
+
+	pthread_mutex_lock(&settings_mutex);
+	for (uint16_t page = 0; page < EEPROM_PAGE_COUNT; page++)
+		if (verify_shadow_page(page))
+			mismatches++;
+	pthread_mutex_unlock(&settings_mutex);
+
+	return mismatches;
+}
+
+// Program every dirty page through the active storage engine
+static void program_dirty_pages(void)
+{
+	if (storage == SETTINGS_STORAGE_AB)
+	{
+		if (dirty_pages)
+			ab_commit();
+		return;
+	}
+
+	// The journal appends every dirty page as one update
+	if (storage == SETTINGS_STORAGE_JOURNAL)
+	{
+		uint32_t count = 0;
+		uint16_t last = 0;
+
+		for (uint16_t page = 0; page < EEPROM_PAGE_COUNT; page++)
+		{
+			if (dirty_pages & ((uint32_t)1 << page))
+			{
+				count += journal_record_count(EEPROM_PAGE_SIZE);
+				last = page;
+			}
+		}
+
+		if (!count)
+			return;
+
+		journal_reserve(count);
+
+		bool first = true;
+		for (uint16_t page = 0; page <= last; page++)
+		{
+			if (!(dirty_pages & ((uint32_t)1 << page)))
+				continue;
+
+			uint16_t bAdd = page * EEPROM_PAGE_SIZE;
+			uint16_t len = EEPROM_PAGE_SIZE;
+			if (bAdd + len > EEPROM_MAP_SIZE)
+				len = EEPROM_MAP_SIZE - bAdd;
+
+			journal_append(bAdd, len, first, page == last);
+			dirty_pages &= ~((uint32_t)1 << page);
+			first = false;
+		}
+		return;
+	}
+
+	// Program each run of dirty pages as one range, write_device() splits it
+	// at the backend page size. Erase-before-write backends take the whole
+	// dirty span so an erase page is only rewritten once.
+	eeprom_run spans[EEPROM_PAGE_COUNT];
+	uint8_t count = 0;
+
+	for (uint16_t page = 0; page < EEPROM_PAGE_COUNT; page++)
+	{
+		if (!(dirty_pages & ((uint32_t)1 << page)))
+			continue;
+
+		uint16_t last = page;
+		while ((last + 1 < EEPROM_PAGE_COUNT) && (backend->erase ? (dirty_pages >> (last + 1)) : (dirty_pages & ((uint32_t)1 << (last + 1)))))
+			last++;
+
+		uint16_t bAdd = page * EEPROM_PAGE_SIZE;
+		uint16_t len = (last + 1) * EEPROM_PAGE_SIZE - bAdd;
+		if (bAdd + len > EEPROM_MAP_SIZE)
+			len = EEPROM_MAP_SIZE - bAdd;
+
+		spans[count].bAdd = bAdd;
+		spans[count].len = len;
+		count++;
+		dirty_pages &= ~((((uint32_t)2 << last) - 1) & ~(((uint32_t)1 << page) - 1));
+		page = last;
+	}
+
+	if (storage == SETTINGS_STORAGE_PACKED)
+	{
+		if (count)
+			packed_store(spans, count);
+		return;
+	}
+
+	// The whole commit goes through the intent log when it fits
+	bool logged = count && intent_begin(spans, count);
+
+	for (uint8_t i = 0; i < count; i++)
+		flush_eeprom_block(spans[i].bAdd, spans[i].len);
+
+	if (logged)
+		intent_end();
+}
+
+// Commit and sync the dirty pages, called with settings_mutex held
+static void commit_dirty_pages(void)
+{
+	if (!dirty_pages)
+		return;
+
+	program_dirty_pages();
+	sync_device();
+}
+
+// Commit pages staged in the cache the way the write mode commits a set,
+// called with settings_mutex held. Write-back leaves them for settings_commit().
+static void commit_staged_pages(void)
+{
+	if (write_mode == SETTINGS_WRITE_THROUGH)
+		commit_dirty_pages();
+	else if ((write_mode == SETTINGS_WRITE_ASYNC) && dirty_pages)
+		pthread_cond_signal(&async_work);
+}
+
+/********************************************************************************
+*                                Async persistence
+*
+* In async mode a persisted set only updates the cache and marks its pages
+* dirty. The worker thread programs one page at a time from a snapshot taken
+* under the lock, so setters never wait for an EEPROM write cycle. Journal and
+* A/B commits read the cache throughout and run as one locked commit instead.
+*
+********************************************************************************/
+static void *async_worker(void *arg)
+{
+	uint8_t page_data[EEPROM_PAGE_SIZE];
+
+	(void)arg;
+
+	pthread_mutex_lock(&settings_mutex);
+	for (;;)
+	{
+		if ((write_mode != SETTINGS_WRITE_ASYNC) || !dirty_pages)
+		{
+			// Sync once the queue drains rather than after every page
+			if (async_unsynced)
+			{
+				async_unsynced = false;
+				pthread_mutex_unlock(&settings_mutex);
+				sync_device();
+				pthread_mutex_lock(&settings_mutex);
+				continue;
+			}
+
+			async_busy = false;
+			pthread_cond_broadcast(&async_idle);
+			pthread_cond_wait(&async_work, &settings_mutex);
+			continue;
+		}
+
+		async_busy = true;
+
+		// Journal, A/B and packed engines, erase-before-write backends and
+		// updates logged through the intent log commit as a whole
+		if ((storage != SETTINGS_STORAGE_DIRECT) || backend->erase || intent_size)
+		{
+			commit_dirty_pages();
+			continue;
+		}
+
+		uint16_t page = (uint16_t)__builtin_ctz(dirty_pages);
+		uint16_t bAdd = page * EEPROM_PAGE_SIZE;
+		uint16_t len = EEPROM_PAGE_SIZE;
+		if (bAdd + len > EEPROM_MAP_SIZE)
+			len = EEPROM_MAP_SIZE - bAdd;
+
+		// A set landing during the write marks the page dirty again
+		memcpy(page_data, &cached_settings[bAdd], len);
+		dirty_pages &= ~((uint32_t)1 << page);
+
+		async_unsynced = true;
+
+		pthread_mutex_unlock(&settings_mutex);
+		write_device(bAdd, page_data, len);
+		pthread_mutex_lock(&settings_mutex);
+	}
+
+	return NULL;
+}
+
+// Wait for the worker to drain the queue, called with settings_mutex held
+static void async_wait_idle(void)
+{
+	pthread_cond_signal(&async_work);
+	while (dirty_pages || async_busy)
+		pthread_cond_wait(&async_idle, &settings_mutex);
+}
+
+// Commit the pages an import staged before it returns, whatever the write mode,
+// called with settings_mutex held
+static void commit_imported_pages(void)
+{
+	if (write_mode == SETTINGS_WRITE_ASYNC)
+		async_wait_idle();
+	else
+		commit_dirty_pages();
+}
+
+void settings_set_write_mode(SETTINGS_WRITE_MODE mode)
+{
+	pthread_mutex_lock(&settings_mutex);
+
+	if ((mode == SETTINGS_WRITE_ASYNC) && !async_started)
+	{
+		if (pthread_create(&async_thread, NULL, async_worker, NULL) != 0)
+		{
+			pthread_mutex_unlock(&settings_mutex);
+			return; // Keep the current mode without a worker
+		}
+		async_started = true;
+	}
+
+	// Leaving write-back or async mode must not strand uncommitted pages
+	if (write_mode == SETTINGS_WRITE_ASYNC)
+		async_wait_idle();
+	if (mode == SETTINGS_WRITE_THROUGH)
+		commit_dirty_pages();
+
+	write_mode = mode;
+
+	// Hand pages staged in write-back mode to the worker
+	if ((mode == SETTINGS_WRITE_ASYNC) && dirty_pages)
+		pthread_cond_signal(&async_work);
+
+	pthread_mutex_unlock(&settings_mutex);
+}
+
+SETTINGS_WRITE_MODE settings_get_write_mode(void)
+{
+	return write_mode;
+}
+
+void settings_commit(void)
+{
+	pthread_mutex_lock(&settings_mutex);
+	if (write_mode == SETTINGS_WRITE_ASYNC)
+		async_wait_idle();
+	else
+		commit_dirty_pages();
+	pthread_mutex_unlock(&settings_mutex);
+}
+
+void settings_flush(void)
+{
+	pthread_mutex_lock(&settings_mutex);
+	if (write_mode == SETTINGS_WRITE_ASYNC)
+		async_wait_idle();
+	pthread_mutex_unlock(&settings_mutex);
+}
+
+bool settings_set_backend(const SETTINGS_BACKEND *new_backend)
+{
+	if (!new_backend)
+		new_backend = &handler_backend;
+
+	if (!new_backend->read_range || !new_backend->write_range)
+		return false;
+
+	// Every range the cache programs must be a whole number of granules
+	uint16_t granularity = new_backend->caps.write_granularity;
+	if (!granularity || (EEPROM_PAGE_SIZE % granularity) || (EEPROM_MAP_SIZE % granularity))
+		return false;
+	if (new_backend->caps.page_size % granularity)
+		return false;
+	if (new_backend->erase && !new_backend->caps.page_size)
+		return false;
+
+	if ((storage == SETTINGS_STORAGE_JOURNAL) && !journal_backend_supported(new_backend))
+		return false;
+	if ((storage == SETTINGS_STORAGE_AB) && !ab_backend_supported(new_backend))
+		return false;
+	if ((storage == SETTINGS_STORAGE_PACKED) && !packed_backend_supported(new_backend))
+		return false;
+	if (intent_size && !intent_backend_supported(new_backend))
+		return false;
+
+	if (new_backend->open && !new_backend->open())
+		return false;
+
+	// Pending pages belong to the old backend
+	settings_commit();
+
+	pthread_mutex_lock(&settings_mutex);
+	pthread_mutex_lock(&device_mutex);
+	backend = new_backend;
+	shadow_valid = false;
+	pthread_mutex_unlock(&device_mutex);
+	pthread_mutex_unlock(&settings_mutex);
+
+	return true;
+}
+
+const SETTINGS_BACKEND *settings_get_backend(void)
+{
+	return backend;
+}
+
+uint8_t get_eeprom_byte(uint16_t bAdd)
+{
+	prefetch_range(bAdd, 1);
+	return cached_settings[bAdd];
+}
+
+/********************************************************************************
+*                                Field codec
+*
+* Stored scalars are big-endian, the host byte order is resolved at compile
+* time so each conversion is a plain load plus at most one byte swap. Strings
+* are stored in forward order and move as a single block.
+*
+********************************************************************************/
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define CODEC_BE16(x) (x)
+#define CODEC_BE32(x) (x)
+#else
+#define CODEC_BE16(x) __builtin_bswap16(x)
+#define CODEC_BE32(x) __builtin_bswap32(x)
+#endif
+
+static inline uint16_t decode_u16(const uint8_t *raw)
+{
+    uint16_t value;
+    memcpy(&value, raw, sizeof(value));
+    return CODEC_BE16(value);
+}
+
+static inline uint32_t decode_u32(const uint8_t *raw)
+{
+    uint32_t value;
+    memcpy(&value, raw, sizeof(value));
+    return CODEC_BE32(value);
+}
+
+static inline float decode_float(const uint8_t *raw)
+{
+    uint32_t bits = decode_u32(raw);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline void encode_u16(uint8_t *raw, uint16_t value)
+{
+    value = CODEC_BE16(value);
+    memcpy(raw, &value, sizeof(value));
+}
+
+static inline void encode_u32(uint8_t *raw, uint32_t value)
+{
+    value = CODEC_BE32(value);
+    memcpy(raw, &value, sizeof(value));
+}
+
+static inline void encode_float(uint8_t *raw, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    encode_u32(raw, bits);
+}
+
+// Decode a stored scalar of 1, 2 or 4 bytes into a settings element of 1, 2 or
+// 4 bytes, enums take their value rather than their first byte
+static void decode_scalar(uint8_t *dest, uint16_t dest_size, const uint8_t *raw, uint16_t size)
+{
+    uint32_t value = (size == 4) ? decode_u32(raw) : (size == 2) ? decode_u16(raw) : raw[0];
+
+    if (dest_size == 4)
+    {
+        memcpy(dest, &value, sizeof(value));
+    }
+    else if (dest_size == 2)
+    {
+        uint16_t value16 = (uint16_t)value;
+        memcpy(dest, &value16, sizeof(value16));
+    }
+    else
+    {
+        *dest = (uint8_t)value;
+    }
+}
+
+// Encode a settings element of 1, 2 or 4 bytes into a stored scalar of 1, 2 or 4 bytes
+static void encode_scalar(uint8_t *raw, uint16_t size, const uint8_t *src, uint16_t src_size)
+{
+    uint32_t value;
+
+    if (src_size == 4)
+    {
+        memcpy(&value, src, sizeof(value));
+    }
+    else if (src_size == 2)
+    {
+        uint16_t value16;
+        memcpy(&value16, src, sizeof(value16));
+        value = value16;
+    }
+    else
+    {
+        value = *src;
+    }
+
+    if (size == 4)
+        encode_u32(raw, value);
+    else if (size == 2)
+        encode_u16(raw, (uint16_t)value);
+    else
+        raw[0] = (uint8_t)value;
+}
+
+/********************************************************************************
+*                                Section crc
+*
+* load_settings() checks the crc16 of every section once. A stored crc of 0xFFFF
+* is a blank or pre-crc image, its crc is written and the values are range
+* checked as before. A mismatch resets only that section to its defaults.
+*
+********************************************************************************/
+// Staging area for default images, a section is built here and written as one block
+static uint8_t default_image[EEPROM_MAP_SIZE];
+
+static void encode_section(SETTINGS_SECTION section, uint8_t *image);
+
+// Set the RAM values of a section to their defaults
+static void default_values(SETTINGS_SECTION section)
+{
+    switch (section)
+    {
+    case SETTINGS_SECTION_VIEW:
+        for( uint8_t idx = 0; idx < MAX_VIEWS; idx++ )
+            settings_view_enable[idx] = DEFAULT_VIEW_ENABLE;
+
+        for( uint8_t idx = 0; idx < MAX_GAUGES_PER_VIEW; idx++ )
+            settings_view_num_gauges[idx] = DEFAULT_VIEW_NUM_GAUGES;
+
+        for( uint8_t idx = 0; idx < MAX_VIEWS; idx++ )
+            settings_view_background[idx] = DEFAULT_VIEW_BACKGROUND;
+
+        for( uint8_t idx = 0; idx < MAX_VIEWS; idx++ )
+            settings_view_background_color[idx] = DEFAULT_VIEW_BACKGROUND_COLOR;
+
+        for( uint8_t idx = 0; idx < MAX_VIEWS; idx++ )
+            settings_view_background_type[idx] = DEFAULT_VIEW_BACKGROUND_TYPE;
+
+        for( uint8_t idx_view = 0; idx_view < MAX_VIEWS; idx_view++ )
+            for( uint8_t idx_gauge = 0; idx_gauge < MAX_GAUGES_PER_VIEW; idx_gauge++ )
+                settings_view_gauge_theme[idx_view][idx_gauge] = DEFAULT_VIEW_GAUGE_THEME;
+
+        for( uint8_t idx_view = 0; idx_view < MAX_VIEWS; idx_view++ )
+            for( uint8_t idx_gauge = 0; idx_gauge < MAX_GAUGES_PER_VIEW; idx_gauge++ )
+                settings_view_gauge_pid[idx_view][idx_gauge] = DEFAULT_VIEW_GAUGE_PID;
+
+        for( uint8_t idx_view = 0; idx_view < MAX_VIEWS; idx_view++ )
+            for( uint8_t idx_gauge = 0; idx_gauge < MAX_GAUGES_PER_VIEW; idx_gauge++ )
+                settings_view_gauge_units[idx_view][idx_gauge] = DEFAULT_VIEW_GAUGE_UNITS;
+
+        break;
+
+    case SETTINGS_SECTION_ALERT:
+        for( uint8_t idx = 0; idx < MAX_ALERTS; idx++ )
+            settings_alert_enable[idx] = DEFAULT_ALERT_ENABLE;
+
+        for( uint8_t idx = 0; idx < MAX_ALERTS; idx++ )
+            settings_alert_pid[idx] = DEFAULT_ALERT_PID;
+
+        for( uint8_t idx = 0; idx < MAX_ALERTS; idx++ )
+            settings_alert_units[idx] = DEFAULT_ALERT_UNITS;
+
+        for( uint8_t idx = 0; idx < MAX_ALERTS; idx++ )
+            memset(settings_alert_message[idx], DEFAULT_ALERT_MESSAGE, ALERT_MESSAGE_LEN);
+
+        for( uint8_t idx = 0; idx < MAX_ALERTS; idx++ )
+            settings_alert_compare[idx] = DEFAULT_ALERT_COMPARE;
+
+        for( uint8_t idx = 0; idx < MAX_ALERTS; idx++ )
+            settings_alert_threshold[idx] = DEFAULT_ALERT_THRESHOLD;
+
+        break;
+
+    case SETTINGS_SECTION_DYNAMIC:
+        for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
+            settings_dynamic_enable[idx] = DEFAULT_DYNAMIC_ENABLE;
+
+        for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
+            settings_dynamic_priority[idx] = DEFAULT_DYNAMIC_PRIORITY;
+
+        for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
+            settings_dynamic_compare[idx] = DEFAULT_DYNAMIC_COMPARE;
+
+        for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
+            settings_dynamic_threshold[idx] = DEFAULT_DYNAMIC_THRESHOLD;
+
+        for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
+            settings_dynamic_view_index[idx] = DEFAULT_DYNAMIC_VIEW_INDEX;
+
+        for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
+            settings_dynamic_pid[idx] = DEFAULT_DYNAMIC_PID;
+
+        for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
+            settings_dynamic_units[idx] = DEFAULT_DYNAMIC_UNITS;
+
+        break;
+
+    case SETTINGS_SECTION_GENERAL:
+        for( uint8_t idx = 0; idx < MAX_GENERALS; idx++ )
+            settings_general_ee_version[idx] = DEFAULT_GENERAL_EE_VERSION;
+
+        for( uint8_t idx = 0; idx < MAX_GENERALS; idx++ )
+            settings_general_splash[idx] = DEFAULT_GENERAL_SPLASH;
+
+        for( uint8_t idx = 0; idx < MAX_GENERALS; idx++ )
+            settings_general_can_bus_mode[idx] = DEFAULT_GENERAL_CAN_BUS_MODE;
+
+        break;
+    default:
+        break;
+    }
+}
+
+// Replace an invalid value with its default and record the field. Some defaults
+// are placeholders outside the valid range (PID 0), holding one is not a fault.
+#define SANITIZE(field, value, verify, fallback) do { if (!verify(value) && ((value) != (fallback))) { value = fallback; settings_field_faults |= (uint32_t)1 << (field); } } while (0)
+#define FIELD_MASK(first, last) ((((uint32_t)2 << (last)) - 1) & ~(((uint32_t)1 << (first)) - 1))
+
+// Range check every value of a section as it enters RAM, called with
+// settings_mutex held. Getters return the values without checking them again.
+static void sanitize_section(SETTINGS_SECTION section)
+{
+    switch (section)
+    {
+    case SETTINGS_SECTION_VIEW:
+        settings_field_faults &= ~FIELD_MASK(SETTINGS_FIELD_VIEW_ENABLE, SETTINGS_FIELD_VIEW_GAUGE_UNITS);
+
+        for( uint8_t idx = 0; idx < MAX_VIEWS; idx++ )
+            SANITIZE(SETTINGS_FIELD_VIEW_ENABLE, settings_view_enable[idx], verify_view_enable, DEFAULT_VIEW_ENABLE);
+
+        for( uint8_t idx = 0; idx < MAX_GAUGES_PER_VIEW; idx++ )
+            SANITIZE(SETTINGS_FIELD_VIEW_NUM_GAUGES, settings_view_num_gauges[idx], verify_view_num_gauges, DEFAULT_VIEW_NUM_GAUGES);
+
+        for( uint8_t idx = 0; idx < MAX_VIEWS; idx++ )
+            SANITIZE(SETTINGS_FIELD_VIEW_BACKGROUND, settings_view_background[idx], verify_view_background, DEFAULT_VIEW_BACKGROUND);
+
+        for( uint8_t idx = 0; idx < MAX_VIEWS; idx++ )
+            SANITIZE(SETTINGS_FIELD_VIEW_BACKGROUND_COLOR, settings_view_background_color[idx], verify_view_background_color, DEFAULT_VIEW_BACKGROUND_COLOR);
+
+        for( uint8_t idx = 0; idx < MAX_VIEWS; idx++ )
+            SANITIZE(SETTINGS_FIELD_VIEW_BACKGROUND_TYPE, settings_view_background_type[idx], verify_view_background_type, DEFAULT_VIEW_BACKGROUND_TYPE);
+
+        for( uint8_t idx_view = 0; idx_view < MAX_VIEWS; idx_view++ )
+            for( uint8_t idx_gauge = 0; idx_gauge < MAX_GAUGES_PER_VIEW; idx_gauge++ )
+                SANITIZE(SETTINGS_FIELD_VIEW_GAUGE_THEME, settings_view_gauge_theme[idx_view][idx_gauge], verify_view_gauge_theme, DEFAULT_VIEW_GAUGE_THEME);
+
+        for( uint8_t idx_view = 0; idx_view < MAX_VIEWS; idx_view++ )
+            for( uint8_t idx_gauge = 0; idx_gauge < MAX_GAUGES_PER_VIEW; idx_gauge++ )
+                SANITIZE(SETTINGS_FIELD_VIEW_GAUGE_PID, settings_view_gauge_pid[idx_view][idx_gauge], verify_view_gauge_pid, DEFAULT_VIEW_GAUGE_PID);
+
+        for( uint8_t idx_view = 0; idx_view < MAX_VIEWS; idx_view++ )
+            for( uint8_t idx_gauge = 0; idx_gauge < MAX_GAUGES_PER_VIEW; idx_gauge++ )
+                SANITIZE(SETTINGS_FIELD_VIEW_GAUGE_UNITS, settings_view_gauge_units[idx_view][idx_gauge], verify_view_gauge_units, DEFAULT_VIEW_GAUGE_UNITS);
+
+        break;
+
+    case SETTINGS_SECTION_ALERT:
+        settings_field_faults &= ~FIELD_MASK(SETTINGS_FIELD_ALERT_ENABLE, SETTINGS_FIELD_ALERT_THRESHOLD);
+
+        for( uint8_t idx = 0; idx < MAX_ALERTS; idx++ )
+            SANITIZE(SETTINGS_FIELD_ALERT_ENABLE, settings_alert_enable[idx], verify_alert_enable, DEFAULT_ALERT_ENABLE);
+
+        for( uint8_t idx = 0; idx < MAX_ALERTS; idx++ )
+            SANITIZE(SETTINGS_FIELD_ALERT_PID, settings_alert_pid[idx], verify_alert_pid, DEFAULT_ALERT_PID);
+
+        for( uint8_t idx = 0; idx < MAX_ALERTS; idx++ )
+            SANITIZE(SETTINGS_FIELD_ALERT_UNITS, settings_alert_units[idx], verify_alert_units, DEFAULT_ALERT_UNITS);
+
+        for( uint8_t idx = 0; idx < MAX_ALERTS; idx++ )
+            if (!verify_alert_message(settings_alert_message[idx]))
+            {
+                memset(settings_alert_message[idx], DEFAULT_ALERT_MESSAGE, ALERT_MESSAGE_LEN);
+                settings_field_faults |= (uint32_t)1 << SETTINGS_FIELD_ALERT_MESSAGE;
+            }
+
+        for( uint8_t idx = 0; idx < MAX_ALERTS; idx++ )
+            SANITIZE(SETTINGS_FIELD_ALERT_COMPARE, settings_alert_compare[idx], verify_alert_compare, DEFAULT_ALERT_COMPARE);
+
+        for( uint8_t idx = 0; idx < MAX_ALERTS; idx++ )
+            SANITIZE(SETTINGS_FIELD_ALERT_THRESHOLD, settings_alert_threshold[idx], verify_alert_threshold, DEFAULT_ALERT_THRESHOLD);
+
+        break;
+
+    case SETTINGS_SECTION_DYNAMIC:
+        settings_field_faults &= ~FIELD_MASK(SETTINGS_FIELD_DYNAMIC_ENABLE, SETTINGS_FIELD_DYNAMIC_UNITS);
+
+        for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
+            SANITIZE(SETTINGS_FIELD_DYNAMIC_ENABLE, settings_dynamic_enable[idx], verify_dynamic_enable, DEFAULT_DYNAMIC_ENABLE);
+
+        for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
+            SANITIZE(SETTINGS_FIELD_DYNAMIC_PRIORITY, settings_dynamic_priority[idx], verify_dynamic_priority, DEFAULT_DYNAMIC_PRIORITY);
+
+        for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
+            SANITIZE(SETTINGS_FIELD_DYNAMIC_COMPARE, settings_dynamic_compare[idx], verify_dynamic_compare, DEFAULT_DYNAMIC_COMPARE);
+
+        for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
+            SANITIZE(SETTINGS_FIELD_DYNAMIC_THRESHOLD, settings_dynamic_threshold[idx], verify_dynamic_threshold, DEFAULT_DYNAMIC_THRESHOLD);
+
+        for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
+            SANITIZE(SETTINGS_FIELD_DYNAMIC_VIEW_INDEX, settings_dynamic_view_index[idx], verify_dynamic_view_index, DEFAULT_DYNAMIC_VIEW_INDEX);
+
+        for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
+            SANITIZE(SETTINGS_FIELD_DYNAMIC_PID, settings_dynamic_pid[idx], verify_dynamic_pid, DEFAULT_DYNAMIC_PID);
+
+        for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
+            SANITIZE(SETTINGS_FIELD_DYNAMIC_UNITS, settings_dynamic_units[idx], verify_dynamic_units, DEFAULT_DYNAMIC_UNITS);
+
+        break;
+
+    case SETTINGS_SECTION_GENERAL:
+        settings_field_faults &= ~FIELD_MASK(SETTINGS_FIELD_GENERAL_EE_VERSION, SETTINGS_FIELD_GENERAL_CAN_BUS_MODE);
+
+        for( uint8_t idx = 0; idx < MAX_GENERALS; idx++ )
+            SANITIZE(SETTINGS_FIELD_GENERAL_EE_VERSION, settings_general_ee_version[idx], verify_general_ee_version, DEFAULT_GENERAL_EE_VERSION);
+
+        for( uint8_t idx = 0; idx < MAX_GENERALS; idx++ )
+            SANITIZE(SETTINGS_FIELD_GENERAL_SPLASH, settings_general_splash[idx], verify_general_splash, DEFAULT_GENERAL_SPLASH);
+
+        for( uint8_t idx = 0; idx < MAX_GENERALS; idx++ )
+            SANITIZE(SETTINGS_FIELD_GENERAL_CAN_BUS_MODE, settings_general_can_bus_mode[idx], verify_general_can_bus_mode, DEFAULT_GENERAL_CAN_BUS_MODE);
+
+        break;
+    default:
+        break;
+    }
+}
+
+// Reset a section to its defaults in the cache, called with settings_mutex
+// held. The default image is built from the RAM values and only the bytes that
+// differ, with their crcs, are marked dirty for the caller to commit.
+static void default_section(SETTINGS_SECTION section)
+{
+    uint16_t start = map_section_start[section];
+    uint16_t len = map_section_end[section] - start;
+    eeprom_run runs[EEPROM_RUN_MAX];
+
+    default_values(section);
+    sanitize_section(section);
+    memcpy(&default_image[start], &cached_settings[start], len);
+    encode_section(section, default_image);
+
+    uint8_t count = cache_eeprom_block(start, &default_image[start], len, runs);
+    for( uint8_t i = 0; i < count; i++ )
+        mark_eeprom_dirty(runs[i].bAdd, runs[i].len);
+}
+
+// Verify a section crc as the section enters RAM, called with settings_mutex
+// held. A missing crc is added and a failing section reset to its defaults in
+// the cache. The repair is staged and committed the way the write mode commits
+// a set, so a getter in async mode never waits for the worker.
+static void check_section(SETTINGS_SECTION section)
+{
+    uint16_t start = map_section_start[section];
+    uint16_t len = map_section_end[section] - start;
+    uint16_t crc_byte1 = map_section_crc_byte1[section];
+    uint16_t stored = ((uint16_t)cached_settings[crc_byte1] << 8) | cached_settings[crc_byte1 + 1];
+    uint16_t crc = crc16(&cached_settings[start], len);
+    uint16_t crcAdd;
+    uint16_t crcLen;
+
+    settings_section_faults &= ~(1 << section);
+
+    if ((stored != crc) && (stored != 0xFFFF))
+    {
+        settings_section_faults |= (1 << section);
+        default_section(section);
+    }
+
+    // Also covers an image written before the crcs existed, and defaults that
+    // already matched the stored bytes
+    refresh_section_crcs(start, len, &crcAdd, &crcLen);
+    if (crcLen)
+        mark_eeprom_dirty(crcAdd, crcLen);
+
+    commit_staged_pages();
+}
+
+void settings_reset_defaults(uint8_t sections)
+{
+    // Load first, the lazy load takes settings_mutex itself
+    for( uint8_t section = 0; section < SETTINGS_SECTION_COUNT; section++ )
+        if (sections & (1 << section))
+            SECTION_LOAD(section);
+
+    // Stage every section and commit once so each touched page is programmed
+    // once, without touching the write mode other writers rely on
+    pthread_mutex_lock(&settings_mutex);
+    for( uint8_t section = 0; section < SETTINGS_SECTION_COUNT; section++ )
+        if (sections & (1 << section))
+            default_section((SETTINGS_SECTION)section);
+
+    commit_staged_pages();
+    pthread_mutex_unlock(&settings_mutex);
+}
+
+uint32_t settings_get_field_faults(void)
+{
+    return settings_field_faults;
+}
+
+uint8_t settings_get_section_faults(void)
+{
+    return settings_section_faults;
+}
+
+static void decode_sections(void);
+static void decode_settings(void);
+
+/********************************************************************************
+*                                Binary snapshot
+*
+* A snapshot is a 12 byte header followed by the complete memory map image:
+* magic "KESS", format version, layout version, image length and crc32 of the
+* image, multi-byte fields big-endian. Import validates the whole snapshot
+* before touching the cache, then stages the image as one bulk write.
+*
+********************************************************************************/
+#define SNAPSHOT_HEADER_SIZE 12
+#define SNAPSHOT_FORMAT 1
+#define SNAPSHOT_OFFSET_FORMAT 4
+#define SNAPSHOT_OFFSET_LAYOUT_VERSION 5
+#define SNAPSHOT_OFFSET_LENGTH 6
+#define SNAPSHOT_OFFSET_CRC 8
+
+static const uint8_t snapshot_magic[4] = {'K', 'E', 'S', 'S'};
+
+uint32_t settings_snapshot_size(void)
+{
+	return SNAPSHOT_HEADER_SIZE + EEPROM_MAP_SIZE;
+}
+
+uint32_t settings_export_snapshot(uint8_t *buffer, uint32_t buffer_size)
+{
+	if (!buffer || (buffer_size < settings_snapshot_size()))
+		return 0;
+
+	uint8_t *image = &buffer[SNAPSHOT_HEADER_SIZE];
+
+	prefetch_range(EEPROM_VIEW_ENABLE1_BYTE1, EEPROM_MAP_SIZE);
+
+	pthread_mutex_lock(&settings_mutex);
+	memcpy(image, cached_settings, EEPROM_MAP_SIZE);
+	pthread_mutex_unlock(&settings_mutex);
+
+	uint32_t crc = crc32(0, image, EEPROM_MAP_SIZE);
+
+	memcpy(buffer, snapshot_magic, sizeof(snapshot_magic));
+	buffer[SNAPSHOT_OFFSET_FORMAT] = SNAPSHOT_FORMAT;
+	buffer[SNAPSHOT_OFFSET_LAYOUT_VERSION] = image[EEPROM_LAYOUT_VERSION_BYTE1];
+	buffer[SNAPSHOT_OFFSET_LENGTH] = (uint8_t)(EEPROM_MAP_SIZE >> 8);
+	buffer[SNAPSHOT_OFFSET_LENGTH + 1] = (uint8_t)EEPROM_MAP_SIZE;
+	buffer[SNAPSHOT_OFFSET_CRC] = (uint8_t)(crc >> 24);
+	buffer[SNAPSHOT_OFFSET_CRC + 1] = (uint8_t)(crc >> 16);
+	buffer[SNAPSHOT_OFFSET_CRC + 2] = (uint8_t)(crc >> 8);
+	buffer[SNAPSHOT_OFFSET_CRC + 3] = (uint8_t)crc;
+
+	return settings_snapshot_size();
+}
+
+bool settings_import_snapshot(const uint8_t *buffer, uint32_t size)
+{
+	if (!buffer || (size != settings_snapshot_size()))
+		return false;
+
+	const uint8_t *image = &buffer[SNAPSHOT_HEADER_SIZE];
+	uint16_t length = ((uint16_t)buffer[SNAPSHOT_OFFSET_LENGTH] << 8) | buffer[SNAPSHOT_OFFSET_LENGTH + 1];
+	uint32_t crc = ((uint32_t)buffer[SNAPSHOT_OFFSET_CRC] << 24) | ((uint32_t)buffer[SNAPSHOT_OFFSET_CRC + 1] << 16)
+		| ((uint32_t)buffer[SNAPSHOT_OFFSET_CRC + 2] << 8) | buffer[SNAPSHOT_OFFSET_CRC + 3];
+
+	if (memcmp(buffer, snapshot_magic, sizeof(snapshot_magic)) != 0)
+		return false;
+	if ((buffer[SNAPSHOT_OFFSET_FORMAT] != SNAPSHOT_FORMAT) || (length != EEPROM_MAP_SIZE))
+		return false;
+	if (crc32(0, image, EEPROM_MAP_SIZE) != crc)
+		return false;
+
+	prefetch_range(EEPROM_VIEW_ENABLE1_BYTE1, EEPROM_MAP_SIZE);
+
+	// Only accept images laid out for the EEPROM version this unit runs
+	if ((buffer[SNAPSHOT_OFFSET_LAYOUT_VERSION] != image[EEPROM_LAYOUT_VERSION_BYTE1])
+		|| (buffer[SNAPSHOT_OFFSET_LAYOUT_VERSION] != cached_settings[EEPROM_LAYOUT_VERSION_BYTE1]))
+		return false;
+
+	// Stage the image under the lock so each page is programmed once, with A/B
+	// storage the commit publishes it as a single new image. The write mode is
+	// left alone, the import persists in every mode like settings_commit().
+	eeprom_run runs[EEPROM_RUN_MAX];
+
+	pthread_mutex_lock(&settings_mutex);
+
+	uint8_t count = cache_eeprom_block(EEPROM_VIEW_ENABLE1_BYTE1, image, EEPROM_MAP_SIZE, runs);
+	for (uint8_t i = 0; i < count; i++)
+		mark_eeprom_dirty(runs[i].bAdd, runs[i].len);
+	decode_sections();
+
+	commit_imported_pages();
+
+	pthread_mutex_unlock(&settings_mutex);
+
+	return true;
+}
+
+/********************************************************************************
+*                                Layout migration
+*
+* The layout version byte records the stored layout, EE_Version mirrors it for
+* the host and cannot be set to anything else. Each entry of layout_migrations
+* transforms an image of one layout version into the next, and load_settings()
+* chains them from the stored version up to EE_LAYOUT_VERSION. The transforms
+* rewrite the cached image in place and mark the ranges they change, so an
+* upgrade across any number of versions is one read of the image and one
+* commit of the changed pages. With journal or A/B storage, or an intent log
+* large enough for the commit, a power loss during the commit is finished or
+* rolled back on the next boot and the migration simply runs again.
+*
+* A section whose crc already fails is left to the section check, its crc is
+* not refreshed so it is still reset to defaults. An image whose version has
+* no migration path, such as one written by newer firmware, is left untouched.
+*
+* Firmware before layout 1 stored EE_Version 255 and never wrote the section
+* crcs or the layout byte, so on parts that were not erased those bytes hold
+* leftovers. An image whose EE_Version or layout byte reads 255 and where no
+* stored crc matches its section is taken as such a baseline image: it is
+* migrated from layout 255 and its crcs are treated as missing. Only a
+* baseline image with both replaced, an EE_Version the host changed and a
+* leftover layout byte, needs 0x1F0 to 0x1F8 erased before the upgrade.
+*
+********************************************************************************/
+#define EE_LAYOUT_VERSION DEFAULT_GENERAL_EE_VERSION
+
+typedef struct
+{
+    uint8_t from;
+    uint8_t to;
+    void (*apply)(void);
+} layout_migration;
+
+static bool section_crc_intact(SETTINGS_SECTION section)
+{
+    uint16_t crc_byte1 = map_section_crc_byte1[section];
+    uint16_t stored = ((uint16_t)cached_settings[crc_byte1] << 8) | cached_settings[crc_byte1 + 1];
+
+    return (stored == 0xFFFF)
+        || (stored == crc16(&cached_settings[map_section_start[section]], map_section_end[section] - map_section_start[section]));
+}
+
+// No stored crc matches its section, which a booted layout 1 image always has
+static bool baseline_crcs(void)
+{
+    for( uint8_t section = 0; section < SETTINGS_SECTION_COUNT; section++ )
+    {
+        uint16_t crc_byte1 = map_section_crc_byte1[section];
+        uint16_t stored = ((uint16_t)cached_settings[crc_byte1] << 8) | cached_settings[crc_byte1 + 1];
+
+        if (stored == crc16(&cached_settings[map_section_start[section]], map_section_end[section] - map_section_start[section]))
+            return false;
+    }
+
+    return true;
+}
+
+// Bring the raw range of a section into the cache without decoding it
+static void fetch_section(SETTINGS_SECTION section)
+{
+    fetch_eeprom_block(map_section_start[section], map_section_end[section] - map_section_start[section]);
+    fetch_eeprom_block(map_section_crc_byte1[section], EE_SIZE_SECTION_CRC);
+}
+
+// Layout 1 stores the alert messages in forward order, earlier images (layout
+// version 255, or blank) hold them byte-reversed
+static void migrate_forward_messages(void)
+{
+    for( uint8_t idx = 0; idx < MAX_ALERTS; idx++ )
+    {
+        uint8_t *message = &cached_settings[map_alert_message_byte1[idx]];
+
+        for( uint16_t n = 0; n < EE_SIZE_ALERT_MESSAGE / 2; n++ )
+        {
+            uint8_t byte = message[n];
+            message[n] = message[EE_SIZE_ALERT_MESSAGE - 1 - n];
+            message[EE_SIZE_ALERT_MESSAGE - 1 - n] = byte;
+        }
+
+        mark_eeprom_dirty(map_alert_message_byte1[idx], EE_SIZE_ALERT_MESSAGE);
+    }
+}
+
+static const layout_migration layout_migrations[] = {
+    {0xFF, 1, migrate_forward_messages}
+    };
+
+#define LAYOUT_MIGRATION_COUNT (sizeof(layout_migrations) / sizeof(layout_migrations[0]))
+
+// Index of the migration out of a stored version, LAYOUT_MIGRATION_COUNT if there is none
+static uint8_t find_layout_migration(uint8_t version)
+{
+    uint8_t idx = 0;
+
+    while ((idx < LAYOUT_MIGRATION_COUNT) && (layout_migrations[idx].from != version))
+        idx++;
+
+    return idx;
+}
+
+static void migrate_layout(void)
+{
+    uint16_t crcAdd;
+    uint16_t crcLen;
+
+    bool fetched = !lazy_fetch;
+    bool baseline = false;
+
+    // One read from EE_Version up to the layout byte
+    if (lazy_fetch)
+        fetch_eeprom_block(EEPROM_GENERAL_EE_VERSION1_BYTE1, EEPROM_LAYOUT_VERSION_BYTE1 + EE_SIZE_LAYOUT_VERSION - EEPROM_GENERAL_EE_VERSION1_BYTE1);
+
+    uint8_t version = cached_settings[EEPROM_LAYOUT_VERSION_BYTE1];
+
+    // The layout byte of a baseline image may be a leftover
+    if ((version == 0xFF) || (cached_settings[EEPROM_GENERAL_EE_VERSION1_BYTE1] == 0xFF))
+    {
+        if (!fetched)
+            for( uint8_t section = 0; section < SETTINGS_SECTION_COUNT; section++ )
+                fetch_section((SETTINGS_SECTION)section);
+        fetched = true;
+
+        baseline = baseline_crcs();
+        if (baseline)
+            version = 0xFF;
+    }
+
+    if (version == EE_LAYOUT_VERSION)
+        return;
+
+    // Walk the chain before touching anything so a dead end leaves the image as found
+    uint8_t steps = 0;
+    for( uint8_t step = version; step != EE_LAYOUT_VERSION; steps++ )
+    {
+        uint8_t idx = find_layout_migration(step);
+        if ((idx == LAYOUT_MIGRATION_COUNT) || (steps >= LAYOUT_MIGRATION_COUNT))
+            return;
+        step = layout_migrations[idx].to;
+    }
+
+    // Transforms work on the whole image
+    if (!fetched)
+        for( uint8_t section = 0; section < SETTINGS_SECTION_COUNT; section++ )
+            fetch_section((SETTINGS_SECTION)section);
+
+    pthread_mutex_lock(&settings_mutex);
+
+    uint8_t intact = 0;
+    for( uint8_t section = 0; section < SETTINGS_SECTION_COUNT; section++ )
+        if (baseline || section_crc_intact((SETTINGS_SECTION)section))
+            intact |= 1 << section;
+
+    while (version != EE_LAYOUT_VERSION)
+    {
+        const layout_migration *migration = &layout_migrations[find_layout_migration(version)];
+        migration->apply();
+        version = migration->to;
+    }
+
+    cached_settings[EEPROM_LAYOUT_VERSION_BYTE1] = EE_LAYOUT_VERSION;
+    mark_eeprom_dirty(EEPROM_LAYOUT_VERSION_BYTE1, EE_SIZE_LAYOUT_VERSION);
+
+    // A corrupt general section is reset to defaults, which already carry the layout version
+    if (intact & (1 << SETTINGS_SECTION_GENERAL))
+    {
+        cached_settings[EEPROM_GENERAL_EE_VERSION1_BYTE1] = EE_LAYOUT_VERSION;
+        mark_eeprom_dirty(EEPROM_GENERAL_EE_VERSION1_BYTE1, EE_SIZE_GENERAL_EE_VERSION);
+    }
+
+    for( uint8_t section = 0; section < SETTINGS_SECTION_COUNT; section++ )
+    {
+        if (!(intact & (1 << section)))
+            continue;
+
+        refresh_section_crcs(map_section_start[section], map_section_end[section] - map_section_start[section], &crcAdd, &crcLen);
+        if (crcLen)
+            mark_eeprom_dirty(crcAdd, crcLen);
+    }
+
+    commit_dirty_pages();
+
+    pthread_mutex_unlock(&settings_mutex);
+}
+
+static bool image_blank(void)
+{
+    for( uint16_t bAdd = 0; bAdd < EEPROM_MAP_SIZE; bAdd++ )
+        if (cached_settings[bAdd] != 0xFF)
+            return false;
+
+    return true;
+}
+
+void load_settings(void)
+{
+    // Let queued async writes land before the image is read back
+    settings_flush();
+
+    settings_loaded_sections = 0;
+    settings_field_faults = 0;
+    settings_section_faults = 0;
+    shadow_valid = true;
+
+    // Pull the whole memory map in with a single block read, or rebuild it from
+    // the journal, then decode from the cache. Lazy loading on direct storage
+    // leaves each section to its first access.
+    lazy_fetch = lazy_load && (storage == SETTINGS_STORAGE_DIRECT);
+    if (storage == SETTINGS_STORAGE_DIRECT)
+        intent_recover();
+
+    if (storage == SETTINGS_STORAGE_JOURNAL)
+        journal_replay();
+    else if (storage == SETTINGS_STORAGE_AB)
+        ab_select();
+    else if (storage == SETTINGS_STORAGE_PACKED)
+        packed_load();
+    else if (!lazy_fetch)
+        fetch_eeprom_block(EEPROM_VIEW_ENABLE1_BYTE1, EEPROM_MAP_SIZE);
+    image_loaded = true;
+
+    // A blank part gets the whole default image, stamped with the current
+    // layout, in one burst
+    if (!lazy_fetch && image_blank())
+    {
+        pthread_mutex_lock(&settings_mutex);
+        cached_settings[EEPROM_LAYOUT_VERSION_BYTE1] = EE_LAYOUT_VERSION;
+        mark_eeprom_dirty(EEPROM_LAYOUT_VERSION_BYTE1, EE_SIZE_LAYOUT_VERSION);
+        pthread_mutex_unlock(&settings_mutex);
+
+        settings_reset_defaults(SETTINGS_ALL_SECTIONS);
+        return;
+    }
+
+    migrate_layout();
+
+    if (!lazy_load)
+        decode_settings();
+}
+
+// Boot decode table, one entry per field: name, section, byte1 address of every
+// element, element count, stored size, the settings array with its element
+// stride and the packed bit width of an element (0 keeps every stored byte)
+typedef struct
+{
+    const char *name;
+    SETTINGS_SECTION section;
+    const uint16_t *map;
+    uint16_t count;
+    uint16_t size;
+    uint8_t *dest;
+    uint16_t stride;
+    uint8_t bits;
+} settings_field;
+
+// Bits needed for every valid value of a field plus the erased code, so pass
+// one more than the largest valid value
+#define PACKED_BITS(max) ((max) < 2 ? 1 : (max) < 4 ? 2 : (max) < 8 ? 3 : (max) < 16 ? 4 : (max) < 32 ? 5 : (max) < 64 ? 6 : (max) < 128 ? 7 : 8)
+
+static const settings_field settings_fields[] = {
+    {"view_enable", SETTINGS_SECTION_VIEW, map_view_enable_byte1, sizeof(map_view_enable_byte1) / sizeof(uint16_t), EE_SIZE_VIEW_ENABLE, (uint8_t *)settings_view_enable, sizeof(settings_view_enable) / (sizeof(map_view_enable_byte1) / sizeof(uint16_t)), PACKED_BITS(VIEW_STATE_RESERVED)},
+    {"view_num_gauges", SETTINGS_SECTION_VIEW, map_view_num_gauges_byte1, sizeof(map_view_num_gauges_byte1) / sizeof(uint16_t), EE_SIZE_VIEW_NUM_GAUGES, (uint8_t *)settings_view_num_gauges, sizeof(settings_view_num_gauges) / (sizeof(map_view_num_gauges_byte1) / sizeof(uint16_t)), PACKED_BITS(MAX_GAUGES_PER_VIEW + 1)},
+    {"view_background", SETTINGS_SECTION_VIEW, map_view_background_byte1, sizeof(map_view_background_byte1) / sizeof(uint16_t), EE_SIZE_VIEW_BACKGROUND, (uint8_t *)settings_view_background, sizeof(settings_view_background) / (sizeof(map_view_background_byte1) / sizeof(uint16_t)), PACKED_BITS(VIEW_BACKGROUND_RESERVED)},
+    {"view_background_color", SETTINGS_SECTION_VIEW, map_view_background_color_byte1, sizeof(map_view_background_color_byte1) / sizeof(uint16_t), EE_SIZE_VIEW_BACKGROUND_COLOR, (uint8_t *)settings_view_background_color, sizeof(settings_view_background_color) / (sizeof(map_view_background_color_byte1) / sizeof(uint16_t)), 25},
+    {"view_background_type", SETTINGS_SECTION_VIEW, map_view_background_type_byte1, sizeof(map_view_background_type_byte1) / sizeof(uint16_t), EE_SIZE_VIEW_BACKGROUND_TYPE, (uint8_t *)settings_view_background_type, sizeof(settings_view_background_type) / (sizeof(map_view_background_type_byte1) / sizeof(uint16_t)), PACKED_BITS(VIEW_BACKGROUND_TYPE_RESERVED)},
+    {"view_gauge_theme", SETTINGS_SECTION_VIEW, (const uint16_t *)map_view_gauge_theme_byte1, sizeof(map_view_gauge_theme_byte1) / sizeof(uint16_t), EE_SIZE_VIEW_GAUGE_THEME, (uint8_t *)settings_view_gauge_theme, sizeof(settings_view_gauge_theme) / (sizeof(map_view_gauge_theme_byte1) / sizeof(uint16_t)), PACKED_BITS(GAUGE_THEME_RESERVED)},
+    {"view_gauge_pid", SETTINGS_SECTION_VIEW, (const uint16_t *)map_view_gauge_pid_byte1, sizeof(map_view_gauge_pid_byte1) / sizeof(uint16_t), EE_SIZE_VIEW_GAUGE_PID, (uint8_t *)settings_view_gauge_pid, sizeof(settings_view_gauge_pid) / (sizeof(map_view_gauge_pid_byte1) / sizeof(uint16_t)), 25},
+    {"view_gauge_units", SETTINGS_SECTION_VIEW, (const uint16_t *)map_view_gauge_units_byte1, sizeof(map_view_gauge_units_byte1) / sizeof(uint16_t), EE_SIZE_VIEW_GAUGE_UNITS, (uint8_t *)settings_view_gauge_units, sizeof(settings_view_gauge_units) / (sizeof(map_view_gauge_units_byte1) / sizeof(uint16_t)), 8},
+    {"alert_enable", SETTINGS_SECTION_ALERT, map_alert_enable_byte1, sizeof(map_alert_enable_byte1) / sizeof(uint16_t), EE_SIZE_ALERT_ENABLE, (uint8_t *)settings_alert_enable, sizeof(settings_alert_enable) / (sizeof(map_alert_enable_byte1) / sizeof(uint16_t)), PACKED_BITS(ALERT_STATE_RESERVED)},
+    {"alert_pid", SETTINGS_SECTION_ALERT, map_alert_pid_byte1, sizeof(map_alert_pid_byte1) / sizeof(uint16_t), EE_SIZE_ALERT_PID, (uint8_t *)settings_alert_pid, sizeof(settings_alert_pid) / (sizeof(map_alert_pid_byte1) / sizeof(uint16_t)), 25},
+    {"alert_units", SETTINGS_SECTION_ALERT, map_alert_units_byte1, sizeof(map_alert_units_byte1) / sizeof(uint16_t), EE_SIZE_ALERT_UNITS, (uint8_t *)settings_alert_units, sizeof(settings_alert_units) / (sizeof(map_alert_units_byte1) / sizeof(uint16_t)), 8},
+    {"alert_message", SETTINGS_SECTION_ALERT, map_alert_message_byte1, sizeof(map_alert_message_byte1) / sizeof(uint16_t), EE_SIZE_ALERT_MESSAGE, (uint8_t *)settings_alert_message, sizeof(settings_alert_message) / (sizeof(map_alert_message_byte1) / sizeof(uint16_t)), 0},
+    {"alert_compare", SETTINGS_SECTION_ALERT, map_alert_compare_byte1, sizeof(map_alert_compare_byte1) / sizeof(uint16_t), EE_SIZE_ALERT_COMPARE, (uint8_t *)settings_alert_compare, sizeof(settings_alert_compare) / (sizeof(map_alert_compare_byte1) / sizeof(uint16_t)), PACKED_BITS(ALERT_COMPARISON_RESERVED)},
+    {"alert_threshold", SETTINGS_SECTION_ALERT, map_alert_threshold_byte1, sizeof(map_alert_threshold_byte1) / sizeof(uint16_t), EE_SIZE_ALERT_THRESHOLD, (uint8_t *)settings_alert_threshold, sizeof(settings_alert_threshold) / (sizeof(map_alert_threshold_byte1) / sizeof(uint16_t)), 0},
+    {"dynamic_enable", SETTINGS_SECTION_DYNAMIC, map_dynamic_enable_byte1, sizeof(map_dynamic_enable_byte1) / sizeof(uint16_t), EE_SIZE_DYNAMIC_ENABLE, (uint8_t *)settings_dynamic_enable, sizeof(settings_dynamic_enable) / (sizeof(map_dynamic_enable_byte1) / sizeof(uint16_t)), PACKED_BITS(DYNAMIC_STATE_RESERVED)},
+    {"dynamic_priority", SETTINGS_SECTION_DYNAMIC, map_dynamic_priority_byte1, sizeof(map_dynamic_priority_byte1) / sizeof(uint16_t), EE_SIZE_DYNAMIC_PRIORITY, (uint8_t *)settings_dynamic_priority, sizeof(settings_dynamic_priority) / (sizeof(map_dynamic_priority_byte1) / sizeof(uint16_t)), PACKED_BITS(DYNAMIC_PRIORITY_RESERVED)},
+    {"dynamic_compare", SETTINGS_SECTION_DYNAMIC, map_dynamic_compare_byte1, sizeof(map_dynamic_compare_byte1) / sizeof(uint16_t), EE_SIZE_DYNAMIC_COMPARE, (uint8_t *)settings_dynamic_compare, sizeof(settings_dynamic_compare) / (sizeof(map_dynamic_compare_byte1) / sizeof(uint16_t)), PACKED_BITS(DYNAMIC_COMPARISON_RESERVED)},
+    {"dynamic_threshold", SETTINGS_SECTION_DYNAMIC, map_dynamic_threshold_byte1, sizeof(map_dynamic_threshold_byte1) / sizeof(uint16_t), EE_SIZE_DYNAMIC_THRESHOLD, (uint8_t *)settings_dynamic_threshold, sizeof(settings_dynamic_threshold) / (sizeof(map_dynamic_threshold_byte1) / sizeof(uint16_t)), 0},
+    {"dynamic_view_index", SETTINGS_SECTION_DYNAMIC, map_dynamic_view_index_byte1, sizeof(map_dynamic_view_index_byte1) / sizeof(uint16_t), EE_SIZE_DYNAMIC_VIEW_INDEX, (uint8_t *)settings_dynamic_view_index, sizeof(settings_dynamic_view_index) / (sizeof(map_dynamic_view_index_byte1) / sizeof(uint16_t)), PACKED_BITS(MAX_VIEWS + 1)},
+    {"dynamic_pid", SETTINGS_SECTION_DYNAMIC, map_dynamic_pid_byte1, sizeof(map_dynamic_pid_byte1) / sizeof(uint16_t), EE_SIZE_DYNAMIC_PID, (uint8_t *)settings_dynamic_pid, sizeof(settings_dynamic_pid) / (sizeof(map_dynamic_pid_byte1) / sizeof(uint16_t)), 25},
+    {"dynamic_units", SETTINGS_SECTION_DYNAMIC, map_dynamic_units_byte1, sizeof(map_dynamic_units_byte1) / sizeof(uint16_t), EE_SIZE_DYNAMIC_UNITS, (uint8_t *)settings_dynamic_units, sizeof(settings_dynamic_units) / (sizeof(map_dynamic_units_byte1) / sizeof(uint16_t)), 8},
+    {"general_ee_version", SETTINGS_SECTION_GENERAL, map_general_ee_version_byte1, sizeof(map_general_ee_version_byte1) / sizeof(uint16_t), EE_SIZE_GENERAL_EE_VERSION, (uint8_t *)settings_general_ee_version, sizeof(settings_general_ee_version) / (sizeof(map_general_ee_version_byte1) / sizeof(uint16_t)), 8},
+    {"general_splash", SETTINGS_SECTION_GENERAL, map_general_splash_byte1, sizeof(map_general_splash_byte1) / sizeof(uint16_t), EE_SIZE_GENERAL_SPLASH, (uint8_t *)settings_general_splash, sizeof(settings_general_splash) / (sizeof(map_general_splash_byte1) / sizeof(uint16_t)), 16},
+    {"general_can_bus_mode", SETTINGS_SECTION_GENERAL, map_general_can_bus_mode_byte1, sizeof(map_general_can_bus_mode_byte1) / sizeof(uint16_t), EE_SIZE_GENERAL_CAN_BUS_MODE, (uint8_t *)settings_general_can_bus_mode, sizeof(settings_general_can_bus_mode) / (sizeof(map_general_can_bus_mode_byte1) / sizeof(uint16_t)), PACKED_BITS(CAN_BUS_MODE_RESERVED)}
+    };
+
+_Static_assert(sizeof(settings_fields) / sizeof(settings_fields[0]) == SETTINGS_FIELD_COUNT, "one table entry per SETTINGS_FIELD");
+
+// Decode one element of a field from an image laid out like the cache
+static void decode_element(const settings_field *f, uint16_t idx, const uint8_t *image)
+{
+    const uint8_t *raw = &image[f->map[idx]];
+    uint8_t *dest = &f->dest[idx * f->stride];
+
+    if (f->size > sizeof(uint32_t))
+        memcpy(dest, raw, f->size); // Strings are stored forward
+    else
+        decode_scalar(dest, f->stride, raw, f->size);
+}
+
+// Encode the RAM value of one element of a field into an image laid out like the cache
+static void encode_element(const settings_field *f, uint16_t idx, uint8_t *image)
+{
+    uint8_t *raw = &image[f->map[idx]];
+    const uint8_t *src = &f->dest[idx * f->stride];
+
+    if (f->size > sizeof(uint32_t))
+        memcpy(raw, src, f->size);
+    else
+        encode_scalar(raw, f->size, src, f->stride);
+}
+
+// FNV-1a over every setting value in RAM, tells whether anything changed
+// between two points without a hook in each setter
+static uint32_t settings_values_hash(void)
+{
+    uint32_t hash = 2166136261u;
+
+    for( uint8_t field = 0; field < sizeof(settings_fields) / sizeof(settings_fields[0]); field++ )
+    {
+        const settings_field *f = &settings_fields[field];
+
+        for( uint32_t i = 0; i < (uint32_t)f->count * f->stride; i++ )
+            hash = (hash ^ f->dest[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+// Count each field a write changed, called with settings_mutex held
+static void wear_account_fields(const eeprom_run *runs, uint8_t count)
+{
+    for( uint8_t field = 0; field < WEAR_FIELD_COUNT; field++ )
+    {
+        const settings_field *f = &settings_fields[field];
+        bool changed = false;
+
+        for( uint16_t idx = 0; (idx < f->count) && !changed; idx++ )
+            for( uint8_t i = 0; (i < count) && !changed; i++ )
+                changed = (runs[i].bAdd < f->map[idx] + f->size) && (runs[i].bAdd + runs[i].len > f->map[idx]);
+
+        if (changed)
+            wear_field_writes[field]++;
+    }
+}
+
+uint32_t settings_get_page_writes(uint16_t page)
+{
+    return (page < WEAR_PAGE_COUNT) ? wear_page_writes[page] : 0;
+}
+
+void settings_reset_wear(void)
+{
+    pthread_mutex_lock(&settings_mutex);
+    pthread_mutex_lock(&device_mutex);
+    memset(wear_page_writes, 0, sizeof(wear_page_writes));
+    memset(wear_field_writes, 0, sizeof(wear_field_writes));
+    wear_total_writes = 0;
+    pthread_mutex_unlock(&device_mutex);
+    pthread_mutex_unlock(&settings_mutex);
+}
+
+uint32_t wear_to_json(char *buffer, uint32_t buffer_size, uint32_t elapsed_seconds) {
+    json_writer writer;
+    uint32_t endurance = backend->caps.endurance ? backend->caps.endurance : WEAR_DEFAULT_ENDURANCE;
+    uint16_t top_pages[WEAR_REPORT_TOP];
+    uint8_t top_fields[WEAR_REPORT_TOP];
+    uint8_t num_pages = 0;
+    uint8_t num_fields = 0;
+
+    pthread_mutex_lock(&settings_mutex);
+    pthread_mutex_lock(&device_mutex);
+
+    // Keep the hottest pages and fields, sorted by insertion
+    for( uint16_t page = 0; page < WEAR_PAGE_COUNT; page++ )
+    {
+        if (!wear_page_writes[page])
+            continue;
+
+        uint8_t pos = num_pages;
+        while ((pos > 0) && (wear_page_writes[top_pages[pos - 1]] < wear_page_writes[page]))
+        {
+            if (pos < WEAR_REPORT_TOP)
+                top_pages[pos] = top_pages[pos - 1];
+            pos--;
+        }
+        if (pos < WEAR_REPORT_TOP)
+        {
+            top_pages[pos] = page;
+            if (num_pages < WEAR_REPORT_TOP)
+                num_pages++;
+        }
+    }
+
+    for( uint8_t field = 0; field < WEAR_FIELD_COUNT; field++ )
+    {
+        if (!wear_field_writes[field])
+            continue;
+
+        uint8_t pos = num_fields;
+        while ((pos > 0) && (wear_field_writes[top_fields[pos - 1]] < wear_field_writes[field]))
+        {
+            if (pos < WEAR_REPORT_TOP)
+                top_fields[pos] = top_fields[pos - 1];
+            pos--;
+        }
+        if (pos < WEAR_REPORT_TOP)
+        {
+            top_fields[pos] = field;
+            if (num_fields < WEAR_REPORT_TOP)
+                num_fields++;
+        }
+    }
+
+    uint32_t hottest = num_pages ? wear_page_writes[top_pages[0]] : 0;
+
+    json_writer_init(&writer, buffer, buffer_size);
+    json_begin_object(&writer, NULL);
+    json_add_number(&writer, "total_writes", wear_total_writes);
+    json_add_number(&writer, "endurance", endurance);
+    json_add_number(&writer, "worst_page_wear", (double)hottest * 100.0 / endurance);
+
+    json_begin_array(&writer, "pages");
+    for( uint8_t i = 0; i < num_pages; i++ )
+    {
+        json_begin_object(&writer, NULL);
+        json_add_number(&writer, "address", top_pages[i] * EEPROM_PAGE_SIZE);
+        json_add_number(&writer, "writes", wear_page_writes[top_pages[i]]);
+        json_end_object(&writer);
+    }
+    json_end_array(&writer);
+
+    json_begin_array(&writer, "fields");
+    for( uint8_t i = 0; i < num_fields; i++ )
+    {
+        json_begin_object(&writer, NULL);
+        json_add_string(&writer, "field", settings_fields[top_fields[i]].name);
+        json_add_number(&writer, "writes", wear_field_writes[top_fields[i]]);
+        json_end_object(&writer);
+    }
+    json_end_array(&writer);
+
+    pthread_mutex_unlock(&device_mutex);
+    pthread_mutex_unlock(&settings_mutex);
+
+    // Project the lifetime of the hottest page at the observed rate
+    if (elapsed_seconds && hottest)
+    {
+        double remaining = (hottest < endurance) ? (double)(endurance - hottest) : 0.0;
+        json_add_number(&writer, "projected_seconds", remaining * elapsed_seconds / hottest);
+    }
+
+    json_end_object(&writer);
+    return json_writer_finish(&writer); // 0 means the buffer was too small
+}
+
+/********************************************************************************
+*                              Incremental import
+*
+* The document is parsed as it arrives and each field is applied to the cache
+* as soon as its value is complete. The import is staged in write-back mode
+* from begin to finish, an error or abort puts the cache and the dirty pages
+* back the way they were at begin.
+*
+* A merge patch (RFC 7396) uses the same walk. Sections and gauge lists also
+* take objects keyed by element index, which merge into the stored elements,
+* while an array replaces the whole list and resets whatever it leaves out.
+* null resets the member it replaces to the defaults.
+*
+********************************************************************************/
+// Nesting the importer follows: root object, section array, section element,
+// gauge array, gauge object
+#define JSON_IMPORT_DEPTH 5
+// Member of a view element holding its gauge array
+#define JSON_IMPORT_GAUGES SETTINGS_FIELD_COUNT
+
+typedef enum
+{
+    JSON_ROLE_NONE,
+    JSON_ROLE_ROOT,
+    JSON_ROLE_SECTION,
+    JSON_ROLE_ELEMENT,
+    JSON_ROLE_GAUGES,
+    JSON_ROLE_GAUGE
+} JSON_ROLE;
+
+static const char *const json_section_keys[SETTINGS_SECTION_COUNT] = {
+    "view",
+    "alert",
+    "dynamic",
+    "general"
+};
+
+static const uint8_t json_section_count[SETTINGS_SECTION_COUNT] = {
+    MAX_VIEWS,
+    MAX_ALERTS,
+    MAX_DYNAMICS,
+    MAX_GENERALS
+};
+
+// Member name of each SETTINGS_FIELD within its section element
+static const char *const json_field_keys[SETTINGS_FIELD_COUNT] = {
+    "enable",
+    "num_gauges",
+    "background",
+    "background_color",
+    "background_type",
+    "theme",
+    "pid",
+    "units",
+    "enable",
+    "pid",
+    "units",
+    "message",
+    "compare",
+    "threshold",
+    "enable",
+    "priority",
+    "compare",
+    "threshold",
+    "view_index",
+    "pid",
+    "units",
+    "EE_Version",
+    "splash",
+    "can_bus_mode"
+};
+
+static struct
+{
+    json_reader reader;
+    bool active;
+    bool patch;
+    uint8_t depth;
+    JSON_ROLE roles[JSON_IMPORT_DEPTH];
+    uint8_t arrays;         // Bit per level, set for arrays
+    uint8_t replace;        // Bit per level, set where a patch replaces the list
+    int8_t section;
+    int8_t field;
+    int16_t index;
+    int16_t gauge;
+    // Members each open container has carried, a replacing container resets
+    // the others when it closes
+    uint8_t elements_seen;
+    uint32_t fields_seen;
+    uint8_t gauges_seen;
+    uint32_t gauge_fields_seen;
+} json_import;
+
+// Private staging of an incremental JSON import. The import only sets the RAM
+// values and encodes each element it applies into import_image, the cache and
+// the device see nothing until finish stages the marked bytes as one block.
+static uint8_t import_image[EEPROM_MAP_SIZE];
+static uint8_t import_staged[EEPROM_MAP_SIZE / 8];
+
+static bool import_byte_staged(uint16_t bAdd)
+{
+	return import_staged[bAdd / 8] & (1 << (bAdd % 8));
+}
+
+static void import_stage(uint8_t field, uint16_t idx)
+{
+	const settings_field *f = &settings_fields[field];
+
+	pthread_mutex_lock(&settings_mutex);
+	encode_element(f, idx, import_image);
+	pthread_mutex_unlock(&settings_mutex);
+
+	for (uint16_t bAdd = f->map[idx]; bAdd < f->map[idx] + f->size; bAdd++)
+		import_staged[bAdd / 8] |= 1 << (bAdd % 8);
+}
+
+// Persist the staged elements over the current cache, so sets by other tasks
+// during the import are kept
+static void import_commit(void)
+{
+	eeprom_run runs[EEPROM_RUN_MAX];
+
+	pthread_mutex_lock(&settings_mutex);
+
+	for (uint16_t bAdd = 0; bAdd < EEPROM_MAP_SIZE; bAdd++)
+		if (!import_byte_staged(bAdd))
+			import_image[bAdd] = cached_settings[bAdd];
+
+	uint8_t count = cache_eeprom_block(EEPROM_VIEW_ENABLE1_BYTE1, import_image, EEPROM_MAP_SIZE, runs);
+	for (uint8_t i = 0; i < count; i++)
+		mark_eeprom_dirty(runs[i].bAdd, runs[i].len);
+	commit_imported_pages();
+
+	pthread_mutex_unlock(&settings_mutex);
+}
+
+// Put the RAM values of every staged element back to the cache, which never
+// saw them
+static void import_restore(void)
+{
+	uint8_t sections = 0;
+
+	pthread_mutex_lock(&settings_mutex);
+
+	for (uint8_t field = 0; field < SETTINGS_FIELD_COUNT; field++)
+	{
+		const settings_field *f = &settings_fields[field];
+
+		for (uint16_t idx = 0; idx < f->count; idx++)
+		{
+			if (!import_byte_staged(f->map[idx]))
+				continue;
+
+			decode_element(f, idx, cached_settings);
+			sections |= 1 << f->section;
+		}
+	}
+
+	for (uint8_t section = 0; section < SETTINGS_SECTION_COUNT; section++)
+		if (sections & (1 << section))
+			sanitize_section((SETTINGS_SECTION)section);
+
+	pthread_mutex_unlock(&settings_mutex);
+}
+
+static bool json_gauge_field(uint8_t field) {
+    return (field >= SETTINGS_FIELD_VIEW_GAUGE_THEME) && (field <= SETTINGS_FIELD_VIEW_GAUGE_UNITS);
+}
+
+// Member keys match without case, like cJSON_GetObjectItem() did
+static int8_t json_find_field(SETTINGS_SECTION section, bool gauge, const char *key) {
+    for( uint8_t field = 0; field < SETTINGS_FIELD_COUNT; field++ )
+    {
+        if ((settings_fields[field].section == section) && (json_gauge_field(field) == gauge)
+            && (strcasecmp(json_field_keys[field], key) == 0))
+            return field;
+    }
+
+    if ((section == SETTINGS_SECTION_VIEW) && !gauge && (strcasecmp(key, "gauge") == 0))
+        return JSON_IMPORT_GAUGES;
+
+    return -1;
+}
+
+static int8_t json_find_section(const char *key) {
+    for( uint8_t section = 0; section < SETTINGS_SECTION_COUNT; section++ )
+    {
+        if (strcasecmp(json_section_keys[section], key) == 0)
+            return section;
+    }
+
+    return -1;
+}
+
+// Element index written as an object key, -1 unless it is plain decimal and in range
+static int16_t json_index_key(const char *key, uint8_t count) {
+    int16_t index = 0;
+
+    if (!*key) return -1;
+
+    for( ; *key; key++ )
+    {
+        if ((*key < '0') || (*key > '9') || (index >= count))
+            return -1;
+        index = index * 10 + (*key - '0');
+    }
+
+    return (index < count) ? index : -1;
+}
+
+// Unknown PID names come back as 0, which the setters take as a reset
+static bool json_pid_value(const char *text, uint32_t *pid) {
+    *pid = get_pid_by_string(text);
+    return *pid != 0;
+}
+
+// Apply one JSON value to a field through its setter, false when the value
+// has the wrong type or the setter refuses it. Without save only RAM changes.
+static bool json_import_value(int8_t field, uint8_t i, uint8_t j, JSON_EVENT event, const char *text, bool save) {
+    char message[ALERT_MESSAGE_LEN];
+    uint32_t pid;
+    double valuedouble = 0;
+    int valueint = 0;
+
+    if (event == JSON_EVENT_NUMBER) {
+        valuedouble = strtod(text, NULL);
+        valueint = (valuedouble >= INT_MAX) ? INT_MAX : (valuedouble <= (double)INT_MIN) ? INT_MIN : (int)valuedouble;
+    }
+    else if (event != JSON_EVENT_STRING) {
+        return false;
+    }
+
+    bool string = (event == JSON_EVENT_STRING);
+
+    switch (field)
+    {
+    case SETTINGS_FIELD_VIEW_ENABLE:
+        return string && set_view_enable(i, get_view_enable_from_string(text), save);
+    case SETTINGS_FIELD_VIEW_NUM_GAUGES:
+        return !string && set_view_num_gauges(i, valueint, save);
+    case SETTINGS_FIELD_VIEW_BACKGROUND:
+        return string && set_view_background(i, get_view_background_from_string(text), save);
+    case SETTINGS_FIELD_VIEW_BACKGROUND_COLOR:
+        return !string && set_view_background_color(i, valueint, save);
+    case SETTINGS_FIELD_VIEW_BACKGROUND_TYPE:
+        return string && set_view_background_type(i, get_view_background_type_from_string(text), save);
+    case SETTINGS_FIELD_VIEW_GAUGE_THEME:
+        return string && set_view_gauge_theme(i, j, get_view_gauge_theme_from_string(text), save);
+    case SETTINGS_FIELD_VIEW_GAUGE_PID:
+        return string && json_pid_value(text, &pid) && set_view_gauge_pid(i, j, pid, save);
+    case SETTINGS_FIELD_VIEW_GAUGE_UNITS:
+        return string && set_view_gauge_units(i, j, get_unit_by_string(text), save);
+    case SETTINGS_FIELD_ALERT_ENABLE:
+        return string && set_alert_enable(i, get_alert_enable_from_string(text), save);
+    case SETTINGS_FIELD_ALERT_PID:
+        return string && json_pid_value(text, &pid) && set_alert_pid(i, pid, save);
+    case SETTINGS_FIELD_ALERT_UNITS:
+        return string && set_alert_units(i, get_unit_by_string(text), save);
+    case SETTINGS_FIELD_ALERT_MESSAGE:
+        if (!string) return false;
+        strncpy(message, text, ALERT_MESSAGE_LEN - 1);
+        message[ALERT_MESSAGE_LEN - 1] = '\0';
+        return set_alert_message(i, message, save);
+    case SETTINGS_FIELD_ALERT_COMPARE:
+        return string && set_alert_compare(i, get_alert_compare_from_string(text), save);
+    case SETTINGS_FIELD_ALERT_THRESHOLD:
+        return !string && set_alert_threshold(i, valuedouble, save);
+    case SETTINGS_FIELD_DYNAMIC_ENABLE:
+        return string && set_dynamic_enable(i, get_dynamic_enable_from_string(text), save);
+    case SETTINGS_FIELD_DYNAMIC_PRIORITY:
+        return string && set_dynamic_priority(i, get_dynamic_priority_from_string(text), save);
+    case SETTINGS_FIELD_DYNAMIC_COMPARE:
+        return string && set_dynamic_compare(i, get_dynamic_compare_from_string(text), save);
+    case SETTINGS_FIELD_DYNAMIC_THRESHOLD:
+        return !string && set_dynamic_threshold(i, valuedouble, save);
+    case SETTINGS_FIELD_DYNAMIC_VIEW_INDEX:
+        return !string && set_dynamic_view_index(i, valueint, save);
+    case SETTINGS_FIELD_DYNAMIC_PID:
+        return string && json_pid_value(text, &pid) && set_dynamic_pid(i, pid, save);
+    case SETTINGS_FIELD_DYNAMIC_UNITS:
+        return string && set_dynamic_units(i, get_unit_by_string(text), save);
+    case SETTINGS_FIELD_GENERAL_SPLASH:
+        return !string && set_general_splash(i, valueint, save);
+    case SETTINGS_FIELD_GENERAL_CAN_BUS_MODE:
+        return string && set_general_can_bus_mode(i, get_general_can_bus_mode_from_string(text), save);
+    default:
+        // EE_Version describes the stored layout, not the configuration, so
+        // an imported file never overrides it
+        return false;
+    }
+}
+
+// Put one field back to the value default_values() gives it through its setter
+static bool json_default_value(uint8_t field, uint8_t i, uint8_t j, bool save) {
+    char message[ALERT_MESSAGE_LEN];
+
+    switch (field)
+    {
+    case SETTINGS_FIELD_VIEW_ENABLE:
+        return set_view_enable(i, DEFAULT_VIEW_ENABLE, save);
+    case SETTINGS_FIELD_VIEW_NUM_GAUGES:
+        return set_view_num_gauges(i, DEFAULT_VIEW_NUM_GAUGES, save);
+    case SETTINGS_FIELD_VIEW_BACKGROUND:
+        return set_view_background(i, DEFAULT_VIEW_BACKGROUND, save);
+    case SETTINGS_FIELD_VIEW_BACKGROUND_COLOR:
+        return set_view_background_color(i, DEFAULT_VIEW_BACKGROUND_COLOR, save);
+    case SETTINGS_FIELD_VIEW_BACKGROUND_TYPE:
+        return set_view_background_type(i, DEFAULT_VIEW_BACKGROUND_TYPE, save);
+    case SETTINGS_FIELD_VIEW_GAUGE_THEME:
+        return set_view_gauge_theme(i, j, DEFAULT_VIEW_GAUGE_THEME, save);
+    case SETTINGS_FIELD_VIEW_GAUGE_PID:
+        return set_view_gauge_pid(i, j, DEFAULT_VIEW_GAUGE_PID, save);
+    case SETTINGS_FIELD_VIEW_GAUGE_UNITS:
+        return set_view_gauge_units(i, j, DEFAULT_VIEW_GAUGE_UNITS, save);
+    case SETTINGS_FIELD_ALERT_ENABLE:
+        return set_alert_enable(i, DEFAULT_ALERT_ENABLE, save);
+    case SETTINGS_FIELD_ALERT_PID:
+        return set_alert_pid(i, DEFAULT_ALERT_PID, save);
+    case SETTINGS_FIELD_ALERT_UNITS:
+        return set_alert_units(i, DEFAULT_ALERT_UNITS, save);
+    case SETTINGS_FIELD_ALERT_MESSAGE:
+        memset(message, DEFAULT_ALERT_MESSAGE, ALERT_MESSAGE_LEN);
+        return set_alert_message(i, message, save);
+    case SETTINGS_FIELD_ALERT_COMPARE:
+        return set_alert_compare(i, DEFAULT_ALERT_COMPARE, save);
+    case SETTINGS_FIELD_ALERT_THRESHOLD:
+        return set_alert_threshold(i, DEFAULT_ALERT_THRESHOLD, save);
+    case SETTINGS_FIELD_DYNAMIC_ENABLE:
+        return set_dynamic_enable(i, DEFAULT_DYNAMIC_ENABLE, save);
+    case SETTINGS_FIELD_DYNAMIC_PRIORITY:
+        return set_dynamic_priority(i, DEFAULT_DYNAMIC_PRIORITY, save);
+    case SETTINGS_FIELD_DYNAMIC_COMPARE:
+        return set_dynamic_compare(i, DEFAULT_DYNAMIC_COMPARE, save);
+    case SETTINGS_FIELD_DYNAMIC_THRESHOLD:
+        return set_dynamic_threshold(i, DEFAULT_DYNAMIC_THRESHOLD, save);
+    case SETTINGS_FIELD_DYNAMIC_VIEW_INDEX:
+        return set_dynamic_view_index(i, DEFAULT_DYNAMIC_VIEW_INDEX, save);
+    case SETTINGS_FIELD_DYNAMIC_PID:
+        return set_dynamic_pid(i, DEFAULT_DYNAMIC_PID, save);
+    case SETTINGS_FIELD_DYNAMIC_UNITS:
+        return set_dynamic_units(i, DEFAULT_DYNAMIC_UNITS, save);
+    case SETTINGS_FIELD_GENERAL_SPLASH:
+        return set_general_splash(i, DEFAULT_GENERAL_SPLASH, save);
+    case SETTINGS_FIELD_GENERAL_CAN_BUS_MODE:
+        return set_general_can_bus_mode(i, DEFAULT_GENERAL_CAN_BUS_MODE, save);
+    default:
+        // EE_Version belongs to the stored layout and is never reset here
+        return false;
+    }
+}
+
+// Element of a field in the settings_fields table, gauges are stored per view
+static uint16_t json_field_element(uint8_t field, uint8_t i, uint8_t j) {
+    return json_gauge_field(field) ? (uint16_t)i * MAX_GAUGES_PER_VIEW + j : i;
+}
+
+// Reset one field of the import and stage it
+static void json_import_default(uint8_t field, uint8_t i, uint8_t j) {
+    if (json_default_value(field, i, j, false))
+        import_stage(field, json_field_element(field, i, j));
+}
+
+// In a patch null resets the field, anything else is applied as usual
+static void json_import_field(int8_t field, uint8_t i, uint8_t j, JSON_EVENT event, const char *text) {
+    if (json_import.patch && (event == JSON_EVENT_NULL))
+        json_import_default(field, i, j);
+    else if (json_import_value(field, i, j, event, text, false))
+        import_stage(field, json_field_element(field, i, j));
+}
+
+// Reset the gauge fields of one gauge, skipping those in the seen mask
+static void json_default_gauge(uint8_t i, uint8_t j, uint32_t seen) {
+    for( uint8_t field = SETTINGS_FIELD_VIEW_GAUGE_THEME; field <= SETTINGS_FIELD_VIEW_GAUGE_UNITS; field++ )
+    {
+        if (!(seen & ((uint32_t)1 << field)))
+            json_import_default(field, i, j);
+    }
+}
+
+// Reset one section element, skipping the members in the seen mask
+static void json_default_element(SETTINGS_SECTION section, uint8_t i, uint32_t seen) {
+    for( uint8_t field = 0; field < SETTINGS_FIELD_COUNT; field++ )
+    {
+        if ((settings_fields[field].section == section) && !json_gauge_field(field) && !(seen & ((uint32_t)1 << field)))
+            json_import_default(field, i, 0);
+    }
 
-    cJSON *list;
+    if ((section == SETTINGS_SECTION_VIEW) && !(seen & ((uint32_t)1 << JSON_IMPORT_GAUGES))) {
+        for( uint8_t j = 0; j < MAX_GAUGES_PER_VIEW; j++ )
+            json_default_gauge(i, j, 0);
+    }
+}
 
-    // Populate view_state option list
-    list = cJSON_CreateStringArray(view_state_string, VIEW_STATE_RESERVED);
-    cJSON_AddItemToObject(root, "view_state", list);
+// A replacing container resets every member it did not carry when it closes
+static void json_import_close(JSON_ROLE role) {
+    switch (role)
+    {
+    case JSON_ROLE_SECTION:
+        for( uint8_t i = 0; i < json_section_count[json_import.section]; i++ )
+        {
+            if (!(json_import.elements_seen & (1 << i)))
+                json_default_element(json_import.section, i, 0);
+        }
+        break;
+    case JSON_ROLE_ELEMENT:
+        json_default_element(json_import.section, json_import.index, json_import.fields_seen);
+        break;
+    case JSON_ROLE_GAUGES:
+        for( uint8_t j = 0; j < MAX_GAUGES_PER_VIEW; j++ )
+        {
+            if (!(json_import.gauges_seen & (1 << j)))
+                json_default_gauge(json_import.index, j, 0);
+        }
+        break;
+    case JSON_ROLE_GAUGE:
+        json_default_gauge(json_import.index, json_import.gauge, json_import.gauge_fields_seen);
+        break;
+    default:
+        break;
+    }
+}
 
-    // Populate view_background option list
-    list = cJSON_CreateStringArray(view_background_string, VIEW_BACKGROUND_RESERVED);
-    cJSON_AddItemToObject(root, "view_background", list);
+static bool json_import_event(void *context, JSON_EVENT event, const char *text, uint32_t len) {
+    (void)context;
+    (void)len;
 
-    // Populate view_background_type option list
-    list = cJSON_CreateStringArray(view_background_type_string, VIEW_BACKGROUND_TYPE_RESERVED);
-    cJSON_AddItemToObject(root, "view_background_type", list);
+    uint8_t depth = json_import.depth;
+    JSON_ROLE parent = JSON_ROLE_NONE;
+    bool in_array = false;
+    bool replace = false;
 
-    // Populate gauge_theme option list
-    list = cJSON_CreateStringArray(gauge_theme_string, GAUGE_THEME_RESERVED);
-    cJSON_AddItemToObject(root, "gauge_theme", list);
+    if ((depth > 0) && (depth <= JSON_IMPORT_DEPTH)) {
+        parent = json_import.roles[depth - 1];
+        in_array = json_import.arrays & (1 << (depth - 1));
+        replace = json_import.replace & (1 << (depth - 1));
+    }
 
-    // Populate alert_state option list
-    list = cJSON_CreateStringArray(alert_state_string, ALERT_STATE_RESERVED);
-    cJSON_AddItemToObject(root, "alert_state", list);
+    if ((event == JSON_EVENT_OBJECT_END) || (event == JSON_EVENT_ARRAY_END)) {
+        if (replace)
+            json_import_close(parent);
+        json_import.depth--;
+        return true;
+    }
 
-    // Populate alert_comparison option list
-    list = cJSON_CreateStringArray(alert_comparison_string, ALERT_COMPARISON_RESERVED);
-    cJSON_AddItemToObject(root, "alert_comparison", list);
+    if (event == JSON_EVENT_KEY) {
+        switch (parent)
+        {
+        case JSON_ROLE_ROOT:
+            json_import.section = json_find_section(text);
+            break;
+        case JSON_ROLE_SECTION:
+            json_import.index = json_index_key(text, json_section_count[json_import.section]);
+            break;
+        case JSON_ROLE_ELEMENT:
+            json_import.field = json_find_field(json_import.section, false, text);
+            if (json_import.field >= 0)
+                json_import.fields_seen |= (uint32_t)1 << json_import.field;
+            break;
+        case JSON_ROLE_GAUGES:
+            json_import.gauge = json_index_key(text, MAX_GAUGES_PER_VIEW);
+            break;
+        case JSON_ROLE_GAUGE:
+            json_import.field = json_find_field(json_import.section, true, text);
+            if (json_import.field >= 0)
+                json_import.gauge_fields_seen |= (uint32_t)1 << json_import.field;
+            break;
+        default:
+            break;
+        }
+        return true;
+    }
 
-    // Populate dynamic_state option list
-    list = cJSON_CreateStringArray(dynamic_state_string, DYNAMIC_STATE_RESERVED);
-    cJSON_AddItemToObject(root, "dynamic_state", list);
+    // Everything else starts a value, work out what it is from its parent
+    bool begin = (event == JSON_EVENT_OBJECT_BEGIN) || (event == JSON_EVENT_ARRAY_BEGIN);
+    bool reset = json_import.patch && (event == JSON_EVENT_NULL);
+    JSON_ROLE role = JSON_ROLE_NONE;
 
-    // Populate dynamic_priority option list
-    list = cJSON_CreateStringArray(dynamic_priority_string, DYNAMIC_PRIORITY_RESERVED);
-    cJSON_AddItemToObject(root, "dynamic_priority", list);
+    switch (parent)
+    {
+    case JSON_ROLE_NONE:
+        if ((depth == 0) && (event == JSON_EVENT_OBJECT_BEGIN))
+            role = JSON_ROLE_ROOT;
+        break;
+    case JSON_ROLE_ROOT:
+        if (json_import.section < 0)
+            break;
+        if (begin) {
+            role = JSON_ROLE_SECTION;
+            json_import.index = -1;
+            json_import.elements_seen = 0;
+        }
+        else if (reset) {
+            for( uint8_t i = 0; i < json_section_count[json_import.section]; i++ )
+                json_default_element(json_import.section, i, 0);
+        }
+        break;
+    case JSON_ROLE_SECTION:
+        if (in_array)
+            json_import.index++;
+        if ((json_import.index < 0) || (json_import.index >= json_section_count[json_import.section]))
+            break;
+        json_import.elements_seen |= 1 << json_import.index;
+        if (event == JSON_EVENT_OBJECT_BEGIN) {
+            role = JSON_ROLE_ELEMENT;
+            json_import.fields_seen = 0;
+        }
+        else if (reset) {
+            json_default_element(json_import.section, json_import.index, 0);
+        }
+        break;
+    case JSON_ROLE_ELEMENT:
+        if (json_import.field == JSON_IMPORT_GAUGES) {
+            if (begin) {
+                role = JSON_ROLE_GAUGES;
+                json_import.gauge = -1;
+                json_import.gauges_seen = 0;
+            }
+            else if (reset) {
+                for( uint8_t j = 0; j < MAX_GAUGES_PER_VIEW; j++ )
+                    json_default_gauge(json_import.index, j, 0);
+            }
+        }
+        else if (json_import.field >= 0) {
+            json_import_field(json_import.field, json_import.index, 0, event, text);
+        }
+        break;
+    case JSON_ROLE_GAUGES:
+        if (in_array)
+            json_import.gauge++;
+        if ((json_import.gauge < 0) || (json_import.gauge >= MAX_GAUGES_PER_VIEW))
+            break;
+        json_import.gauges_seen |= 1 << json_import.gauge;
+        if (event == JSON_EVENT_OBJECT_BEGIN) {
+            role = JSON_ROLE_GAUGE;
+            json_import.gauge_fields_seen = 0;
+        }
+        else if (reset) {
+            json_default_gauge(json_import.index, json_import.gauge, 0);
+        }
+        break;
+    case JSON_ROLE_GAUGE:
+        if (json_import.field >= 0)
+            json_import_field(json_import.field, json_import.index, json_import.gauge, event, text);
+        break;
+    }
 
-    // Populate dynamic_comparison option list
-    list = cJSON_CreateStringArray(dynamic_comparison_string, DYNAMIC_COMPARISON_RESERVED);
-    cJSON_AddItemToObject(root, "dynamic_comparison", list);
+    if (begin) {
+        if (depth < JSON_IMPORT_DEPTH) {
+            uint8_t bit = 1 << depth;
 
-    // Populate can_bus_mode option list
-    list = cJSON_CreateStringArray(can_bus_mode_string, CAN_BUS_MODE_RESERVED);
-    cJSON_AddItemToObject(root, "can_bus_mode", list);
+            json_import.roles[depth] = role;
+            json_import.arrays = (event == JSON_EVENT_ARRAY_BEGIN) ? (json_import.arrays | bit) : (json_import.arrays & ~bit);
 
-    // Print into user buffer
-    char *json = cJSON_PrintUnformatted(root);
-    uint32_t actual_len = 0;
-    if (json) {
-        size_t len = strlen(json);
-        if (len < buffer_size) {
-            memcpy(buffer, json, len + 1); // Copy including null terminator
-            actual_len = (uint32_t)len;
+            // In a patch an array replaces its list and everything below it
+            if (json_import.patch && (role != JSON_ROLE_NONE) && (replace || (event == JSON_EVENT_ARRAY_BEGIN)))
+                json_import.replace |= bit;
+            else
+                json_import.replace &= ~bit;
         }
-        free(json);
+        json_import.depth++;
     }
-    cJSON_Delete(root);
-    return actual_len; // 0 means failure
+
+    return true;
 }
 
-uint32_t config_to_json(char *buffer, uint32_t buffer_size) {
-    cJSON *root = cJSON_CreateObject();
+static bool json_import_start(bool patch) {
+    if (json_import.active) return false;
 
-    if (!root) return 0;
+    // Every section is loaded first so finish compares against a complete cache
+    for( uint8_t section = 0; section < SETTINGS_SECTION_COUNT; section++ )
+        SECTION_LOAD(section);
+    memset(import_staged, 0, sizeof(import_staged));
 
-    char str_buf[1024];
+    json_reader_init(&json_import.reader, json_import_event, NULL);
+    json_import.depth = 0;
+    json_import.section = -1;
+    json_import.field = -1;
+    json_import.patch = patch;
+    json_import.active = true;
 
-    // Serialize view
-    cJSON *views = cJSON_AddArrayToObject(root, "view");
-    for(int i = 0; i < MAX_VIEWS; i++) {
-        cJSON *view = cJSON_CreateObject();
-        cJSON_AddStringToObject(view, "enable", view_state_string[get_view_enable(i)]);
-        cJSON_AddNumberToObject(view, "num_gauges", get_view_num_gauges(i));
-        cJSON_AddStringToObject(view, "background", view_background_string[get_view_background(i)]);
-        cJSON_AddNumberToObject(view, "background_color", get_view_background_color(i));
-        cJSON_AddStringToObject(view, "background_type", view_background_type_string[get_view_background_type(i)]);
+    return true;
+}
 
-        // Serialize gauge within view
-        cJSON *view_gauges = cJSON_AddArrayToObject(view, "gauge");
-        for(int j = 0; j < MAX_GAUGES_PER_VIEW; j++) {
-            cJSON *view_gauge = cJSON_CreateObject();
-            cJSON_AddStringToObject(view_gauge, "theme", gauge_theme_string[get_view_gauge_theme(i, j)]);
-            get_pid_desc(get_view_gauge_pid(i, j), str_buf);
-            cJSON_AddStringToObject(view_gauge, "pid", str_buf);
-            get_unit_desc(get_view_gauge_units(i, j), str_buf);
-            cJSON_AddStringToObject(view_gauge, "units", str_buf);
-            cJSON_AddItemToArray(view_gauges, view_gauge);
-        }
-        cJSON_AddItemToArray(views, view);
+bool settings_json_import_begin(void) {
+    return json_import_start(false);
+}
+
+bool settings_json_patch_begin(void) {
+    return json_import_start(true);
+}
+
+void settings_json_import_abort(void) {
+    if (!json_import.active) return;
+
+    json_import.active = false;
+    import_restore();
+}
+
+bool settings_json_import_feed(const char *data, uint32_t len) {
+    if (!json_import.active) return false;
+
+    if (!json_reader_feed(&json_import.reader, data, len)) {
+        settings_json_import_abort();
+        return false;
     }
 
-    // Serialize alert
-    cJSON *alerts = cJSON_AddArrayToObject(root, "alert");
-    for(int i = 0; i < MAX_ALERTS; i++) {
-        cJSON *alert = cJSON_CreateObject();
-        cJSON_AddStringToObject(alert, "enable", alert_state_string[get_alert_enable(i)]);
-        get_pid_desc(get_alert_pid(i), str_buf);
-        cJSON_AddStringToObject(alert, "pid", str_buf);
-        get_unit_desc(get_alert_units(i), str_buf);
-        cJSON_AddStringToObject(alert, "units", str_buf);
-        get_alert_message(i, str_buf);
-        cJSON_AddStringToObject(alert, "message", str_buf);
-        cJSON_AddStringToObject(alert, "compare", alert_comparison_string[get_alert_compare(i)]);
-        cJSON_AddNumberToObject(alert, "threshold", get_alert_threshold(i));
-        cJSON_AddItemToArray(alerts, alert);
+    return true;
+}
+
+bool settings_json_import_finish(void) {
+    if (!json_import.active) return false;
+
+    if (!json_reader_finish(&json_import.reader)) {
+        settings_json_import_abort();
+        return false;
     }
 
-    // Serialize dynamic
-    cJSON *dynamics = cJSON_AddArrayToObject(root, "dynamic");
-    for(int i = 0; i < MAX_DYNAMICS; i++) {
-        cJSON *dynamic = cJSON_CreateObject();
-        cJSON_AddStringToObject(dynamic, "enable", dynamic_state_string[get_dynamic_enable(i)]);
-        cJSON_AddStringToObject(dynamic, "priority", dynamic_priority_string[get_dynamic_priority(i)]);
-        cJSON_AddStringToObject(dynamic, "compare", dynamic_comparison_string[get_dynamic_compare(i)]);
-        cJSON_AddNumberToObject(dynamic, "threshold", get_dynamic_threshold(i));
-        cJSON_AddNumberToObject(dynamic, "view_index", get_dynamic_view_index(i));
-        get_pid_desc(get_dynamic_pid(i), str_buf);
-        cJSON_AddStringToObject(dynamic, "pid", str_buf);
-        get_unit_desc(get_dynamic_units(i), str_buf);
-        cJSON_AddStringToObject(dynamic, "units", str_buf);
-        cJSON_AddItemToArray(dynamics, dynamic);
+    // With A/B storage the commit publishes the import as a single new image
+    json_import.active = false;
+    import_commit();
+
+    return true;
+}
+
+// Path segment "name" or "name[index]", index is -1 without brackets
+static bool json_path_segment(const char **path, char *name, uint8_t size, int16_t *index) {
+    uint8_t len = 0;
+
+    while (**path && (**path != '.') && (**path != '[')) {
+        if (len + 1 >= size) return false;
+        name[len++] = *(*path)++;
     }
+    name[len] = '\0';
 
-    // Serialize general
-    cJSON *generals = cJSON_AddArrayToObject(root, "general");
-    for(int i = 0; i < MAX_GENERALS; i++) {
-        cJSON *general = cJSON_CreateObject();
-        cJSON_AddNumberToObject(general, "EE_Version", get_general_ee_version(i));
-        cJSON_AddNumberToObject(general, "splash", get_general_splash(i));
-        cJSON_AddStringToObject(general, "can_bus_mode", can_bus_mode_string[get_general_can_bus_mode(i)]);
-        cJSON_AddItemToArray(generals, general);
-    }
-
-    // Print into user buffer
-    char *json = cJSON_PrintUnformatted(root);
-    uint32_t actual_len = 0;
-    if (json) {
-        size_t len = strlen(json);
-        if (len < buffer_size) {
-            memcpy(buffer, json, len + 1); // Copy including null terminator
-            actual_len = (uint32_t)len;
+    *index = -1;
+    if (**path == '[') {
+        (*path)++;
+        if ((**path < '0') || (**path > '9')) return false;
+
+        *index = 0;
+        while ((**path >= '0') && (**path <= '9')) {
+            if (*index > 255) return false;
+            *index = *index * 10 + (*(*path)++ - '0');
         }
-        free(json);
+        if (*(*path)++ != ']') return false;
     }
-    cJSON_Delete(root);
-    return actual_len; // 0 means failure
+
+    return len > 0;
 }
 
-bool json_to_config(const char *json_str) {
-    cJSON *root = cJSON_Parse(json_str);
-
-    if (!root) return false;
-
-    // Get view
-    cJSON *views = cJSON_GetObjectItem(root, "view");
-    if(views && cJSON_IsArray(views)) {
-        for(int i = 0; (i < MAX_VIEWS) && (i < cJSON_GetArraySize(views)); i++) {
-            cJSON *view = cJSON_GetArrayItem(views, i);
-
-            cJSON *view_enable = cJSON_GetObjectItem(view, "enable");
-            if(cJSON_IsString(view_enable))
-                set_view_enable(i, get_view_enable_from_string(view_enable->valuestring), true);
-
-            cJSON *view_num_gauges = cJSON_GetObjectItem(view, "num_gauges");
-            if(cJSON_IsNumber(view_num_gauges))
-                set_view_num_gauges(i, view_num_gauges->valueint, true);
-
-            cJSON *view_background = cJSON_GetObjectItem(view, "background");
-            if(cJSON_IsString(view_background))
-                set_view_background(i, get_view_background_from_string(view_background->valuestring), true);
-
-            cJSON *view_background_color = cJSON_GetObjectItem(view, "background_color");
-            if(cJSON_IsNumber(view_background_color))
-                set_view_background_color(i, view_background_color->valueint, true);
-
-            cJSON *view_background_type = cJSON_GetObjectItem(view, "background_type");
-            if(cJSON_IsString(view_background_type))
-                set_view_background_type(i, get_view_background_type_from_string(view_background_type->valuestring), true);
-
-            // Get gauge within view
-            cJSON *view_gauges = cJSON_GetObjectItem(view, "gauge");
-            if(view_gauges && cJSON_IsArray(view_gauges)) {
-                for(int j = 0; j < MAX_GAUGES_PER_VIEW; j++) {
-                    cJSON *view_gauge = cJSON_GetArrayItem(view_gauges, j);
-                    if(view_gauge) {
-
-                        cJSON *view_gauge_theme = cJSON_GetObjectItem(view_gauge, "theme");
-                        if(cJSON_IsString(view_gauge_theme))
-                            set_view_gauge_theme(i, j, get_view_gauge_theme_from_string(view_gauge_theme->valuestring), true);
-
-                        cJSON *view_gauge_pid = cJSON_GetObjectItem(view_gauge, "pid");
-                        if(cJSON_IsString(view_gauge_pid))
-                            set_view_gauge_pid(i, j, get_pid_by_string(view_gauge_pid->valuestring), true);
-
-                        cJSON *view_gauge_units = cJSON_GetObjectItem(view_gauge, "units");
-                        if(cJSON_IsString(view_gauge_units))
-                            set_view_gauge_units(i, j, get_unit_by_string(view_gauge_units->valuestring), true);
-                    }
-                }
-            }
-        }
-    }
+// Keeps the single scalar of a path value until the reader accepts the whole text
+typedef struct
+{
+    JSON_EVENT event;
+    uint8_t values;
+    char text[JSON_READER_TOKEN_SIZE];
+} json_path_value;
+
+static bool json_path_event(void *context, JSON_EVENT event, const char *text, uint32_t len) {
+    json_path_value *value = context;
+
+    if ((event != JSON_EVENT_STRING) && (event != JSON_EVENT_NUMBER) && (event != JSON_EVENT_NULL))
+        return false;
 
-    // Get alert
-    cJSON *alerts = cJSON_GetObjectItem(root, "alert");
-    if(alerts && cJSON_IsArray(alerts)) {
-        for(int i = 0; (i < MAX_ALERTS) && (i < cJSON_GetArraySize(alerts)); i++) {
-            cJSON *alert = cJSON_GetArrayItem(alerts, i);
+    value->event = event;
+    value->values++;
+    if (text)
+        memcpy(value->text, text, len + 1);
 
-            cJSON *alert_enable = cJSON_GetObjectItem(alert, "enable");
-            if(cJSON_IsString(alert_enable))
-                set_alert_enable(i, get_alert_enable_from_string(alert_enable->valuestring), true);
+    return true;
+}
 
-            cJSON *alert_pid = cJSON_GetObjectItem(alert, "pid");
-            if(cJSON_IsString(alert_pid))
-                set_alert_pid(i, get_pid_by_string(alert_pid->valuestring), true);
+bool json_set_config_path(const char *path, const char *json_value) {
+    json_path_value value = {0};
+    json_reader reader;
+    char name[24];
+    int16_t index;
+    int16_t gauge = 0;
 
-            cJSON *alert_units = cJSON_GetObjectItem(alert, "units");
-            if(cJSON_IsString(alert_units))
-                set_alert_units(i, get_unit_by_string(alert_units->valuestring), true);
+    if (!path || !json_value) return false;
 
-            cJSON *alert_message = cJSON_GetObjectItem(alert, "message");
-            if(cJSON_IsString(alert_message))
-                set_alert_message(i, alert_message->valuestring, true);
+    // section[index]
+    if (!json_path_segment(&path, name, sizeof(name), &index) || (*path++ != '.')) return false;
 
-            cJSON *alert_compare = cJSON_GetObjectItem(alert, "compare");
-            if(cJSON_IsString(alert_compare))
-                set_alert_compare(i, get_alert_compare_from_string(alert_compare->valuestring), true);
+    int8_t section = json_find_section(name);
+    if ((section < 0) || (index < 0) || (index >= json_section_count[section])) return false;
 
-            cJSON *alert_threshold = cJSON_GetObjectItem(alert, "threshold");
-            if(cJSON_IsNumber(alert_threshold))
-                set_alert_threshold(i, alert_threshold->valuedouble, true);
-        }
+    // [gauge[index].]field
+    int16_t field_index;
+    if (!json_path_segment(&path, name, sizeof(name), &field_index)) return false;
+
+    int8_t field = json_find_field(section, false, name);
+    if (field == JSON_IMPORT_GAUGES) {
+        if ((field_index < 0) || (field_index >= MAX_GAUGES_PER_VIEW) || (*path++ != '.')) return false;
+        gauge = field_index;
+
+        if (!json_path_segment(&path, name, sizeof(name), &field_index)) return false;
+        field = json_find_field(section, true, name);
     }
+    if ((field < 0) || (field_index >= 0) || *path) return false;
 
-    // Get dynamic
-    cJSON *dynamics = cJSON_GetObjectItem(root, "dynamic");
-    if(dynamics && cJSON_IsArray(dynamics)) {
-        for(int i = 0; (i < MAX_DYNAMICS) && (i < cJSON_GetArraySize(dynamics)); i++) {
-            cJSON *dynamic = cJSON_GetArrayItem(dynamics, i);
+    json_reader_init(&reader, json_path_event, &value);
+    if (!json_reader_feed(&reader, json_value, strlen(json_value)) || !json_reader_finish(&reader) || (value.values != 1))
+        return false;
 
-            cJSON *dynamic_enable = cJSON_GetObjectItem(dynamic, "enable");
-            if(cJSON_IsString(dynamic_enable))
-                set_dynamic_enable(i, get_dynamic_enable_from_string(dynamic_enable->valuestring), true);
+    if (value.event == JSON_EVENT_NULL)
+        return json_default_value(field, index, gauge, true);
 
-            cJSON *dynamic_priority = cJSON_GetObjectItem(dynamic, "priority");
-            if(cJSON_IsString(dynamic_priority))
-                set_dynamic_priority(i, get_dynamic_priority_from_string(dynamic_priority->valuestring), true);
+    return json_import_value(field, index, gauge, value.event, value.text, true);
+}
 
-            cJSON *dynamic_compare = cJSON_GetObjectItem(dynamic, "compare");
-            if(cJSON_IsString(dynamic_compare))
-                set_dynamic_compare(i, get_dynamic_compare_from_string(dynamic_compare->valuestring), true);
+/********************************************************************************
+*                                Packed storage
+*
+* The cache keeps the byte layout of the memory map, the device holds every
+* element at its packed bit width instead. A write re-packs only the elements
+* its runs overlap into packed_image and programs the packed bytes that
+* changed, page by page. load_settings() expands the packed image back into
+* the cache, the section crcs and the layout version are stored as they are so
+* the crcs still cover the expanded image. A packed area without the magic reads as a blank image and
+* is written in full by the first store.
+*
+********************************************************************************/
+#define PACKED_CRC_START EEPROM_SECTION_CRC_VIEW_BYTE1
+#define PACKED_RAW_END (EEPROM_LAYOUT_VERSION_BYTE1 + EE_SIZE_LAYOUT_VERSION)
 
-            cJSON *dynamic_threshold = cJSON_GetObjectItem(dynamic, "threshold");
-            if(cJSON_IsNumber(dynamic_threshold))
-                set_dynamic_threshold(i, dynamic_threshold->valuedouble, true);
+static uint16_t packed_element_bits(const settings_field *f)
+{
+    return f->bits ? f->bits : f->size * 8;
+}
 
-            cJSON *dynamic_view_index = cJSON_GetObjectItem(dynamic, "view_index");
-            if(cJSON_IsNumber(dynamic_view_index))
-                set_dynamic_view_index(i, dynamic_view_index->valueint, true);
+// Bit offset of the section crcs, every field comes before them
+static uint32_t packed_crc_bit(void)
+{
+    uint32_t bit = 0;
 
-            cJSON *dynamic_pid = cJSON_GetObjectItem(dynamic, "pid");
-            if(cJSON_IsString(dynamic_pid))
-                set_dynamic_pid(i, get_pid_by_string(dynamic_pid->valuestring), true);
+    for( uint8_t field = 0; field < SETTINGS_FIELD_COUNT; field++ )
+        bit += (uint32_t)settings_fields[field].count * packed_element_bits(&settings_fields[field]);
 
-            cJSON *dynamic_units = cJSON_GetObjectItem(dynamic, "units");
-            if(cJSON_IsString(dynamic_units))
-                set_dynamic_units(i, get_unit_by_string(dynamic_units->valuestring), true);
-        }
-    }
+    return bit;
+}
 
-    // Get general
-    cJSON *generals = cJSON_GetObjectItem(root, "general");
-    if(generals && cJSON_IsArray(generals)) {
-        for(int i = 0; (i < MAX_GENERALS) && (i < cJSON_GetArraySize(generals)); i++) {
-            cJSON *general = cJSON_GetArrayItem(generals, i);
+static uint16_t packed_image_size(void)
+{
+    uint32_t bits = packed_crc_bit() + (PACKED_RAW_END - PACKED_CRC_START) * 8;
 
-            cJSON *general_ee_version = cJSON_GetObjectItem(general, "EE_Version");
-            if(cJSON_IsNumber(general_ee_version))
-                set_general_ee_version(i, general_ee_version->valueint, true);
+    return PACKED_HEADER_SIZE + (uint16_t)((bits + 7) / 8);
+}
 
-            cJSON *general_splash = cJSON_GetObjectItem(general, "splash");
-            if(cJSON_IsNumber(general_splash))
-                set_general_splash(i, general_splash->valueint, true);
+// Store the low bits of value LSB first, flagging every byte that changes
+static void packed_put_bits(uint32_t bit, uint32_t value, uint8_t bits, uint8_t *changed)
+{
+    while (bits > 0)
+    {
+        uint16_t byte = PACKED_HEADER_SIZE + (uint16_t)(bit / 8);
+        uint8_t shift = bit % 8;
+        uint8_t take = (8 - shift < bits) ? 8 - shift : bits;
+        uint8_t mask = (uint8_t)(((1u << take) - 1) << shift);
+        uint8_t next = (uint8_t)((packed_image[byte] & ~mask) | ((value << shift) & mask));
 
-            cJSON *general_can_bus_mode = cJSON_GetObjectItem(general, "can_bus_mode");
-            if(cJSON_IsString(general_can_bus_mode))
-                set_general_can_bus_mode(i, get_general_can_bus_mode_from_string(general_can_bus_mode->valuestring), true);
+        if (next != packed_image[byte])
+        {
+            packed_image[byte] = next;
+            changed[byte / 8] |= (uint8_t)(1 << (byte % 8));
         }
-    }
 
-    // Print into user buffer
-    cJSON_Delete(root);
-    return true;
+        value >>= take;
+        bit += take;
+        bits -= take;
+    }
 }
 
-static uint8_t cached_settings[496];
+static uint32_t packed_get_bits(uint32_t bit, uint8_t bits)
+{
+    uint32_t value = 0;
+    uint8_t done = 0;
 
-static settings_write *write;
-static settings_read *read;
+    while (done < bits)
+    {
+        uint16_t byte = PACKED_HEADER_SIZE + (uint16_t)(bit / 8);
+        uint8_t shift = bit % 8;
+        uint8_t take = (8 - shift < bits - done) ? 8 - shift : bits - done;
 
-void settings_setWriteHandler(settings_write *writeHandler) { write = writeHandler; }
-void settings_setReadHandler(settings_read *readHandler) { read = readHandler; }
+        value |= (uint32_t)((packed_image[byte] >> shift) & ((1u << take) - 1)) << done;
 
-// Converts an EEPROM address to a linear array index
-static uint16_t eeprom_address_to_linear_index(uint16_t address) {
-    uint16_t page = address >> 5;
-    uint16_t offset = address & 0x1F; // Mask lower 5 bits (0-31)
-    return (page * 32) + offset;
+        done += take;
+        bit += take;
+    }
 
+    return value;
 }
 
-uint8_t read_eeprom(uint16_t bAdd)
+// An erased element (all 0xFF in the map, as on a blank part) packs to all ones
+// so it expands back unchanged and the section crc still matches
+static uint32_t packed_erased_code(const settings_field *f)
 {
-	uint8_t byte = 0xFF;
-	byte = read(bAdd); // Read from the EEPROM
-	cached_settings[bAdd] = byte; // cache the data
-	return byte;
+    return (f->bits < 32) ? ((uint32_t)1 << f->bits) - 1 : 0xFFFFFFFF;
 }
 
-void write_eeprom(uint16_t bAdd, uint8_t bData)
+static bool packed_element_erased(const uint8_t *raw, uint16_t size)
 {
-	write(bAdd, bData); // Write to the EEPROM
-	cached_settings[bAdd] = bData; // cache the data
+    for( uint16_t n = 0; n < size; n++ )
+        if (raw[n] != 0xFF)
+            return false;
+
+    return true;
 }
 
-uint8_t get_eeprom_byte(uint16_t bAdd)
+static void packed_put_element(const settings_field *f, uint32_t bit, uint16_t bAdd, uint8_t *changed)
 {
-	return cached_settings[bAdd];
+    const uint8_t *raw = &cached_settings[bAdd];
+
+    if (!f->bits)
+    {
+        for( uint16_t n = 0; n < f->size; n++ )
+            packed_put_bits(bit + 8 * n, raw[n], 8, changed);
+        return;
+    }
+
+    uint32_t value = (f->size == 1) ? raw[0] : (f->size == 2) ? decode_u16(raw) : decode_u32(raw);
+    if (packed_element_erased(raw, f->size))
+        value = packed_erased_code(f);
+
+    packed_put_bits(bit, value, f->bits, changed);
 }
 
-void load_settings(void)
+static void packed_get_element(const settings_field *f, uint32_t bit, uint16_t bAdd)
 {
-    for( uint8_t idx = 0; idx < MAX_VIEWS; idx++ )
-        load_view_enable(idx, &settings_view_enable[idx]);
+    uint8_t *raw = &cached_settings[bAdd];
 
-    for( uint8_t idx = 0; idx < MAX_GAUGES_PER_VIEW; idx++ )
-        load_view_num_gauges(idx, &settings_view_num_gauges[idx]);
+    if (!f->bits)
+    {
+        for( uint16_t n = 0; n < f->size; n++ )
+            raw[n] = (uint8_t)packed_get_bits(bit + 8 * n, 8);
+        return;
+    }
 
-    for( uint8_t idx = 0; idx < MAX_VIEWS; idx++ )
-        load_view_background(idx, &settings_view_background[idx]);
+    uint32_t value = packed_get_bits(bit, f->bits);
+    if (value == packed_erased_code(f))
+        memset(raw, 0xFF, f->size);
+    else if (f->size == 1)
+        raw[0] = (uint8_t)value;
+    else if (f->size == 2)
+        encode_u16(raw, (uint16_t)value);
+    else
+        encode_u32(raw, value);
+}
 
-    for( uint8_t idx = 0; idx < MAX_VIEWS; idx++ )
-        load_view_background_color(idx, &settings_view_background_color[idx]);
+static bool packed_runs_overlap(const eeprom_run *runs, uint8_t count, uint16_t bAdd, uint16_t len)
+{
+    for( uint8_t i = 0; i < count; i++ )
+        if ((bAdd < runs[i].bAdd + runs[i].len) && (bAdd + len > runs[i].bAdd))
+            return true;
 
-    for( uint8_t idx = 0; idx < MAX_VIEWS; idx++ )
-        load_view_background_type(idx, &settings_view_background_type[idx]);
+    return false;
+}
 
-    for( uint8_t idx_view = 0; idx_view < MAX_VIEWS; idx_view++ )
-        for( uint8_t idx_gauge = 0; idx_gauge < MAX_GAUGES_PER_VIEW; idx_gauge++ )
-            load_view_gauge_theme(idx_view, idx_gauge, &settings_view_gauge_theme[idx_view][idx_gauge]);
+// Re-pack the elements the runs touch and program the packed bytes that changed,
+// called with settings_mutex held
+static void packed_store(const eeprom_run *runs, uint8_t count)
+{
+    uint8_t changed[(PACKED_IMAGE_MAX + 7) / 8] = {0};
+    bool format = !packed_formatted;
+    uint32_t bit = 0;
 
-    for( uint8_t idx_view = 0; idx_view < MAX_VIEWS; idx_view++ )
-        for( uint8_t idx_gauge = 0; idx_gauge < MAX_GAUGES_PER_VIEW; idx_gauge++ )
-            load_view_gauge_pid(idx_view, idx_gauge, &settings_view_gauge_pid[idx_view][idx_gauge]);
+    // The first store writes the whole image behind the magic
+    if (format)
+    {
+        packed_image[0] = (uint8_t)PACKED_MAGIC;
+        packed_image[1] = (uint8_t)(PACKED_MAGIC >> 8);
+        changed[0] |= 0x03;
+    }
 
-    for( uint8_t idx_view = 0; idx_view < MAX_VIEWS; idx_view++ )
-        for( uint8_t idx_gauge = 0; idx_gauge < MAX_GAUGES_PER_VIEW; idx_gauge++ )
-            load_view_gauge_units(idx_view, idx_gauge, &settings_view_gauge_units[idx_view][idx_gauge]);
+    for( uint8_t field = 0; field < SETTINGS_FIELD_COUNT; field++ )
+    {
+        const settings_field *f = &settings_fields[field];
+        uint16_t element_bits = packed_element_bits(f);
 
-    for( uint8_t idx = 0; idx < MAX_ALERTS; idx++ )
-        load_alert_enable(idx, &settings_alert_enable[idx]);
+        for( uint16_t idx = 0; idx < f->count; idx++, bit += element_bits )
+            if (format || packed_runs_overlap(runs, count, f->map[idx], f->size))
+                packed_put_element(f, bit, f->map[idx], changed);
+    }
 
-    for( uint8_t idx = 0; idx < MAX_ALERTS; idx++ )
-        load_alert_pid(idx, &settings_alert_pid[idx]);
+    for( uint16_t bAdd = PACKED_CRC_START; bAdd < PACKED_RAW_END; bAdd++, bit += 8 )
+        if (format || packed_runs_overlap(runs, count, bAdd, 1))
+            packed_put_bits(bit, cached_settings[bAdd], 8, changed);
 
-    for( uint8_t idx = 0; idx < MAX_ALERTS; idx++ )
-        load_alert_units(idx, &settings_alert_units[idx]);
+    // One write per device page, covering its first to last changed byte
+    for( uint16_t start = 0; start < packed_size; start += EEPROM_PAGE_SIZE )
+    {
+        uint16_t end = (start + EEPROM_PAGE_SIZE < packed_size) ? start + EEPROM_PAGE_SIZE : packed_size;
+        uint16_t first = end;
+        uint16_t last = start;
 
-    for( uint8_t idx = 0; idx < MAX_ALERTS; idx++ )
-        load_alert_message(idx, settings_alert_message[idx]);
+        for( uint16_t byte = start; byte < end; byte++ )
+        {
+            if (changed[byte / 8] & (1 << (byte % 8)))
+            {
+                if (first == end)
+                    first = byte;
+                last = byte + 1;
+            }
+        }
 
-    for( uint8_t idx = 0; idx < MAX_ALERTS; idx++ )
-        load_alert_compare(idx, &settings_alert_compare[idx]);
+        if (first < end)
+            write_device(packed_base_address + first, &packed_image[first], last - first);
+    }
 
-    for( uint8_t idx = 0; idx < MAX_ALERTS; idx++ )
-        load_alert_threshold(idx, &settings_alert_threshold[idx]);
+    packed_formatted = true;
+}
 
-    for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
-        load_dynamic_enable(idx, &settings_dynamic_enable[idx]);
+// Expand the packed image into the cache
+static void packed_load(void)
+{
+    read_device(packed_base_address, packed_image, packed_size);
+    memset(cached_settings, 0xFF, EEPROM_MAP_SIZE);
 
-    for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
-        load_dynamic_priority(idx, &settings_dynamic_priority[idx]);
+    packed_formatted = (packed_image[0] | (packed_image[1] << 8)) == PACKED_MAGIC;
+    if (!packed_formatted)
+        return;
 
-    for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
-        load_dynamic_compare(idx, &settings_dynamic_compare[idx]);
+    uint32_t bit = 0;
 
-    for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
-        load_dynamic_threshold(idx, &settings_dynamic_threshold[idx]);
+    for( uint8_t field = 0; field < SETTINGS_FIELD_COUNT; field++ )
+    {
+        const settings_field *f = &settings_fields[field];
+        uint16_t element_bits = packed_element_bits(f);
 
-    for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
-        load_dynamic_view_index(idx, &settings_dynamic_view_index[idx]);
+        for( uint16_t idx = 0; idx < f->count; idx++, bit += element_bits )
+            packed_get_element(f, bit, f->map[idx]);
+    }
 
-    for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
-        load_dynamic_pid(idx, &settings_dynamic_pid[idx]);
+    for( uint16_t bAdd = PACKED_CRC_START; bAdd < PACKED_RAW_END; bAdd++, bit += 8 )
+        cached_settings[bAdd] = (uint8_t)packed_get_bits(bit, 8);
+}
 
-    for( uint8_t idx = 0; idx < MAX_DYNAMICS; idx++ )
-        load_dynamic_units(idx, &settings_dynamic_units[idx]);
+// Storage switched to packed after load_settings(), write the cache as a whole
+// packed image over whatever the area held. Called with settings_mutex held.
+static void packed_seed(void)
+{
+    read_device(packed_base_address, packed_image, packed_size);
+    packed_formatted = false;
+    packed_store(NULL, 0);
+}
 
-    for( uint8_t idx = 0; idx < MAX_GENERALS; idx++ )
-        load_general_ee_version(idx, &settings_general_ee_version[idx]);
+// Decode the fields of one section from the image already held in the cache
+static void decode_section(SETTINGS_SECTION section)
+{
+    for( uint8_t field = 0; field < sizeof(settings_fields) / sizeof(settings_fields[0]); field++ )
+    {
+        const settings_field *f = &settings_fields[field];
 
-    for( uint8_t idx = 0; idx < MAX_GENERALS; idx++ )
-        load_general_splash(idx, &settings_general_splash[idx]);
+        if (f->section != section)
+            continue;
 
-    for( uint8_t idx = 0; idx < MAX_GENERALS; idx++ )
-        load_general_can_bus_mode(idx, &settings_general_can_bus_mode[idx]);
+        for( uint16_t idx = 0; idx < f->count; idx++ )
+            decode_element(f, idx, cached_settings);
+    }
+}
+
+// Encode the RAM values of one section into an image laid out like the cache,
+// called with settings_mutex held
+static void encode_section(SETTINGS_SECTION section, uint8_t *image)
+{
+    for( uint8_t field = 0; field < SETTINGS_FIELD_COUNT; field++ )
+    {
+        const settings_field *f = &settings_fields[field];
+
+        if (f->section != section)
+            continue;
+
+        for( uint16_t idx = 0; idx < f->count; idx++ )
+            encode_element(f, idx, image);
+    }
+}
+
+// Decode and check every section from the image already held in the cache,
+// called with settings_mutex held as the repairs check_section() stages need
+static void decode_sections(void)
+{
+    for (uint8_t section = 0; section < SETTINGS_SECTION_COUNT; section++)
+    {
+        decode_section((SETTINGS_SECTION)section);
+        sanitize_section((SETTINGS_SECTION)section);
+        check_section((SETTINGS_SECTION)section);
+    }
+    settings_loaded_sections = (1 << SETTINGS_SECTION_COUNT) - 1;
+}
+
+static void decode_settings(void)
+{
+    pthread_mutex_lock(&settings_mutex);
+    decode_sections();
+    pthread_mutex_unlock(&settings_mutex);
+}
+
+void settings_prefetch(SETTINGS_SECTION section)
+{
+    if ((section >= SETTINGS_SECTION_COUNT) || (settings_loaded_sections & (1 << section)))
+        return;
+
+    // Until load_settings() has set up the image there is nothing to decode or
+    // repair, the getters return the defaults already in RAM
+    if (!image_loaded)
+        return;
+
+    pthread_mutex_lock(&settings_mutex);
+
+    // Another caller may have loaded it while this one waited
+    if (settings_loaded_sections & (1 << section))
+    {
+        pthread_mutex_unlock(&settings_mutex);
+        return;
+    }
+
+    // Journal and A/B storage rebuild the whole image at load time
+    if (lazy_fetch)
+    {
+        fetch_eeprom_block(map_section_start[section], map_section_end[section] - map_section_start[section]);
+        fetch_eeprom_block(map_section_crc_byte1[section], EE_SIZE_SECTION_CRC);
+    }
+
+    decode_section(section);
+    sanitize_section(section);
+    check_section(section);
+    settings_loaded_sections |= (1 << section);
+
+    pthread_mutex_unlock(&settings_mutex);
+}
 
+void settings_set_lazy_load(bool lazy)
+{
+    lazy_load = lazy;
 }
 
 
@@ -1869,26 +4867,26 @@ void load_settings(void)
 *
 ********************************************************************************/
 const char *view_state_string[] = {
-    "Disabled",
-    "Enabled"
+    VIEW_STATE_STRINGS(OPTION_STRING, OPTION_STRING_NEXT)
 };
+_Static_assert(sizeof(view_state_string) / sizeof(view_state_string[0]) == VIEW_STATE_RESERVED, "one string per VIEW_STATE value");
 
 static void load_view_enable(uint8_t idx, VIEW_STATE *view_enable_val)
 {
-    uint8_t bytes[EE_SIZE_VIEW_ENABLE];
+    uint8_t raw[EE_SIZE_VIEW_ENABLE];
 
-    bytes[0] = read_eeprom(map_view_enable_byte1[idx]);
+    read_eeprom_block(map_view_enable_byte1[idx], raw, EE_SIZE_VIEW_ENABLE);
 
-    memcpy(view_enable_val, bytes, EE_SIZE_VIEW_ENABLE);
+    *view_enable_val = (VIEW_STATE)raw[0];
 }
 
 static void save_view_enable(uint8_t idx, VIEW_STATE *view_enable)
 {
-    uint8_t bytes[EE_SIZE_VIEW_ENABLE];
+    uint8_t raw[EE_SIZE_VIEW_ENABLE];
 
-    memcpy(bytes, view_enable, EE_SIZE_VIEW_ENABLE);
+    raw[0] = (uint8_t)*view_enable;
 
-    write_eeprom(map_view_enable_byte1[idx], bytes[0]);
+    write_eeprom_block(map_view_enable_byte1[idx], raw, EE_SIZE_VIEW_ENABLE);
 }
 
 bool verify_view_enable(VIEW_STATE view_enable)
@@ -1901,9 +4899,7 @@ bool verify_view_enable(VIEW_STATE view_enable)
 
 VIEW_STATE get_view_enable(uint8_t idx)
 {
-    // Verify the View enable value is valid
-    if (!verify_view_enable(settings_view_enable[idx]))
-        return DEFAULT_VIEW_ENABLE;
+    SECTION_LOAD(SETTINGS_SECTION_VIEW);
 
     return settings_view_enable[idx];
 }
@@ -1911,6 +4907,8 @@ VIEW_STATE get_view_enable(uint8_t idx)
 // Set the View enable
 bool set_view_enable(uint8_t idx, VIEW_STATE view_enable, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_VIEW);
+
     // Verify the View enable value is valid
     if (!verify_view_enable(view_enable))
         return false;
@@ -1952,20 +4950,20 @@ VIEW_STATE get_view_enable_from_string(const char *str)
 ********************************************************************************/
 static void load_view_num_gauges(uint8_t idx, uint8_t *view_num_gauges_val)
 {
-    uint8_t bytes[EE_SIZE_VIEW_NUM_GAUGES];
+    uint8_t raw[EE_SIZE_VIEW_NUM_GAUGES];
 
-    bytes[0] = read_eeprom(map_view_num_gauges_byte1[idx]);
+    read_eeprom_block(map_view_num_gauges_byte1[idx], raw, EE_SIZE_VIEW_NUM_GAUGES);
 
-    memcpy(view_num_gauges_val, bytes, EE_SIZE_VIEW_NUM_GAUGES);
+    *view_num_gauges_val = raw[0];
 }
 
 static void save_view_num_gauges(uint8_t idx, uint8_t *view_num_gauges)
 {
-    uint8_t bytes[EE_SIZE_VIEW_NUM_GAUGES];
+    uint8_t raw[EE_SIZE_VIEW_NUM_GAUGES];
 
-    memcpy(bytes, view_num_gauges, EE_SIZE_VIEW_NUM_GAUGES);
+    raw[0] = (uint8_t)*view_num_gauges;
 
-    write_eeprom(map_view_num_gauges_byte1[idx], bytes[0]);
+    write_eeprom_block(map_view_num_gauges_byte1[idx], raw, EE_SIZE_VIEW_NUM_GAUGES);
 }
 
 bool verify_view_num_gauges(uint8_t view_num_gauges)
@@ -1979,9 +4977,7 @@ bool verify_view_num_gauges(uint8_t view_num_gauges)
 
 uint8_t get_view_num_gauges(uint8_t idx)
 {
-    // Verify the Number of gauges value is valid
-    if (!verify_view_num_gauges(settings_view_num_gauges[idx]))
-        return DEFAULT_VIEW_NUM_GAUGES;
+    SECTION_LOAD(SETTINGS_SECTION_VIEW);
 
     return settings_view_num_gauges[idx];
 }
@@ -1989,6 +4985,8 @@ uint8_t get_view_num_gauges(uint8_t idx)
 // Set the Number of gauges
 bool set_view_num_gauges(uint8_t idx, uint8_t view_num_gauges, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_VIEW);
+
     // Verify the Number of gauges value is valid
     if (!verify_view_num_gauges(view_num_gauges))
         return false;
@@ -2021,34 +5019,26 @@ bool set_view_num_gauges(uint8_t idx, uint8_t view_num_gauges, bool save)
 *
 ********************************************************************************/
 const char *view_background_string[] = {
-    "User1",
-    "User2",
-    "User3",
-    "User4",
-    "User5",
-    "User6",
-    "User7",
-    "User8",
-    "User9",
-    "User10"
+    VIEW_BACKGROUND_STRINGS(OPTION_STRING, OPTION_STRING_NEXT)
 };
+_Static_assert(sizeof(view_background_string) / sizeof(view_background_string[0]) == VIEW_BACKGROUND_RESERVED, "one string per VIEW_BACKGROUND value");
 
 static void load_view_background(uint8_t idx, VIEW_BACKGROUND *view_background_val)
 {
-    uint8_t bytes[EE_SIZE_VIEW_BACKGROUND];
+    uint8_t raw[EE_SIZE_VIEW_BACKGROUND];
 
-    bytes[0] = read_eeprom(map_view_background_byte1[idx]);
+    read_eeprom_block(map_view_background_byte1[idx], raw, EE_SIZE_VIEW_BACKGROUND);
 
-    memcpy(view_background_val, bytes, EE_SIZE_VIEW_BACKGROUND);
+    *view_background_val = (VIEW_BACKGROUND)raw[0];
 }
 
 static void save_view_background(uint8_t idx, VIEW_BACKGROUND *view_background)
 {
-    uint8_t bytes[EE_SIZE_VIEW_BACKGROUND];
+    uint8_t raw[EE_SIZE_VIEW_BACKGROUND];
 
-    memcpy(bytes, view_background, EE_SIZE_VIEW_BACKGROUND);
+    raw[0] = (uint8_t)*view_background;
 
-    write_eeprom(map_view_background_byte1[idx], bytes[0]);
+    write_eeprom_block(map_view_background_byte1[idx], raw, EE_SIZE_VIEW_BACKGROUND);
 }
 
 bool verify_view_background(VIEW_BACKGROUND view_background)
@@ -2061,9 +5051,7 @@ bool verify_view_background(VIEW_BACKGROUND view_background)
 
 VIEW_BACKGROUND get_view_background(uint8_t idx)
 {
-    // Verify the Background value is valid
-    if (!verify_view_background(settings_view_background[idx]))
-        return DEFAULT_VIEW_BACKGROUND;
+    SECTION_LOAD(SETTINGS_SECTION_VIEW);
 
     return settings_view_background[idx];
 }
@@ -2071,6 +5059,8 @@ VIEW_BACKGROUND get_view_background(uint8_t idx)
 // Set the Background
 bool set_view_background(uint8_t idx, VIEW_BACKGROUND view_background, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_VIEW);
+
     // Verify the Background value is valid
     if (!verify_view_background(view_background))
         return false;
@@ -2120,26 +5110,20 @@ VIEW_BACKGROUND get_view_background_from_string(const char *str)
 ********************************************************************************/
 static void load_view_background_color(uint8_t idx, uint32_t *view_background_color_val)
 {
-    uint8_t bytes[EE_SIZE_VIEW_BACKGROUND_COLOR];
+    uint8_t raw[EE_SIZE_VIEW_BACKGROUND_COLOR];
 
-    bytes[3] = read_eeprom(map_view_background_color_byte1[idx]);
-    bytes[2] = read_eeprom(map_view_background_color_byte2[idx]);
-    bytes[1] = read_eeprom(map_view_background_color_byte3[idx]);
-    bytes[0] = read_eeprom(map_view_background_color_byte4[idx]);
+    read_eeprom_block(map_view_background_color_byte1[idx], raw, EE_SIZE_VIEW_BACKGROUND_COLOR);
 
-    memcpy(view_background_color_val, bytes, EE_SIZE_VIEW_BACKGROUND_COLOR);
+    *view_background_color_val = decode_u32(raw);
 }
 
 static void save_view_background_color(uint8_t idx, uint32_t *view_background_color)
 {
-    uint8_t bytes[EE_SIZE_VIEW_BACKGROUND_COLOR];
+    uint8_t raw[EE_SIZE_VIEW_BACKGROUND_COLOR];
 
-    memcpy(bytes, view_background_color, EE_SIZE_VIEW_BACKGROUND_COLOR);
+    encode_u32(raw, *view_background_color);
 
-    write_eeprom(map_view_background_color_byte1[idx], bytes[3]);
-    write_eeprom(map_view_background_color_byte2[idx], bytes[2]);
-    write_eeprom(map_view_background_color_byte3[idx], bytes[1]);
-    write_eeprom(map_view_background_color_byte4[idx], bytes[0]);
+    write_eeprom_block(map_view_background_color_byte1[idx], raw, EE_SIZE_VIEW_BACKGROUND_COLOR);
 }
 
 bool verify_view_background_color(uint32_t view_background_color)
@@ -2153,9 +5137,7 @@ bool verify_view_background_color(uint32_t view_background_color)
 
 uint32_t get_view_background_color(uint8_t idx)
 {
-    // Verify the Background Color value is valid
-    if (!verify_view_background_color(settings_view_background_color[idx]))
-        return DEFAULT_VIEW_BACKGROUND_COLOR;
+    SECTION_LOAD(SETTINGS_SECTION_VIEW);
 
     return settings_view_background_color[idx];
 }
@@ -2163,6 +5145,8 @@ uint32_t get_view_background_color(uint8_t idx)
 // Set the Background Color
 bool set_view_background_color(uint8_t idx, uint32_t view_background_color, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_VIEW);
+
     // Verify the Background Color value is valid
     if (!verify_view_background_color(view_background_color))
         return false;
@@ -2195,26 +5179,26 @@ bool set_view_background_color(uint8_t idx, uint32_t view_background_color, bool
 *
 ********************************************************************************/
 const char *view_background_type_string[] = {
-    "Color",
-    "Image"
+    VIEW_BACKGROUND_TYPE_STRINGS(OPTION_STRING, OPTION_STRING_NEXT)
 };
+_Static_assert(sizeof(view_background_type_string) / sizeof(view_background_type_string[0]) == VIEW_BACKGROUND_TYPE_RESERVED, "one string per VIEW_BACKGROUND_TYPE value");
 
 static void load_view_background_type(uint8_t idx, VIEW_BACKGROUND_TYPE *view_background_type_val)
 {
-    uint8_t bytes[EE_SIZE_VIEW_BACKGROUND_TYPE];
+    uint8_t raw[EE_SIZE_VIEW_BACKGROUND_TYPE];
 
-    bytes[0] = read_eeprom(map_view_background_type_byte1[idx]);
+    read_eeprom_block(map_view_background_type_byte1[idx], raw, EE_SIZE_VIEW_BACKGROUND_TYPE);
 
-    memcpy(view_background_type_val, bytes, EE_SIZE_VIEW_BACKGROUND_TYPE);
+    *view_background_type_val = (VIEW_BACKGROUND_TYPE)raw[0];
 }
 
 static void save_view_background_type(uint8_t idx, VIEW_BACKGROUND_TYPE *view_background_type)
 {
-    uint8_t bytes[EE_SIZE_VIEW_BACKGROUND_TYPE];
+    uint8_t raw[EE_SIZE_VIEW_BACKGROUND_TYPE];
 
-    memcpy(bytes, view_background_type, EE_SIZE_VIEW_BACKGROUND_TYPE);
+    raw[0] = (uint8_t)*view_background_type;
 
-    write_eeprom(map_view_background_type_byte1[idx], bytes[0]);
+    write_eeprom_block(map_view_background_type_byte1[idx], raw, EE_SIZE_VIEW_BACKGROUND_TYPE);
 }
 
 bool verify_view_background_type(VIEW_BACKGROUND_TYPE view_background_type)
@@ -2227,9 +5211,7 @@ bool verify_view_background_type(VIEW_BACKGROUND_TYPE view_background_type)
 
 VIEW_BACKGROUND_TYPE get_view_background_type(uint8_t idx)
 {
-    // Verify the Background Type value is valid
-    if (!verify_view_background_type(settings_view_background_type[idx]))
-        return DEFAULT_VIEW_BACKGROUND_TYPE;
+    SECTION_LOAD(SETTINGS_SECTION_VIEW);
 
     return settings_view_background_type[idx];
 }
@@ -2237,6 +5219,8 @@ VIEW_BACKGROUND_TYPE get_view_background_type(uint8_t idx)
 // Set the Background Type
 bool set_view_background_type(uint8_t idx, VIEW_BACKGROUND_TYPE view_background_type, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_VIEW);
+
     // Verify the Background Type value is valid
     if (!verify_view_background_type(view_background_type))
         return false;
@@ -2278,31 +5262,26 @@ VIEW_BACKGROUND_TYPE get_view_background_type_from_string(const char *str)
 *
 ********************************************************************************/
 const char *gauge_theme_string[] = {
-    "Stock ST",
-    "Stock RS",
-    "Grumpy Cat",
-    "Linear",
-    "Radial",
-    "Digital",
-    "Arc"
+    GAUGE_THEME_STRINGS(OPTION_STRING, OPTION_STRING_NEXT)
 };
+_Static_assert(sizeof(gauge_theme_string) / sizeof(gauge_theme_string[0]) == GAUGE_THEME_RESERVED, "one string per GAUGE_THEME value");
 
 static void load_view_gauge_theme(uint8_t idx_view, uint8_t idx_gauge, GAUGE_THEME *view_gauge_theme_val)
 {
-    uint8_t bytes[EE_SIZE_VIEW_GAUGE_THEME];
+    uint8_t raw[EE_SIZE_VIEW_GAUGE_THEME];
 
-    bytes[0] = read_eeprom(map_view_gauge_theme_byte1[idx_view][idx_gauge]);
+    read_eeprom_block(map_view_gauge_theme_byte1[idx_view][idx_gauge], raw, EE_SIZE_VIEW_GAUGE_THEME);
 
-    memcpy(view_gauge_theme_val, bytes, EE_SIZE_VIEW_GAUGE_THEME);
+    *view_gauge_theme_val = (GAUGE_THEME)raw[0];
 }
 
 static void save_view_gauge_theme(uint8_t idx_view, uint8_t idx_gauge, GAUGE_THEME *view_gauge_theme)
 {
-    uint8_t bytes[EE_SIZE_VIEW_GAUGE_THEME];
+    uint8_t raw[EE_SIZE_VIEW_GAUGE_THEME];
 
-    memcpy(bytes, view_gauge_theme, EE_SIZE_VIEW_GAUGE_THEME);
+    raw[0] = (uint8_t)*view_gauge_theme;
 
-    write_eeprom(map_view_gauge_theme_byte1[idx_view][idx_gauge], bytes[0]);
+    write_eeprom_block(map_view_gauge_theme_byte1[idx_view][idx_gauge], raw, EE_SIZE_VIEW_GAUGE_THEME);
 }
 
 bool verify_view_gauge_theme(GAUGE_THEME view_gauge_theme)
@@ -2315,9 +5294,7 @@ bool verify_view_gauge_theme(GAUGE_THEME view_gauge_theme)
 
 GAUGE_THEME get_view_gauge_theme(uint8_t idx_view, uint8_t idx_gauge)
 {
-    // Verify the Theme assigned to the gauge value is valid
-    if (!verify_view_gauge_theme(settings_view_gauge_theme[idx_view][idx_gauge]))
-        return DEFAULT_VIEW_GAUGE_THEME;
+    SECTION_LOAD(SETTINGS_SECTION_VIEW);
 
     return settings_view_gauge_theme[idx_view][idx_gauge];
 }
@@ -2325,6 +5302,8 @@ GAUGE_THEME get_view_gauge_theme(uint8_t idx_view, uint8_t idx_gauge)
 // Set the Theme assigned to the gauge
 bool set_view_gauge_theme(uint8_t idx_view, uint8_t idx_gauge, GAUGE_THEME view_gauge_theme, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_VIEW);
+
     // Verify the Theme assigned to the gauge value is valid
     if (!verify_view_gauge_theme(view_gauge_theme))
         return false;
@@ -2372,26 +5351,20 @@ GAUGE_THEME get_view_gauge_theme_from_string(const char *str)
 ********************************************************************************/
 static void load_view_gauge_pid(uint8_t idx_view, uint8_t idx_gauge, uint32_t *view_gauge_pid_val)
 {
-    uint8_t bytes[EE_SIZE_VIEW_GAUGE_PID];
+    uint8_t raw[EE_SIZE_VIEW_GAUGE_PID];
 
-    bytes[3] = read_eeprom(map_view_gauge_pid_byte1[idx_view][idx_gauge]);
-    bytes[2] = read_eeprom(map_view_gauge_pid_byte2[idx_view][idx_gauge]);
-    bytes[1] = read_eeprom(map_view_gauge_pid_byte3[idx_view][idx_gauge]);
-    bytes[0] = read_eeprom(map_view_gauge_pid_byte4[idx_view][idx_gauge]);
+    read_eeprom_block(map_view_gauge_pid_byte1[idx_view][idx_gauge], raw, EE_SIZE_VIEW_GAUGE_PID);
 
-    memcpy(view_gauge_pid_val, bytes, EE_SIZE_VIEW_GAUGE_PID);
+    *view_gauge_pid_val = decode_u32(raw);
 }
 
 static void save_view_gauge_pid(uint8_t idx_view, uint8_t idx_gauge, uint32_t *view_gauge_pid)
 {
-    uint8_t bytes[EE_SIZE_VIEW_GAUGE_PID];
+    uint8_t raw[EE_SIZE_VIEW_GAUGE_PID];
 
-    memcpy(bytes, view_gauge_pid, EE_SIZE_VIEW_GAUGE_PID);
+    encode_u32(raw, *view_gauge_pid);
 
-    write_eeprom(map_view_gauge_pid_byte1[idx_view][idx_gauge], bytes[3]);
-    write_eeprom(map_view_gauge_pid_byte2[idx_view][idx_gauge], bytes[2]);
-    write_eeprom(map_view_gauge_pid_byte3[idx_view][idx_gauge], bytes[1]);
-    write_eeprom(map_view_gauge_pid_byte4[idx_view][idx_gauge], bytes[0]);
+    write_eeprom_block(map_view_gauge_pid_byte1[idx_view][idx_gauge], raw, EE_SIZE_VIEW_GAUGE_PID);
 }
 
 bool verify_view_gauge_pid(uint32_t view_gauge_pid)
@@ -2408,9 +5381,7 @@ bool verify_view_gauge_pid(uint32_t view_gauge_pid)
 
 uint32_t get_view_gauge_pid(uint8_t idx_view, uint8_t idx_gauge)
 {
-    // Verify the PID assigned to the gauge value is valid
-    if (!verify_view_gauge_pid(settings_view_gauge_pid[idx_view][idx_gauge]))
-        return DEFAULT_VIEW_GAUGE_PID;
+    SECTION_LOAD(SETTINGS_SECTION_VIEW);
 
     return settings_view_gauge_pid[idx_view][idx_gauge];
 }
@@ -2418,8 +5389,11 @@ uint32_t get_view_gauge_pid(uint8_t idx_view, uint8_t idx_gauge)
 // Set the PID assigned to the gauge
 bool set_view_gauge_pid(uint8_t idx_view, uint8_t idx_gauge, uint32_t view_gauge_pid, bool save)
 {
-    // Verify the PID assigned to the gauge value is valid
-    if (!verify_view_gauge_pid(view_gauge_pid))
+    SECTION_LOAD(SETTINGS_SECTION_VIEW);
+
+    // Verify the PID assigned to the gauge value is valid, the unassigned
+    // default is accepted so the field can be reset
+    if (!verify_view_gauge_pid(view_gauge_pid) && (view_gauge_pid != DEFAULT_VIEW_GAUGE_PID))
         return false;
 
     // Check to see if the PID assigned to the gauge EEPROM value needs to be
@@ -2452,20 +5426,20 @@ bool set_view_gauge_pid(uint8_t idx_view, uint8_t idx_gauge, uint32_t view_gauge
 ********************************************************************************/
 static void load_view_gauge_units(uint8_t idx_view, uint8_t idx_gauge, PID_UNITS *view_gauge_units_val)
 {
-    uint8_t bytes[EE_SIZE_VIEW_GAUGE_UNITS];
+    uint8_t raw[EE_SIZE_VIEW_GAUGE_UNITS];
 
-    bytes[0] = read_eeprom(map_view_gauge_units_byte1[idx_view][idx_gauge]);
+    read_eeprom_block(map_view_gauge_units_byte1[idx_view][idx_gauge], raw, EE_SIZE_VIEW_GAUGE_UNITS);
 
-    memcpy(view_gauge_units_val, bytes, EE_SIZE_VIEW_GAUGE_UNITS);
+    *view_gauge_units_val = (PID_UNITS)raw[0];
 }
 
 static void save_view_gauge_units(uint8_t idx_view, uint8_t idx_gauge, PID_UNITS *view_gauge_units)
 {
-    uint8_t bytes[EE_SIZE_VIEW_GAUGE_UNITS];
+    uint8_t raw[EE_SIZE_VIEW_GAUGE_UNITS];
 
-    memcpy(bytes, view_gauge_units, EE_SIZE_VIEW_GAUGE_UNITS);
+    raw[0] = (uint8_t)*view_gauge_units;
 
-    write_eeprom(map_view_gauge_units_byte1[idx_view][idx_gauge], bytes[0]);
+    write_eeprom_block(map_view_gauge_units_byte1[idx_view][idx_gauge], raw, EE_SIZE_VIEW_GAUGE_UNITS);
 }
 
 bool verify_view_gauge_units(PID_UNITS view_gauge_units)
@@ -2482,9 +5456,7 @@ bool verify_view_gauge_units(PID_UNITS view_gauge_units)
 
 PID_UNITS get_view_gauge_units(uint8_t idx_view, uint8_t idx_gauge)
 {
-    // Verify the PID units assigned to the gauge value is valid
-    if (!verify_view_gauge_units(settings_view_gauge_units[idx_view][idx_gauge]))
-        return DEFAULT_VIEW_GAUGE_UNITS;
+    SECTION_LOAD(SETTINGS_SECTION_VIEW);
 
     return settings_view_gauge_units[idx_view][idx_gauge];
 }
@@ -2492,6 +5464,8 @@ PID_UNITS get_view_gauge_units(uint8_t idx_view, uint8_t idx_gauge)
 // Set the PID units assigned to the gauge
 bool set_view_gauge_units(uint8_t idx_view, uint8_t idx_gauge, PID_UNITS view_gauge_units, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_VIEW);
+
     // Verify the PID units assigned to the gauge value is valid
     if (!verify_view_gauge_units(view_gauge_units))
         return false;
@@ -2524,26 +5498,26 @@ bool set_view_gauge_units(uint8_t idx_view, uint8_t idx_gauge, PID_UNITS view_ga
 *
 ********************************************************************************/
 const char *alert_state_string[] = {
-    "Disabled",
-    "Enabled"
+    ALERT_STATE_STRINGS(OPTION_STRING, OPTION_STRING_NEXT)
 };
+_Static_assert(sizeof(alert_state_string) / sizeof(alert_state_string[0]) == ALERT_STATE_RESERVED, "one string per ALERT_STATE value");
 
 static void load_alert_enable(uint8_t idx, ALERT_STATE *alert_enable_val)
 {
-    uint8_t bytes[EE_SIZE_ALERT_ENABLE];
+    uint8_t raw[EE_SIZE_ALERT_ENABLE];
 
-    bytes[0] = read_eeprom(map_alert_enable_byte1[idx]);
+    read_eeprom_block(map_alert_enable_byte1[idx], raw, EE_SIZE_ALERT_ENABLE);
 
-    memcpy(alert_enable_val, bytes, EE_SIZE_ALERT_ENABLE);
+    *alert_enable_val = (ALERT_STATE)raw[0];
 }
 
 static void save_alert_enable(uint8_t idx, ALERT_STATE *alert_enable)
 {
-    uint8_t bytes[EE_SIZE_ALERT_ENABLE];
+    uint8_t raw[EE_SIZE_ALERT_ENABLE];
 
-    memcpy(bytes, alert_enable, EE_SIZE_ALERT_ENABLE);
+    raw[0] = (uint8_t)*alert_enable;
 
-    write_eeprom(map_alert_enable_byte1[idx], bytes[0]);
+    write_eeprom_block(map_alert_enable_byte1[idx], raw, EE_SIZE_ALERT_ENABLE);
 }
 
 bool verify_alert_enable(ALERT_STATE alert_enable)
@@ -2556,9 +5530,7 @@ bool verify_alert_enable(ALERT_STATE alert_enable)
 
 ALERT_STATE get_alert_enable(uint8_t idx)
 {
-    // Verify the Alert enable value is valid
-    if (!verify_alert_enable(settings_alert_enable[idx]))
-        return DEFAULT_ALERT_ENABLE;
+    SECTION_LOAD(SETTINGS_SECTION_ALERT);
 
     return settings_alert_enable[idx];
 }
@@ -2566,6 +5538,8 @@ ALERT_STATE get_alert_enable(uint8_t idx)
 // Set the Alert enable
 bool set_alert_enable(uint8_t idx, ALERT_STATE alert_enable, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_ALERT);
+
     // Verify the Alert enable value is valid
     if (!verify_alert_enable(alert_enable))
         return false;
@@ -2607,26 +5581,20 @@ ALERT_STATE get_alert_enable_from_string(const char *str)
 ********************************************************************************/
 static void load_alert_pid(uint8_t idx, uint32_t *alert_pid_val)
 {
-    uint8_t bytes[EE_SIZE_ALERT_PID];
+    uint8_t raw[EE_SIZE_ALERT_PID];
 
-    bytes[3] = read_eeprom(map_alert_pid_byte1[idx]);
-    bytes[2] = read_eeprom(map_alert_pid_byte2[idx]);
-    bytes[1] = read_eeprom(map_alert_pid_byte3[idx]);
-    bytes[0] = read_eeprom(map_alert_pid_byte4[idx]);
+    read_eeprom_block(map_alert_pid_byte1[idx], raw, EE_SIZE_ALERT_PID);
 
-    memcpy(alert_pid_val, bytes, EE_SIZE_ALERT_PID);
+    *alert_pid_val = decode_u32(raw);
 }
 
 static void save_alert_pid(uint8_t idx, uint32_t *alert_pid)
 {
-    uint8_t bytes[EE_SIZE_ALERT_PID];
+    uint8_t raw[EE_SIZE_ALERT_PID];
 
-    memcpy(bytes, alert_pid, EE_SIZE_ALERT_PID);
+    encode_u32(raw, *alert_pid);
 
-    write_eeprom(map_alert_pid_byte1[idx], bytes[3]);
-    write_eeprom(map_alert_pid_byte2[idx], bytes[2]);
-    write_eeprom(map_alert_pid_byte3[idx], bytes[1]);
-    write_eeprom(map_alert_pid_byte4[idx], bytes[0]);
+    write_eeprom_block(map_alert_pid_byte1[idx], raw, EE_SIZE_ALERT_PID);
 }
 
 bool verify_alert_pid(uint32_t alert_pid)
@@ -2643,9 +5611,7 @@ bool verify_alert_pid(uint32_t alert_pid)
 
 uint32_t get_alert_pid(uint8_t idx)
 {
-    // Verify the PID assigned to the alert value is valid
-    if (!verify_alert_pid(settings_alert_pid[idx]))
-        return DEFAULT_ALERT_PID;
+    SECTION_LOAD(SETTINGS_SECTION_ALERT);
 
     return settings_alert_pid[idx];
 }
@@ -2653,8 +5619,11 @@ uint32_t get_alert_pid(uint8_t idx)
 // Set the PID assigned to the alert
 bool set_alert_pid(uint8_t idx, uint32_t alert_pid, bool save)
 {
-    // Verify the PID assigned to the alert value is valid
-    if (!verify_alert_pid(alert_pid))
+    SECTION_LOAD(SETTINGS_SECTION_ALERT);
+
+    // Verify the PID assigned to the alert value is valid, the unassigned
+    // default is accepted so the field can be reset
+    if (!verify_alert_pid(alert_pid) && (alert_pid != DEFAULT_ALERT_PID))
         return false;
 
     // Check to see if the PID assigned to the alert EEPROM value needs to be
@@ -2686,20 +5655,20 @@ bool set_alert_pid(uint8_t idx, uint32_t alert_pid, bool save)
 ********************************************************************************/
 static void load_alert_units(uint8_t idx, PID_UNITS *alert_units_val)
 {
-    uint8_t bytes[EE_SIZE_ALERT_UNITS];
+    uint8_t raw[EE_SIZE_ALERT_UNITS];
 
-    bytes[0] = read_eeprom(map_alert_units_byte1[idx]);
+    read_eeprom_block(map_alert_units_byte1[idx], raw, EE_SIZE_ALERT_UNITS);
 
-    memcpy(alert_units_val, bytes, EE_SIZE_ALERT_UNITS);
+    *alert_units_val = (PID_UNITS)raw[0];
 }
 
 static void save_alert_units(uint8_t idx, PID_UNITS *alert_units)
 {
-    uint8_t bytes[EE_SIZE_ALERT_UNITS];
+    uint8_t raw[EE_SIZE_ALERT_UNITS];
 
-    memcpy(bytes, alert_units, EE_SIZE_ALERT_UNITS);
+    raw[0] = (uint8_t)*alert_units;
 
-    write_eeprom(map_alert_units_byte1[idx], bytes[0]);
+    write_eeprom_block(map_alert_units_byte1[idx], raw, EE_SIZE_ALERT_UNITS);
 }
 
 bool verify_alert_units(PID_UNITS alert_units)
@@ -2716,9 +5685,7 @@ bool verify_alert_units(PID_UNITS alert_units)
 
 PID_UNITS get_alert_units(uint8_t idx)
 {
-    // Verify the PID units assigned to the alert value is valid
-    if (!verify_alert_units(settings_alert_units[idx]))
-        return DEFAULT_ALERT_UNITS;
+    SECTION_LOAD(SETTINGS_SECTION_ALERT);
 
     return settings_alert_units[idx];
 }
@@ -2726,6 +5693,8 @@ PID_UNITS get_alert_units(uint8_t idx)
 // Set the PID units assigned to the alert
 bool set_alert_units(uint8_t idx, PID_UNITS alert_units, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_ALERT);
+
     // Verify the PID units assigned to the alert value is valid
     if (!verify_alert_units(alert_units))
         return false;
@@ -2759,146 +5728,12 @@ bool set_alert_units(uint8_t idx, PID_UNITS alert_units, bool save)
 ********************************************************************************/
 static void load_alert_message(uint8_t idx, char *alert_message_val)
 {
-    uint8_t bytes[EE_SIZE_ALERT_MESSAGE];
-
-    bytes[63] = read_eeprom(map_alert_message_byte1[idx]);
-    bytes[62] = read_eeprom(map_alert_message_byte2[idx]);
-    bytes[61] = read_eeprom(map_alert_message_byte3[idx]);
-    bytes[60] = read_eeprom(map_alert_message_byte4[idx]);
-    bytes[59] = read_eeprom(map_alert_message_byte5[idx]);
-    bytes[58] = read_eeprom(map_alert_message_byte6[idx]);
-    bytes[57] = read_eeprom(map_alert_message_byte7[idx]);
-    bytes[56] = read_eeprom(map_alert_message_byte8[idx]);
-    bytes[55] = read_eeprom(map_alert_message_byte9[idx]);
-    bytes[54] = read_eeprom(map_alert_message_byte10[idx]);
-    bytes[53] = read_eeprom(map_alert_message_byte11[idx]);
-    bytes[52] = read_eeprom(map_alert_message_byte12[idx]);
-    bytes[51] = read_eeprom(map_alert_message_byte13[idx]);
-    bytes[50] = read_eeprom(map_alert_message_byte14[idx]);
-    bytes[49] = read_eeprom(map_alert_message_byte15[idx]);
-    bytes[48] = read_eeprom(map_alert_message_byte16[idx]);
-    bytes[47] = read_eeprom(map_alert_message_byte17[idx]);
-    bytes[46] = read_eeprom(map_alert_message_byte18[idx]);
-    bytes[45] = read_eeprom(map_alert_message_byte19[idx]);
-    bytes[44] = read_eeprom(map_alert_message_byte20[idx]);
-    bytes[43] = read_eeprom(map_alert_message_byte21[idx]);
-    bytes[42] = read_eeprom(map_alert_message_byte22[idx]);
-    bytes[41] = read_eeprom(map_alert_message_byte23[idx]);
-    bytes[40] = read_eeprom(map_alert_message_byte24[idx]);
-    bytes[39] = read_eeprom(map_alert_message_byte25[idx]);
-    bytes[38] = read_eeprom(map_alert_message_byte26[idx]);
-    bytes[37] = read_eeprom(map_alert_message_byte27[idx]);
-    bytes[36] = read_eeprom(map_alert_message_byte28[idx]);
-    bytes[35] = read_eeprom(map_alert_message_byte29[idx]);
-    bytes[34] = read_eeprom(map_alert_message_byte30[idx]);
-    bytes[33] = read_eeprom(map_alert_message_byte31[idx]);
-    bytes[32] = read_eeprom(map_alert_message_byte32[idx]);
-    bytes[31] = read_eeprom(map_alert_message_byte33[idx]);
-    bytes[30] = read_eeprom(map_alert_message_byte34[idx]);
-    bytes[29] = read_eeprom(map_alert_message_byte35[idx]);
-    bytes[28] = read_eeprom(map_alert_message_byte36[idx]);
-    bytes[27] = read_eeprom(map_alert_message_byte37[idx]);
-    bytes[26] = read_eeprom(map_alert_message_byte38[idx]);
-    bytes[25] = read_eeprom(map_alert_message_byte39[idx]);
-    bytes[24] = read_eeprom(map_alert_message_byte40[idx]);
-    bytes[23] = read_eeprom(map_alert_message_byte41[idx]);
-    bytes[22] = read_eeprom(map_alert_message_byte42[idx]);
-    bytes[21] = read_eeprom(map_alert_message_byte43[idx]);
-    bytes[20] = read_eeprom(map_alert_message_byte44[idx]);
-    bytes[19] = read_eeprom(map_alert_message_byte45[idx]);
-    bytes[18] = read_eeprom(map_alert_message_byte46[idx]);
-    bytes[17] = read_eeprom(map_alert_message_byte47[idx]);
-    bytes[16] = read_eeprom(map_alert_message_byte48[idx]);
-    bytes[15] = read_eeprom(map_alert_message_byte49[idx]);
-    bytes[14] = read_eeprom(map_alert_message_byte50[idx]);
-    bytes[13] = read_eeprom(map_alert_message_byte51[idx]);
-    bytes[12] = read_eeprom(map_alert_message_byte52[idx]);
-    bytes[11] = read_eeprom(map_alert_message_byte53[idx]);
-    bytes[10] = read_eeprom(map_alert_message_byte54[idx]);
-    bytes[9] = read_eeprom(map_alert_message_byte55[idx]);
-    bytes[8] = read_eeprom(map_alert_message_byte56[idx]);
-    bytes[7] = read_eeprom(map_alert_message_byte57[idx]);
-    bytes[6] = read_eeprom(map_alert_message_byte58[idx]);
-    bytes[5] = read_eeprom(map_alert_message_byte59[idx]);
-    bytes[4] = read_eeprom(map_alert_message_byte60[idx]);
-    bytes[3] = read_eeprom(map_alert_message_byte61[idx]);
-    bytes[2] = read_eeprom(map_alert_message_byte62[idx]);
-    bytes[1] = read_eeprom(map_alert_message_byte63[idx]);
-    bytes[0] = read_eeprom(map_alert_message_byte64[idx]);
-
-    memcpy(alert_message_val, bytes, EE_SIZE_ALERT_MESSAGE);
+    read_eeprom_block(map_alert_message_byte1[idx], (uint8_t *)alert_message_val, EE_SIZE_ALERT_MESSAGE);
 }
 
 static void save_alert_message(uint8_t idx, char *alert_message)
 {
-    uint8_t bytes[EE_SIZE_ALERT_MESSAGE];
-
-    memcpy(bytes, alert_message, EE_SIZE_ALERT_MESSAGE);
-
-    write_eeprom(map_alert_message_byte1[idx], bytes[63]);
-    write_eeprom(map_alert_message_byte2[idx], bytes[62]);
-    write_eeprom(map_alert_message_byte3[idx], bytes[61]);
-    write_eeprom(map_alert_message_byte4[idx], bytes[60]);
-    write_eeprom(map_alert_message_byte5[idx], bytes[59]);
-    write_eeprom(map_alert_message_byte6[idx], bytes[58]);
-    write_eeprom(map_alert_message_byte7[idx], bytes[57]);
-    write_eeprom(map_alert_message_byte8[idx], bytes[56]);
-    write_eeprom(map_alert_message_byte9[idx], bytes[55]);
-    write_eeprom(map_alert_message_byte10[idx], bytes[54]);
-    write_eeprom(map_alert_message_byte11[idx], bytes[53]);
-    write_eeprom(map_alert_message_byte12[idx], bytes[52]);
-    write_eeprom(map_alert_message_byte13[idx], bytes[51]);
-    write_eeprom(map_alert_message_byte14[idx], bytes[50]);
-    write_eeprom(map_alert_message_byte15[idx], bytes[49]);
-    write_eeprom(map_alert_message_byte16[idx], bytes[48]);
-    write_eeprom(map_alert_message_byte17[idx], bytes[47]);
-    write_eeprom(map_alert_message_byte18[idx], bytes[46]);
-    write_eeprom(map_alert_message_byte19[idx], bytes[45]);
-    write_eeprom(map_alert_message_byte20[idx], bytes[44]);
-    write_eeprom(map_alert_message_byte21[idx], bytes[43]);
-    write_eeprom(map_alert_message_byte22[idx], bytes[42]);
-    write_eeprom(map_alert_message_byte23[idx], bytes[41]);
-    write_eeprom(map_alert_message_byte24[idx], bytes[40]);
-    write_eeprom(map_alert_message_byte25[idx], bytes[39]);
-    write_eeprom(map_alert_message_byte26[idx], bytes[38]);
-    write_eeprom(map_alert_message_byte27[idx], bytes[37]);
-    write_eeprom(map_alert_message_byte28[idx], bytes[36]);
-    write_eeprom(map_alert_message_byte29[idx], bytes[35]);
-    write_eeprom(map_alert_message_byte30[idx], bytes[34]);
-    write_eeprom(map_alert_message_byte31[idx], bytes[33]);
-    write_eeprom(map_alert_message_byte32[idx], bytes[32]);
-    write_eeprom(map_alert_message_byte33[idx], bytes[31]);
-    write_eeprom(map_alert_message_byte34[idx], bytes[30]);
-    write_eeprom(map_alert_message_byte35[idx], bytes[29]);
-    write_eeprom(map_alert_message_byte36[idx], bytes[28]);
-    write_eeprom(map_alert_message_byte37[idx], bytes[27]);
-    write_eeprom(map_alert_message_byte38[idx], bytes[26]);
-    write_eeprom(map_alert_message_byte39[idx], bytes[25]);
-    write_eeprom(map_alert_message_byte40[idx], bytes[24]);
-    write_eeprom(map_alert_message_byte41[idx], bytes[23]);
-    write_eeprom(map_alert_message_byte42[idx], bytes[22]);
-    write_eeprom(map_alert_message_byte43[idx], bytes[21]);
-    write_eeprom(map_alert_message_byte44[idx], bytes[20]);
-    write_eeprom(map_alert_message_byte45[idx], bytes[19]);
-    write_eeprom(map_alert_message_byte46[idx], bytes[18]);
-    write_eeprom(map_alert_message_byte47[idx], bytes[17]);
-    write_eeprom(map_alert_message_byte48[idx], bytes[16]);
-    write_eeprom(map_alert_message_byte49[idx], bytes[15]);
-    write_eeprom(map_alert_message_byte50[idx], bytes[14]);
-    write_eeprom(map_alert_message_byte51[idx], bytes[13]);
-    write_eeprom(map_alert_message_byte52[idx], bytes[12]);
-    write_eeprom(map_alert_message_byte53[idx], bytes[11]);
-    write_eeprom(map_alert_message_byte54[idx], bytes[10]);
-    write_eeprom(map_alert_message_byte55[idx], bytes[9]);
-    write_eeprom(map_alert_message_byte56[idx], bytes[8]);
-    write_eeprom(map_alert_message_byte57[idx], bytes[7]);
-    write_eeprom(map_alert_message_byte58[idx], bytes[6]);
-    write_eeprom(map_alert_message_byte59[idx], bytes[5]);
-    write_eeprom(map_alert_message_byte60[idx], bytes[4]);
-    write_eeprom(map_alert_message_byte61[idx], bytes[3]);
-    write_eeprom(map_alert_message_byte62[idx], bytes[2]);
-    write_eeprom(map_alert_message_byte63[idx], bytes[1]);
-    write_eeprom(map_alert_message_byte64[idx], bytes[0]);
+    write_eeprom_block(map_alert_message_byte1[idx], (const uint8_t *)alert_message, EE_SIZE_ALERT_MESSAGE);
 }
 
 bool verify_alert_message(char* alert_message)
@@ -2908,12 +5743,16 @@ bool verify_alert_message(char* alert_message)
 
 void get_alert_message(uint8_t idx, char* alert_message)
 {
+    SECTION_LOAD(SETTINGS_SECTION_ALERT);
+
     memcpy(alert_message, settings_alert_message[idx], ALERT_MESSAGE_LEN);
 }
 
 // Set the Alert message
 bool set_alert_message(uint8_t idx, char* alert_message, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_ALERT);
+
     // Verify the Alert message value is valid
     if (!verify_alert_message(alert_message))
         return false;
@@ -2946,30 +5785,26 @@ bool set_alert_message(uint8_t idx, char* alert_message, bool save)
 *
 ********************************************************************************/
 const char *alert_comparison_string[] = {
-    "Less Than",
-    "Less Than Or Equal To",
-    "Greater Than",
-    "Greater Than Or Equal To",
-    "Equal",
-    "Not Equal"
+    ALERT_COMPARISON_STRINGS(OPTION_STRING, OPTION_STRING_NEXT)
 };
+_Static_assert(sizeof(alert_comparison_string) / sizeof(alert_comparison_string[0]) == ALERT_COMPARISON_RESERVED, "one string per ALERT_COMPARISON value");
 
 static void load_alert_compare(uint8_t idx, ALERT_COMPARISON *alert_compare_val)
 {
-    uint8_t bytes[EE_SIZE_ALERT_COMPARE];
+    uint8_t raw[EE_SIZE_ALERT_COMPARE];
 
-    bytes[0] = read_eeprom(map_alert_compare_byte1[idx]);
+    read_eeprom_block(map_alert_compare_byte1[idx], raw, EE_SIZE_ALERT_COMPARE);
 
-    memcpy(alert_compare_val, bytes, EE_SIZE_ALERT_COMPARE);
+    *alert_compare_val = (ALERT_COMPARISON)raw[0];
 }
 
 static void save_alert_compare(uint8_t idx, ALERT_COMPARISON *alert_compare)
 {
-    uint8_t bytes[EE_SIZE_ALERT_COMPARE];
+    uint8_t raw[EE_SIZE_ALERT_COMPARE];
 
-    memcpy(bytes, alert_compare, EE_SIZE_ALERT_COMPARE);
+    raw[0] = (uint8_t)*alert_compare;
 
-    write_eeprom(map_alert_compare_byte1[idx], bytes[0]);
+    write_eeprom_block(map_alert_compare_byte1[idx], raw, EE_SIZE_ALERT_COMPARE);
 }
 
 bool verify_alert_compare(ALERT_COMPARISON alert_compare)
@@ -2982,9 +5817,7 @@ bool verify_alert_compare(ALERT_COMPARISON alert_compare)
 
 ALERT_COMPARISON get_alert_compare(uint8_t idx)
 {
-    // Verify the Comparison type value is valid
-    if (!verify_alert_compare(settings_alert_compare[idx]))
-        return DEFAULT_ALERT_COMPARE;
+    SECTION_LOAD(SETTINGS_SECTION_ALERT);
 
     return settings_alert_compare[idx];
 }
@@ -2992,6 +5825,8 @@ ALERT_COMPARISON get_alert_compare(uint8_t idx)
 // Set the Comparison type
 bool set_alert_compare(uint8_t idx, ALERT_COMPARISON alert_compare, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_ALERT);
+
     // Verify the Comparison type value is valid
     if (!verify_alert_compare(alert_compare))
         return false;
@@ -3037,26 +5872,20 @@ ALERT_COMPARISON get_alert_compare_from_string(const char *str)
 ********************************************************************************/
 static void load_alert_threshold(uint8_t idx, float *alert_threshold_val)
 {
-    uint8_t bytes[EE_SIZE_ALERT_THRESHOLD];
+    uint8_t raw[EE_SIZE_ALERT_THRESHOLD];
 
-    bytes[3] = read_eeprom(map_alert_threshold_byte1[idx]);
-    bytes[2] = read_eeprom(map_alert_threshold_byte2[idx]);
-    bytes[1] = read_eeprom(map_alert_threshold_byte3[idx]);
-    bytes[0] = read_eeprom(map_alert_threshold_byte4[idx]);
+    read_eeprom_block(map_alert_threshold_byte1[idx], raw, EE_SIZE_ALERT_THRESHOLD);
 
-    memcpy(alert_threshold_val, bytes, EE_SIZE_ALERT_THRESHOLD);
+    *alert_threshold_val = decode_float(raw);
 }
 
 static void save_alert_threshold(uint8_t idx, float *alert_threshold)
 {
-    uint8_t bytes[EE_SIZE_ALERT_THRESHOLD];
+    uint8_t raw[EE_SIZE_ALERT_THRESHOLD];
 
-    memcpy(bytes, alert_threshold, EE_SIZE_ALERT_THRESHOLD);
+    encode_float(raw, *alert_threshold);
 
-    write_eeprom(map_alert_threshold_byte1[idx], bytes[3]);
-    write_eeprom(map_alert_threshold_byte2[idx], bytes[2]);
-    write_eeprom(map_alert_threshold_byte3[idx], bytes[1]);
-    write_eeprom(map_alert_threshold_byte4[idx], bytes[0]);
+    write_eeprom_block(map_alert_threshold_byte1[idx], raw, EE_SIZE_ALERT_THRESHOLD);
 }
 
 bool verify_alert_threshold(float alert_threshold)
@@ -3073,9 +5902,7 @@ bool verify_alert_threshold(float alert_threshold)
 
 float get_alert_threshold(uint8_t idx)
 {
-    // Verify the Alert threshold value is valid
-    if (!verify_alert_threshold(settings_alert_threshold[idx]))
-        return DEFAULT_ALERT_THRESHOLD;
+    SECTION_LOAD(SETTINGS_SECTION_ALERT);
 
     return settings_alert_threshold[idx];
 }
@@ -3083,6 +5910,8 @@ float get_alert_threshold(uint8_t idx)
 // Set the Alert threshold
 bool set_alert_threshold(uint8_t idx, float alert_threshold, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_ALERT);
+
     // Verify the Alert threshold value is valid
     if (!verify_alert_threshold(alert_threshold))
         return false;
@@ -3115,26 +5944,26 @@ bool set_alert_threshold(uint8_t idx, float alert_threshold, bool save)
 *
 ********************************************************************************/
 const char *dynamic_state_string[] = {
-    "Disabled",
-    "Enabled"
+    DYNAMIC_STATE_STRINGS(OPTION_STRING, OPTION_STRING_NEXT)
 };
+_Static_assert(sizeof(dynamic_state_string) / sizeof(dynamic_state_string[0]) == DYNAMIC_STATE_RESERVED, "one string per DYNAMIC_STATE value");
 
 static void load_dynamic_enable(uint8_t idx, DYNAMIC_STATE *dynamic_enable_val)
 {
-    uint8_t bytes[EE_SIZE_DYNAMIC_ENABLE];
+    uint8_t raw[EE_SIZE_DYNAMIC_ENABLE];
 
-    bytes[0] = read_eeprom(map_dynamic_enable_byte1[idx]);
+    read_eeprom_block(map_dynamic_enable_byte1[idx], raw, EE_SIZE_DYNAMIC_ENABLE);
 
-    memcpy(dynamic_enable_val, bytes, EE_SIZE_DYNAMIC_ENABLE);
+    *dynamic_enable_val = (DYNAMIC_STATE)raw[0];
 }
 
 static void save_dynamic_enable(uint8_t idx, DYNAMIC_STATE *dynamic_enable)
 {
-    uint8_t bytes[EE_SIZE_DYNAMIC_ENABLE];
+    uint8_t raw[EE_SIZE_DYNAMIC_ENABLE];
 
-    memcpy(bytes, dynamic_enable, EE_SIZE_DYNAMIC_ENABLE);
+    raw[0] = (uint8_t)*dynamic_enable;
 
-    write_eeprom(map_dynamic_enable_byte1[idx], bytes[0]);
+    write_eeprom_block(map_dynamic_enable_byte1[idx], raw, EE_SIZE_DYNAMIC_ENABLE);
 }
 
 bool verify_dynamic_enable(DYNAMIC_STATE dynamic_enable)
@@ -3147,9 +5976,7 @@ bool verify_dynamic_enable(DYNAMIC_STATE dynamic_enable)
 
 DYNAMIC_STATE get_dynamic_enable(uint8_t idx)
 {
-    // Verify the Dynamic enable value is valid
-    if (!verify_dynamic_enable(settings_dynamic_enable[idx]))
-        return DEFAULT_DYNAMIC_ENABLE;
+    SECTION_LOAD(SETTINGS_SECTION_DYNAMIC);
 
     return settings_dynamic_enable[idx];
 }
@@ -3157,6 +5984,8 @@ DYNAMIC_STATE get_dynamic_enable(uint8_t idx)
 // Set the Dynamic enable
 bool set_dynamic_enable(uint8_t idx, DYNAMIC_STATE dynamic_enable, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_DYNAMIC);
+
     // Verify the Dynamic enable value is valid
     if (!verify_dynamic_enable(dynamic_enable))
         return false;
@@ -3197,27 +6026,26 @@ DYNAMIC_STATE get_dynamic_enable_from_string(const char *str)
 *
 ********************************************************************************/
 const char *dynamic_priority_string[] = {
-    "Low",
-    "Medium",
-    "High"
+    DYNAMIC_PRIORITY_STRINGS(OPTION_STRING, OPTION_STRING_NEXT)
 };
+_Static_assert(sizeof(dynamic_priority_string) / sizeof(dynamic_priority_string[0]) == DYNAMIC_PRIORITY_RESERVED, "one string per DYNAMIC_PRIORITY value");
 
 static void load_dynamic_priority(uint8_t idx, DYNAMIC_PRIORITY *dynamic_priority_val)
 {
-    uint8_t bytes[EE_SIZE_DYNAMIC_PRIORITY];
+    uint8_t raw[EE_SIZE_DYNAMIC_PRIORITY];
 
-    bytes[0] = read_eeprom(map_dynamic_priority_byte1[idx]);
+    read_eeprom_block(map_dynamic_priority_byte1[idx], raw, EE_SIZE_DYNAMIC_PRIORITY);
 
-    memcpy(dynamic_priority_val, bytes, EE_SIZE_DYNAMIC_PRIORITY);
+    *dynamic_priority_val = (DYNAMIC_PRIORITY)raw[0];
 }
 
 static void save_dynamic_priority(uint8_t idx, DYNAMIC_PRIORITY *dynamic_priority)
 {
-    uint8_t bytes[EE_SIZE_DYNAMIC_PRIORITY];
+    uint8_t raw[EE_SIZE_DYNAMIC_PRIORITY];
 
-    memcpy(bytes, dynamic_priority, EE_SIZE_DYNAMIC_PRIORITY);
+    raw[0] = (uint8_t)*dynamic_priority;
 
-    write_eeprom(map_dynamic_priority_byte1[idx], bytes[0]);
+    write_eeprom_block(map_dynamic_priority_byte1[idx], raw, EE_SIZE_DYNAMIC_PRIORITY);
 }
 
 bool verify_dynamic_priority(DYNAMIC_PRIORITY dynamic_priority)
@@ -3230,9 +6058,7 @@ bool verify_dynamic_priority(DYNAMIC_PRIORITY dynamic_priority)
 
 DYNAMIC_PRIORITY get_dynamic_priority(uint8_t idx)
 {
-    // Verify the Priority value is valid
-    if (!verify_dynamic_priority(settings_dynamic_priority[idx]))
-        return DEFAULT_DYNAMIC_PRIORITY;
+    SECTION_LOAD(SETTINGS_SECTION_DYNAMIC);
 
     return settings_dynamic_priority[idx];
 }
@@ -3240,6 +6066,8 @@ DYNAMIC_PRIORITY get_dynamic_priority(uint8_t idx)
 // Set the Priority
 bool set_dynamic_priority(uint8_t idx, DYNAMIC_PRIORITY dynamic_priority, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_DYNAMIC);
+
     // Verify the Priority value is valid
     if (!verify_dynamic_priority(dynamic_priority))
         return false;
@@ -3281,30 +6109,26 @@ DYNAMIC_PRIORITY get_dynamic_priority_from_string(const char *str)
 *
 ********************************************************************************/
 const char *dynamic_comparison_string[] = {
-    "Less Than",
-    "Less Than Or Equal To",
-    "Greater Than",
-    "Greater Than Or Equal To",
-    "Equal",
-    "Not Equal"
+    DYNAMIC_COMPARISON_STRINGS(OPTION_STRING, OPTION_STRING_NEXT)
 };
+_Static_assert(sizeof(dynamic_comparison_string) / sizeof(dynamic_comparison_string[0]) == DYNAMIC_COMPARISON_RESERVED, "one string per DYNAMIC_COMPARISON value");
 
 static void load_dynamic_compare(uint8_t idx, DYNAMIC_COMPARISON *dynamic_compare_val)
 {
-    uint8_t bytes[EE_SIZE_DYNAMIC_COMPARE];
+    uint8_t raw[EE_SIZE_DYNAMIC_COMPARE];
 
-    bytes[0] = read_eeprom(map_dynamic_compare_byte1[idx]);
+    read_eeprom_block(map_dynamic_compare_byte1[idx], raw, EE_SIZE_DYNAMIC_COMPARE);
 
-    memcpy(dynamic_compare_val, bytes, EE_SIZE_DYNAMIC_COMPARE);
+    *dynamic_compare_val = (DYNAMIC_COMPARISON)raw[0];
 }
 
 static void save_dynamic_compare(uint8_t idx, DYNAMIC_COMPARISON *dynamic_compare)
 {
-    uint8_t bytes[EE_SIZE_DYNAMIC_COMPARE];
+    uint8_t raw[EE_SIZE_DYNAMIC_COMPARE];
 
-    memcpy(bytes, dynamic_compare, EE_SIZE_DYNAMIC_COMPARE);
+    raw[0] = (uint8_t)*dynamic_compare;
 
-    write_eeprom(map_dynamic_compare_byte1[idx], bytes[0]);
+    write_eeprom_block(map_dynamic_compare_byte1[idx], raw, EE_SIZE_DYNAMIC_COMPARE);
 }
 
 bool verify_dynamic_compare(DYNAMIC_COMPARISON dynamic_compare)
@@ -3317,9 +6141,7 @@ bool verify_dynamic_compare(DYNAMIC_COMPARISON dynamic_compare)
 
 DYNAMIC_COMPARISON get_dynamic_compare(uint8_t idx)
 {
-    // Verify the Comparison type value is valid
-    if (!verify_dynamic_compare(settings_dynamic_compare[idx]))
-        return DEFAULT_DYNAMIC_COMPARE;
+    SECTION_LOAD(SETTINGS_SECTION_DYNAMIC);
 
     return settings_dynamic_compare[idx];
 }
@@ -3327,6 +6149,8 @@ DYNAMIC_COMPARISON get_dynamic_compare(uint8_t idx)
 // Set the Comparison type
 bool set_dynamic_compare(uint8_t idx, DYNAMIC_COMPARISON dynamic_compare, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_DYNAMIC);
+
     // Verify the Comparison type value is valid
     if (!verify_dynamic_compare(dynamic_compare))
         return false;
@@ -3372,26 +6196,20 @@ DYNAMIC_COMPARISON get_dynamic_compare_from_string(const char *str)
 ********************************************************************************/
 static void load_dynamic_threshold(uint8_t idx, float *dynamic_threshold_val)
 {
-    uint8_t bytes[EE_SIZE_DYNAMIC_THRESHOLD];
+    uint8_t raw[EE_SIZE_DYNAMIC_THRESHOLD];
 
-    bytes[3] = read_eeprom(map_dynamic_threshold_byte1[idx]);
-    bytes[2] = read_eeprom(map_dynamic_threshold_byte2[idx]);
-    bytes[1] = read_eeprom(map_dynamic_threshold_byte3[idx]);
-    bytes[0] = read_eeprom(map_dynamic_threshold_byte4[idx]);
+    read_eeprom_block(map_dynamic_threshold_byte1[idx], raw, EE_SIZE_DYNAMIC_THRESHOLD);
 
-    memcpy(dynamic_threshold_val, bytes, EE_SIZE_DYNAMIC_THRESHOLD);
+    *dynamic_threshold_val = decode_float(raw);
 }
 
 static void save_dynamic_threshold(uint8_t idx, float *dynamic_threshold)
 {
-    uint8_t bytes[EE_SIZE_DYNAMIC_THRESHOLD];
+    uint8_t raw[EE_SIZE_DYNAMIC_THRESHOLD];
 
-    memcpy(bytes, dynamic_threshold, EE_SIZE_DYNAMIC_THRESHOLD);
+    encode_float(raw, *dynamic_threshold);
 
-    write_eeprom(map_dynamic_threshold_byte1[idx], bytes[3]);
-    write_eeprom(map_dynamic_threshold_byte2[idx], bytes[2]);
-    write_eeprom(map_dynamic_threshold_byte3[idx], bytes[1]);
-    write_eeprom(map_dynamic_threshold_byte4[idx], bytes[0]);
+    write_eeprom_block(map_dynamic_threshold_byte1[idx], raw, EE_SIZE_DYNAMIC_THRESHOLD);
 }
 
 bool verify_dynamic_threshold(float dynamic_threshold)
@@ -3408,9 +6226,7 @@ bool verify_dynamic_threshold(float dynamic_threshold)
 
 float get_dynamic_threshold(uint8_t idx)
 {
-    // Verify the Dynamic gauge threshold value is valid
-    if (!verify_dynamic_threshold(settings_dynamic_threshold[idx]))
-        return DEFAULT_DYNAMIC_THRESHOLD;
+    SECTION_LOAD(SETTINGS_SECTION_DYNAMIC);
 
     return settings_dynamic_threshold[idx];
 }
@@ -3418,6 +6234,8 @@ float get_dynamic_threshold(uint8_t idx)
 // Set the Dynamic gauge threshold
 bool set_dynamic_threshold(uint8_t idx, float dynamic_threshold, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_DYNAMIC);
+
     // Verify the Dynamic gauge threshold value is valid
     if (!verify_dynamic_threshold(dynamic_threshold))
         return false;
@@ -3451,20 +6269,20 @@ bool set_dynamic_threshold(uint8_t idx, float dynamic_threshold, bool save)
 ********************************************************************************/
 static void load_dynamic_view_index(uint8_t idx, uint8_t *dynamic_view_index_val)
 {
-    uint8_t bytes[EE_SIZE_DYNAMIC_VIEW_INDEX];
+    uint8_t raw[EE_SIZE_DYNAMIC_VIEW_INDEX];
 
-    bytes[0] = read_eeprom(map_dynamic_view_index_byte1[idx]);
+    read_eeprom_block(map_dynamic_view_index_byte1[idx], raw, EE_SIZE_DYNAMIC_VIEW_INDEX);
 
-    memcpy(dynamic_view_index_val, bytes, EE_SIZE_DYNAMIC_VIEW_INDEX);
+    *dynamic_view_index_val = raw[0];
 }
 
 static void save_dynamic_view_index(uint8_t idx, uint8_t *dynamic_view_index)
 {
-    uint8_t bytes[EE_SIZE_DYNAMIC_VIEW_INDEX];
+    uint8_t raw[EE_SIZE_DYNAMIC_VIEW_INDEX];
 
-    memcpy(bytes, dynamic_view_index, EE_SIZE_DYNAMIC_VIEW_INDEX);
+    raw[0] = (uint8_t)*dynamic_view_index;
 
-    write_eeprom(map_dynamic_view_index_byte1[idx], bytes[0]);
+    write_eeprom_block(map_dynamic_view_index_byte1[idx], raw, EE_SIZE_DYNAMIC_VIEW_INDEX);
 }
 
 bool verify_dynamic_view_index(uint8_t dynamic_view_index)
@@ -3478,9 +6296,7 @@ bool verify_dynamic_view_index(uint8_t dynamic_view_index)
 
 uint8_t get_dynamic_view_index(uint8_t idx)
 {
-    // Verify the View index value is valid
-    if (!verify_dynamic_view_index(settings_dynamic_view_index[idx]))
-        return DEFAULT_DYNAMIC_VIEW_INDEX;
+    SECTION_LOAD(SETTINGS_SECTION_DYNAMIC);
 
     return settings_dynamic_view_index[idx];
 }
@@ -3488,6 +6304,8 @@ uint8_t get_dynamic_view_index(uint8_t idx)
 // Set the View index
 bool set_dynamic_view_index(uint8_t idx, uint8_t dynamic_view_index, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_DYNAMIC);
+
     // Verify the View index value is valid
     if (!verify_dynamic_view_index(dynamic_view_index))
         return false;
@@ -3521,26 +6339,20 @@ bool set_dynamic_view_index(uint8_t idx, uint8_t dynamic_view_index, bool save)
 ********************************************************************************/
 static void load_dynamic_pid(uint8_t idx, uint32_t *dynamic_pid_val)
 {
-    uint8_t bytes[EE_SIZE_DYNAMIC_PID];
+    uint8_t raw[EE_SIZE_DYNAMIC_PID];
 
-    bytes[3] = read_eeprom(map_dynamic_pid_byte1[idx]);
-    bytes[2] = read_eeprom(map_dynamic_pid_byte2[idx]);
-    bytes[1] = read_eeprom(map_dynamic_pid_byte3[idx]);
-    bytes[0] = read_eeprom(map_dynamic_pid_byte4[idx]);
+    read_eeprom_block(map_dynamic_pid_byte1[idx], raw, EE_SIZE_DYNAMIC_PID);
 
-    memcpy(dynamic_pid_val, bytes, EE_SIZE_DYNAMIC_PID);
+    *dynamic_pid_val = decode_u32(raw);
 }
 
 static void save_dynamic_pid(uint8_t idx, uint32_t *dynamic_pid)
 {
-    uint8_t bytes[EE_SIZE_DYNAMIC_PID];
+    uint8_t raw[EE_SIZE_DYNAMIC_PID];
 
-    memcpy(bytes, dynamic_pid, EE_SIZE_DYNAMIC_PID);
+    encode_u32(raw, *dynamic_pid);
 
-    write_eeprom(map_dynamic_pid_byte1[idx], bytes[3]);
-    write_eeprom(map_dynamic_pid_byte2[idx], bytes[2]);
-    write_eeprom(map_dynamic_pid_byte3[idx], bytes[1]);
-    write_eeprom(map_dynamic_pid_byte4[idx], bytes[0]);
+    write_eeprom_block(map_dynamic_pid_byte1[idx], raw, EE_SIZE_DYNAMIC_PID);
 }
 
 bool verify_dynamic_pid(uint32_t dynamic_pid)
@@ -3557,9 +6369,7 @@ bool verify_dynamic_pid(uint32_t dynamic_pid)
 
 uint32_t get_dynamic_pid(uint8_t idx)
 {
-    // Verify the PID assigned to the dynamic gauge value is valid
-    if (!verify_dynamic_pid(settings_dynamic_pid[idx]))
-        return DEFAULT_DYNAMIC_PID;
+    SECTION_LOAD(SETTINGS_SECTION_DYNAMIC);
 
     return settings_dynamic_pid[idx];
 }
@@ -3567,8 +6377,11 @@ uint32_t get_dynamic_pid(uint8_t idx)
 // Set the PID assigned to the dynamic gauge
 bool set_dynamic_pid(uint8_t idx, uint32_t dynamic_pid, bool save)
 {
-    // Verify the PID assigned to the dynamic gauge value is valid
-    if (!verify_dynamic_pid(dynamic_pid))
+    SECTION_LOAD(SETTINGS_SECTION_DYNAMIC);
+
+    // Verify the PID assigned to the dynamic gauge value is valid, the unassigned
+    // default is accepted so the field can be reset
+    if (!verify_dynamic_pid(dynamic_pid) && (dynamic_pid != DEFAULT_DYNAMIC_PID))
         return false;
 
     // Check to see if the PID assigned to the dynamic gauge EEPROM value needs to be
@@ -3600,20 +6413,20 @@ bool set_dynamic_pid(uint8_t idx, uint32_t dynamic_pid, bool save)
 ********************************************************************************/
 static void load_dynamic_units(uint8_t idx, PID_UNITS *dynamic_units_val)
 {
-    uint8_t bytes[EE_SIZE_DYNAMIC_UNITS];
+    uint8_t raw[EE_SIZE_DYNAMIC_UNITS];
 
-    bytes[0] = read_eeprom(map_dynamic_units_byte1[idx]);
+    read_eeprom_block(map_dynamic_units_byte1[idx], raw, EE_SIZE_DYNAMIC_UNITS);
 
-    memcpy(dynamic_units_val, bytes, EE_SIZE_DYNAMIC_UNITS);
+    *dynamic_units_val = (PID_UNITS)raw[0];
 }
 
 static void save_dynamic_units(uint8_t idx, PID_UNITS *dynamic_units)
 {
-    uint8_t bytes[EE_SIZE_DYNAMIC_UNITS];
+    uint8_t raw[EE_SIZE_DYNAMIC_UNITS];
 
-    memcpy(bytes, dynamic_units, EE_SIZE_DYNAMIC_UNITS);
+    raw[0] = (uint8_t)*dynamic_units;
 
-    write_eeprom(map_dynamic_units_byte1[idx], bytes[0]);
+    write_eeprom_block(map_dynamic_units_byte1[idx], raw, EE_SIZE_DYNAMIC_UNITS);
 }
 
 bool verify_dynamic_units(PID_UNITS dynamic_units)
@@ -3630,9 +6443,7 @@ bool verify_dynamic_units(PID_UNITS dynamic_units)
 
 PID_UNITS get_dynamic_units(uint8_t idx)
 {
-    // Verify the PID units assigned to the dynamic value is valid
-    if (!verify_dynamic_units(settings_dynamic_units[idx]))
-        return DEFAULT_DYNAMIC_UNITS;
+    SECTION_LOAD(SETTINGS_SECTION_DYNAMIC);
 
     return settings_dynamic_units[idx];
 }
@@ -3640,6 +6451,8 @@ PID_UNITS get_dynamic_units(uint8_t idx)
 // Set the PID units assigned to the dynamic
 bool set_dynamic_units(uint8_t idx, PID_UNITS dynamic_units, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_DYNAMIC);
+
     // Verify the PID units assigned to the dynamic value is valid
     if (!verify_dynamic_units(dynamic_units))
         return false;
@@ -3673,32 +6486,31 @@ bool set_dynamic_units(uint8_t idx, PID_UNITS dynamic_units, bool save)
 ********************************************************************************/
 static void load_general_ee_version(uint8_t idx, uint8_t *general_ee_version_val)
 {
-    uint8_t bytes[EE_SIZE_GENERAL_EE_VERSION];
+    uint8_t raw[EE_SIZE_GENERAL_EE_VERSION];
 
-    bytes[0] = read_eeprom(map_general_ee_version_byte1[idx]);
+    read_eeprom_block(map_general_ee_version_byte1[idx], raw, EE_SIZE_GENERAL_EE_VERSION);
 
-    memcpy(general_ee_version_val, bytes, EE_SIZE_GENERAL_EE_VERSION);
+    *general_ee_version_val = raw[0];
 }
 
 static void save_general_ee_version(uint8_t idx, uint8_t *general_ee_version)
 {
-    uint8_t bytes[EE_SIZE_GENERAL_EE_VERSION];
+    uint8_t raw[EE_SIZE_GENERAL_EE_VERSION];
 
-    memcpy(bytes, general_ee_version, EE_SIZE_GENERAL_EE_VERSION);
+    raw[0] = (uint8_t)*general_ee_version;
 
-    write_eeprom(map_general_ee_version_byte1[idx], bytes[0]);
+    write_eeprom_block(map_general_ee_version_byte1[idx], raw, EE_SIZE_GENERAL_EE_VERSION);
 }
 
+// EE_Version mirrors the stored layout, so the current layout is the only valid value
 bool verify_general_ee_version(uint8_t general_ee_version)
 {
-    return 1;
+    return general_ee_version == EE_LAYOUT_VERSION;
 }
 
 uint8_t get_general_ee_version(uint8_t idx)
 {
-    // Verify the EEPROM Version value is valid
-    if (!verify_general_ee_version(settings_general_ee_version[idx]))
-        return DEFAULT_GENERAL_EE_VERSION;
+    SECTION_LOAD(SETTINGS_SECTION_GENERAL);
 
     return settings_general_ee_version[idx];
 }
@@ -3706,6 +6518,8 @@ uint8_t get_general_ee_version(uint8_t idx)
 // Set the EEPROM Version
 bool set_general_ee_version(uint8_t idx, uint8_t general_ee_version, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_GENERAL);
+
     // Verify the EEPROM Version value is valid
     if (!verify_general_ee_version(general_ee_version))
         return false;
@@ -3739,22 +6553,20 @@ bool set_general_ee_version(uint8_t idx, uint8_t general_ee_version, bool save)
 ********************************************************************************/
 static void load_general_splash(uint8_t idx, uint16_t *general_splash_val)
 {
-    uint8_t bytes[EE_SIZE_GENERAL_SPLASH];
+    uint8_t raw[EE_SIZE_GENERAL_SPLASH];
 
-    bytes[1] = read_eeprom(map_general_splash_byte1[idx]);
-    bytes[0] = read_eeprom(map_general_splash_byte2[idx]);
+    read_eeprom_block(map_general_splash_byte1[idx], raw, EE_SIZE_GENERAL_SPLASH);
 
-    memcpy(general_splash_val, bytes, EE_SIZE_GENERAL_SPLASH);
+    *general_splash_val = decode_u16(raw);
 }
 
 static void save_general_splash(uint8_t idx, uint16_t *general_splash)
 {
-    uint8_t bytes[EE_SIZE_GENERAL_SPLASH];
+    uint8_t raw[EE_SIZE_GENERAL_SPLASH];
 
-    memcpy(bytes, general_splash, EE_SIZE_GENERAL_SPLASH);
+    encode_u16(raw, *general_splash);
 
-    write_eeprom(map_general_splash_byte1[idx], bytes[1]);
-    write_eeprom(map_general_splash_byte2[idx], bytes[0]);
+    write_eeprom_block(map_general_splash_byte1[idx], raw, EE_SIZE_GENERAL_SPLASH);
 }
 
 bool verify_general_splash(uint16_t general_splash)
@@ -3768,9 +6580,7 @@ bool verify_general_splash(uint16_t general_splash)
 
 uint16_t get_general_splash(uint8_t idx)
 {
-    // Verify the Splash Screen Duration value is valid
-    if (!verify_general_splash(settings_general_splash[idx]))
-        return DEFAULT_GENERAL_SPLASH;
+    SECTION_LOAD(SETTINGS_SECTION_GENERAL);
 
     return settings_general_splash[idx];
 }
@@ -3778,6 +6588,8 @@ uint16_t get_general_splash(uint8_t idx)
 // Set the Splash Screen Duration
 bool set_general_splash(uint8_t idx, uint16_t general_splash, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_GENERAL);
+
     // Verify the Splash Screen Duration value is valid
     if (!verify_general_splash(general_splash))
         return false;
@@ -3810,26 +6622,26 @@ bool set_general_splash(uint8_t idx, uint16_t general_splash, bool save)
 *
 ********************************************************************************/
 const char *can_bus_mode_string[] = {
-    "Normal Mode",
-    "Listen Only"
+    CAN_BUS_MODE_STRINGS(OPTION_STRING, OPTION_STRING_NEXT)
 };
+_Static_assert(sizeof(can_bus_mode_string) / sizeof(can_bus_mode_string[0]) == CAN_BUS_MODE_RESERVED, "one string per CAN_BUS_MODE value");
 
 static void load_general_can_bus_mode(uint8_t idx, CAN_BUS_MODE *general_can_bus_mode_val)
 {
-    uint8_t bytes[EE_SIZE_GENERAL_CAN_BUS_MODE];
+    uint8_t raw[EE_SIZE_GENERAL_CAN_BUS_MODE];
 
-    bytes[0] = read_eeprom(map_general_can_bus_mode_byte1[idx]);
+    read_eeprom_block(map_general_can_bus_mode_byte1[idx], raw, EE_SIZE_GENERAL_CAN_BUS_MODE);
 
-    memcpy(general_can_bus_mode_val, bytes, EE_SIZE_GENERAL_CAN_BUS_MODE);
+    *general_can_bus_mode_val = (CAN_BUS_MODE)raw[0];
 }
 
 static void save_general_can_bus_mode(uint8_t idx, CAN_BUS_MODE *general_can_bus_mode)
 {
-    uint8_t bytes[EE_SIZE_GENERAL_CAN_BUS_MODE];
+    uint8_t raw[EE_SIZE_GENERAL_CAN_BUS_MODE];
 
-    memcpy(bytes, general_can_bus_mode, EE_SIZE_GENERAL_CAN_BUS_MODE);
+    raw[0] = (uint8_t)*general_can_bus_mode;
 
-    write_eeprom(map_general_can_bus_mode_byte1[idx], bytes[0]);
+    write_eeprom_block(map_general_can_bus_mode_byte1[idx], raw, EE_SIZE_GENERAL_CAN_BUS_MODE);
 }
 
 bool verify_general_can_bus_mode(CAN_BUS_MODE general_can_bus_mode)
@@ -3842,9 +6654,7 @@ bool verify_general_can_bus_mode(CAN_BUS_MODE general_can_bus_mode)
 
 CAN_BUS_MODE get_general_can_bus_mode(uint8_t idx)
 {
-    // Verify the CAN Bus mode value is valid
-    if (!verify_general_can_bus_mode(settings_general_can_bus_mode[idx]))
-        return DEFAULT_GENERAL_CAN_BUS_MODE;
+    SECTION_LOAD(SETTINGS_SECTION_GENERAL);
 
     return settings_general_can_bus_mode[idx];
 }
@@ -3852,6 +6662,8 @@ CAN_BUS_MODE get_general_can_bus_mode(uint8_t idx)
 // Set the CAN Bus mode
 bool set_general_can_bus_mode(uint8_t idx, CAN_BUS_MODE general_can_bus_mode, bool save)
 {
+    SECTION_LOAD(SETTINGS_SECTION_GENERAL);
+
     // Verify the CAN Bus mode value is valid
     if (!verify_general_can_bus_mode(general_can_bus_mode))
         return false;
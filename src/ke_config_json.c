@@ -0,0 +1,671 @@
+/**
+ ******************************************************************************
+ *
+ * Copyright (c) 2025 KaiserEngineering, LLC
+ * Author Matthew Kaiser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************
+ */
+
+#include "ke_config_json.h"
+
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void json_flush(json_writer *writer)
+{
+	if (writer->chunk_len)
+		writer->sink(writer->context, writer->chunk, writer->chunk_len);
+
+	writer->chunk_len = 0;
+}
+
+static void json_emit(json_writer *writer, const char *data, uint32_t len)
+{
+	if (writer->sink)
+	{
+		while (len)
+		{
+			uint32_t room = JSON_WRITER_CHUNK_SIZE - writer->chunk_len;
+			uint32_t n = (len < room) ? len : room;
+
+			memcpy(&writer->chunk[writer->chunk_len], data, n);
+			writer->chunk_len += n;
+			writer->length += n;
+			data += n;
+			len -= n;
+
+			if (writer->chunk_len == JSON_WRITER_CHUNK_SIZE)
+				json_flush(writer);
+		}
+		return;
+	}
+
+	// One byte is always kept back for the terminator
+	if (writer->length + 1 < writer->buffer_size)
+	{
+		uint32_t room = writer->buffer_size - 1 - writer->length;
+		memcpy(&writer->buffer[writer->length], data, (len < room) ? len : room);
+	}
+
+	writer->length += len;
+}
+
+static void json_emit_string(json_writer *writer, const char *value, uint32_t max_len)
+{
+	static const char hex[] = "0123456789abcdef";
+	uint32_t run = 0;
+	uint32_t i;
+
+	json_emit(writer, "\"", 1);
+
+	// Plain characters go out in runs, only the escapes are built one by one
+	for (i = 0; (i < max_len) && value[i]; i++)
+	{
+		unsigned char c = (unsigned char)value[i];
+		char escape[6] = { '\\', 0, '0', '0', 0, 0 };
+		uint32_t escape_len = 2;
+
+		if ((c >= 32) && (c != '"') && (c != '\\'))
+			continue;
+
+		json_emit(writer, &value[run], i - run);
+		run = i + 1;
+
+		switch (c)
+		{
+		case '"':
+		case '\\':
+			escape[1] = (char)c;
+			break;
+		case '\b':
+			escape[1] = 'b';
+			break;
+		case '\f':
+			escape[1] = 'f';
+			break;
+		case '\n':
+			escape[1] = 'n';
+			break;
+		case '\r':
+			escape[1] = 'r';
+			break;
+		case '\t':
+			escape[1] = 't';
+			break;
+		default:
+			escape[1] = 'u';
+			escape[4] = hex[c >> 4];
+			escape[5] = hex[c & 0x0F];
+			escape_len = 6;
+			break;
+		}
+
+		json_emit(writer, escape, escape_len);
+	}
+
+	json_emit(writer, &value[run], i - run);
+	json_emit(writer, "\"", 1);
+}
+
+// Separates the value from the previous member and writes its key
+static void json_member(json_writer *writer, const char *key)
+{
+	if (writer->depth)
+	{
+		uint8_t bit = 1 << (writer->depth - 1);
+
+		if (writer->first & bit)
+			writer->first &= ~bit;
+		else
+			json_emit(writer, ",", 1);
+	}
+
+	if (key)
+	{
+		json_emit_string(writer, key, UINT32_MAX);
+		json_emit(writer, ":", 1);
+	}
+}
+
+static void json_open(json_writer *writer, const char *key, const char *token)
+{
+	json_member(writer, key);
+	json_emit(writer, token, 1);
+
+	if (writer->depth < JSON_WRITER_MAX_DEPTH)
+	{
+		writer->depth++;
+		writer->first |= 1 << (writer->depth - 1);
+	}
+}
+
+static void json_close(json_writer *writer, const char *token)
+{
+	if (writer->depth)
+		writer->depth--;
+
+	json_emit(writer, token, 1);
+}
+
+void json_writer_init(json_writer *writer, char *buffer, uint32_t buffer_size)
+{
+	memset(writer, 0, sizeof(*writer));
+	writer->buffer = buffer;
+	writer->buffer_size = buffer ? buffer_size : 0;
+}
+
+void json_writer_init_sink(json_writer *writer, json_sink *sink, void *context)
+{
+	memset(writer, 0, sizeof(*writer));
+	writer->sink = sink;
+	writer->context = context;
+}
+
+void json_begin_object(json_writer *writer, const char *key)
+{
+	json_open(writer, key, "{");
+}
+
+void json_end_object(json_writer *writer)
+{
+	json_close(writer, "}");
+}
+
+void json_begin_array(json_writer *writer, const char *key)
+{
+	json_open(writer, key, "[");
+}
+
+void json_end_array(json_writer *writer)
+{
+	json_close(writer, "]");
+}
+
+void json_add_string(json_writer *writer, const char *key, const char *value)
+{
+	json_add_string_n(writer, key, value, UINT32_MAX);
+}
+
+void json_add_string_n(json_writer *writer, const char *key, const char *value, uint32_t max_len)
+{
+	json_member(writer, key);
+	json_emit_string(writer, value ? value : "", max_len);
+}
+
+// Equality within one ulp of the larger value, the round trip test cJSON uses
+static bool json_same_double(double a, double b)
+{
+	double max = (fabs(a) > fabs(b)) ? fabs(a) : fabs(b);
+	return fabs(a - b) <= max * DBL_EPSILON;
+}
+
+// Same number format as cJSON, integral values print as int and everything
+// else with 15 digits, or 17 when 15 do not read back
+void json_add_number(json_writer *writer, const char *key, double value)
+{
+	char number[26];
+	int len;
+
+	json_member(writer, key);
+
+	if (isnan(value) || isinf(value))
+	{
+		json_emit(writer, "null", 4);
+		return;
+	}
+
+	int valueint = (value >= INT_MAX) ? INT_MAX : (value <= (double)INT_MIN) ? INT_MIN : (int)value;
+
+	if (value == (double)valueint)
+	{
+		len = snprintf(number, sizeof(number), "%d", valueint);
+	}
+	else
+	{
+		len = snprintf(number, sizeof(number), "%1.15g", value);
+		if (!json_same_double(strtod(number, NULL), value))
+			len = snprintf(number, sizeof(number), "%1.17g", value);
+	}
+
+	if ((len > 0) && (len < (int)sizeof(number)))
+		json_emit(writer, number, (uint32_t)len);
+}
+
+uint32_t json_writer_finish(json_writer *writer)
+{
+	if (writer->sink)
+	{
+		json_flush(writer);
+		return writer->length;
+	}
+
+	if (writer->length < writer->buffer_size)
+	{
+		writer->buffer[writer->length] = '\0';
+		return writer->length;
+	}
+
+	return 0;
+}
+
+void json_window_init(json_window *window, char *buffer, uint32_t size, uint32_t offset)
+{
+	window->buffer = buffer;
+	window->size = buffer ? size : 0;
+	window->offset = offset;
+	window->position = 0;
+	window->written = 0;
+}
+
+void json_window_sink(void *context, const char *data, uint32_t len)
+{
+	json_window *window = context;
+	uint32_t start = window->position;
+
+	window->position += len;
+
+	// Skip chunks before the window and everything once it is full
+	if ((window->position <= window->offset) || (window->written == window->size))
+		return;
+
+	if (start < window->offset)
+	{
+		data += window->offset - start;
+		len -= window->offset - start;
+	}
+
+	uint32_t room = window->size - window->written;
+	if (len > room)
+		len = room;
+
+	memcpy(&window->buffer[window->written], data, len);
+	window->written += len;
+}
+
+enum
+{
+	READ_VALUE,
+	READ_VALUE_OR_END,
+	READ_KEY,
+	READ_KEY_OR_END,
+	READ_COLON,
+	READ_NEXT,
+	READ_STRING,
+	READ_ESCAPE,
+	READ_UNICODE,
+	READ_NUMBER,
+	READ_LITERAL,
+	READ_DONE,
+	READ_ERROR
+};
+
+static bool json_token_put(json_reader *reader, char c)
+{
+	// One byte is always kept back for the terminator
+	if (reader->token_len + 1 >= JSON_READER_TOKEN_SIZE)
+		return false;
+
+	reader->token[reader->token_len++] = c;
+	return true;
+}
+
+// Keys and strings that outgrow the token are cut short, the rest of the
+// string is still parsed but dropped
+static void json_string_put(json_reader *reader, char c)
+{
+	if (reader->truncated || !json_token_put(reader, c))
+		reader->truncated = true;
+}
+
+static void json_string_put_utf8(json_reader *reader, uint32_t cp)
+{
+	uint8_t len = (cp < 0x80) ? 1 : (cp < 0x800) ? 2 : (cp < 0x10000) ? 3 : 4;
+
+	// An escaped character goes in whole or not at all
+	if (reader->truncated || (reader->token_len + len >= JSON_READER_TOKEN_SIZE))
+	{
+		reader->truncated = true;
+		return;
+	}
+
+	if (len == 1)
+		json_string_put(reader, (char)cp);
+	else if (len == 2)
+		json_string_put(reader, (char)(0xC0 | (cp >> 6)));
+	else if (len == 3)
+		json_string_put(reader, (char)(0xE0 | (cp >> 12)));
+	else
+		json_string_put(reader, (char)(0xF0 | (cp >> 18)));
+
+	while (--len)
+		json_string_put(reader, (char)(0x80 | ((cp >> (6 * (len - 1))) & 0x3F)));
+}
+
+// Drops the tail of a raw multi-byte character the truncation split
+static void json_string_trim(json_reader *reader)
+{
+	uint16_t len = reader->token_len;
+	uint8_t continuation = 0;
+
+	while (len && (continuation < 3) && (((uint8_t)reader->token[len - 1] & 0xC0) == 0x80))
+	{
+		len--;
+		continuation++;
+	}
+	if (!len)
+		return;
+
+	uint8_t lead = (uint8_t)reader->token[len - 1];
+	uint8_t need = (lead >= 0xF0) ? 3 : (lead >= 0xE0) ? 2 : (lead >= 0xC0) ? 1 : 0;
+	if (need > continuation)
+		reader->token_len = len - 1;
+}
+
+// Hands a finished value to the handler, the next token is a separator
+static bool json_value_done(json_reader *reader, JSON_EVENT event, const char *text, uint32_t len)
+{
+	reader->state = reader->depth ? READ_NEXT : READ_DONE;
+	return reader->handler(reader->context, event, text, len);
+}
+
+static bool json_read_open(json_reader *reader, bool array)
+{
+	if (reader->depth == JSON_READER_MAX_DEPTH)
+		return false;
+
+	if (array)
+		reader->arrays |= (uint32_t)1 << reader->depth;
+	else
+		reader->arrays &= ~((uint32_t)1 << reader->depth);
+
+	reader->depth++;
+	reader->state = array ? READ_VALUE_OR_END : READ_KEY_OR_END;
+	return reader->handler(reader->context, array ? JSON_EVENT_ARRAY_BEGIN : JSON_EVENT_OBJECT_BEGIN, NULL, 0);
+}
+
+static bool json_read_close(json_reader *reader, bool array)
+{
+	if (!reader->depth || (((reader->arrays >> (reader->depth - 1)) & 1) != array))
+		return false;
+
+	reader->depth--;
+	return json_value_done(reader, array ? JSON_EVENT_ARRAY_END : JSON_EVENT_OBJECT_END, NULL, 0);
+}
+
+static bool json_end_string(json_reader *reader)
+{
+	if (reader->truncated)
+		json_string_trim(reader);
+	reader->truncated = false;
+	reader->token[reader->token_len] = '\0';
+
+	if (!reader->key)
+		return json_value_done(reader, JSON_EVENT_STRING, reader->token, reader->token_len);
+
+	reader->state = READ_COLON;
+	return reader->handler(reader->context, JSON_EVENT_KEY, reader->token, reader->token_len);
+}
+
+static bool json_end_number(json_reader *reader)
+{
+	char *end;
+
+	reader->token[reader->token_len] = '\0';
+	strtod(reader->token, &end);
+	if (end != &reader->token[reader->token_len])
+		return false;
+
+	return json_value_done(reader, JSON_EVENT_NUMBER, reader->token, reader->token_len);
+}
+
+static bool json_start_value(json_reader *reader, char c)
+{
+	reader->token_len = 0;
+
+	switch (c)
+	{
+	case '{':
+		return json_read_open(reader, false);
+	case '[':
+		return json_read_open(reader, true);
+	case '"':
+		reader->key = false;
+		reader->state = READ_STRING;
+		return true;
+	case 't':
+		reader->literal = "true";
+		break;
+	case 'f':
+		reader->literal = "false";
+		break;
+	case 'n':
+		reader->literal = "null";
+		break;
+	default:
+		if ((c != '-') && ((c < '0') || (c > '9')))
+			return false;
+		reader->state = READ_NUMBER;
+		return json_token_put(reader, c);
+	}
+
+	reader->token_len = 1;
+	reader->state = READ_LITERAL;
+	return true;
+}
+
+static bool json_read_string(json_reader *reader, char c)
+{
+	// A high surrogate escape must be followed by its low half
+	if (reader->high_surrogate && (c != '\\'))
+		return false;
+
+	if (c == '"')
+		return json_end_string(reader);
+	if (c == '\\')
+	{
+		reader->state = READ_ESCAPE;
+		return true;
+	}
+	if ((unsigned char)c < 32)
+		return false;
+
+	json_string_put(reader, c);
+	return true;
+}
+
+static bool json_read_escape(json_reader *reader, char c)
+{
+	static const char escapes[] = "\"\"\\\\//b\bf\fn\nr\rt\t";
+
+	reader->state = READ_STRING;
+
+	if (c == 'u')
+	{
+		reader->unicode = 0;
+		reader->digits = 0;
+		reader->state = READ_UNICODE;
+		return true;
+	}
+	if (reader->high_surrogate)
+		return false;
+
+	for (uint8_t i = 0; escapes[i]; i += 2)
+	{
+		if (escapes[i] == c)
+		{
+			json_string_put(reader, escapes[i + 1]);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool json_read_unicode(json_reader *reader, char c)
+{
+	uint8_t digit;
+
+	if ((c >= '0') && (c <= '9'))
+		digit = c - '0';
+	else if ((c >= 'a') && (c <= 'f'))
+		digit = c - 'a' + 10;
+	else if ((c >= 'A') && (c <= 'F'))
+		digit = c - 'A' + 10;
+	else
+		return false;
+
+	reader->unicode = (reader->unicode << 4) | digit;
+	if (++reader->digits < 4)
+		return true;
+
+	uint16_t unit = reader->unicode;
+	reader->state = READ_STRING;
+
+	if (reader->high_surrogate)
+	{
+		if ((unit < 0xDC00) || (unit > 0xDFFF))
+			return false;
+
+		uint32_t cp = 0x10000 + (((uint32_t)(reader->high_surrogate - 0xD800) << 10) | (unit - 0xDC00));
+		reader->high_surrogate = 0;
+		json_string_put_utf8(reader, cp);
+		return true;
+	}
+	if ((unit >= 0xD800) && (unit <= 0xDBFF))
+	{
+		reader->high_surrogate = unit;
+		return true;
+	}
+
+	// Lone low surrogates and NUL cannot be carried in the token
+	if ((unit == 0) || ((unit >= 0xDC00) && (unit <= 0xDFFF)))
+		return false;
+
+	json_string_put_utf8(reader, unit);
+	return true;
+}
+
+static bool json_reader_char(json_reader *reader, char c)
+{
+	switch (reader->state)
+	{
+	case READ_STRING:
+		return json_read_string(reader, c);
+	case READ_ESCAPE:
+		return json_read_escape(reader, c);
+	case READ_UNICODE:
+		return json_read_unicode(reader, c);
+	case READ_LITERAL:
+		if (c != reader->literal[reader->token_len])
+			return false;
+		if (reader->literal[++reader->token_len])
+			return true;
+		return json_value_done(reader, (reader->literal[0] == 't') ? JSON_EVENT_TRUE : (reader->literal[0] == 'f') ? JSON_EVENT_FALSE : JSON_EVENT_NULL, NULL, 0);
+	case READ_NUMBER:
+		if (((c >= '0') && (c <= '9')) || (c == '-') || (c == '+') || (c == '.') || (c == 'e') || (c == 'E'))
+			return json_token_put(reader, c);
+
+		// The character that ended the number is read as structure
+		if (!json_end_number(reader))
+			return false;
+		break;
+	case READ_ERROR:
+		return false;
+	default:
+		break;
+	}
+
+	if ((c == ' ') || (c == '\t') || (c == '\n') || (c == '\r'))
+		return true;
+
+	switch (reader->state)
+	{
+	case READ_VALUE_OR_END:
+		if (c == ']')
+			return json_read_close(reader, true);
+		return json_start_value(reader, c);
+	case READ_VALUE:
+		return json_start_value(reader, c);
+	case READ_KEY_OR_END:
+		if (c == '}')
+			return json_read_close(reader, false);
+		/* fall through */
+	case READ_KEY:
+		if (c != '"')
+			return false;
+		reader->token_len = 0;
+		reader->key = true;
+		reader->state = READ_STRING;
+		return true;
+	case READ_COLON:
+		if (c != ':')
+			return false;
+		reader->state = READ_VALUE;
+		return true;
+	case READ_NEXT:
+		if (c == ',')
+		{
+			reader->state = ((reader->arrays >> (reader->depth - 1)) & 1) ? READ_VALUE : READ_KEY;
+			return true;
+		}
+		if ((c == ']') || (c == '}'))
+			return json_read_close(reader, c == ']');
+		return false;
+	default:
+		return false;
+	}
+}
+
+void json_reader_init(json_reader *reader, json_handler *handler, void *context)
+{
+	memset(reader, 0, sizeof(*reader));
+	reader->handler = handler;
+	reader->context = context;
+	reader->state = READ_VALUE;
+}
+
+bool json_reader_feed(json_reader *reader, const char *data, uint32_t len)
+{
+	for (uint32_t i = 0; i < len; i++)
+	{
+		if (!json_reader_char(reader, data[i]))
+		{
+			reader->state = READ_ERROR;
+			return false;
+		}
+	}
+
+	return reader->state != READ_ERROR;
+}
+
+bool json_reader_finish(json_reader *reader)
+{
+	// Only a top level number is still open at the end of the input
+	if ((reader->state == READ_NUMBER) && !json_end_number(reader))
+		reader->state = READ_ERROR;
+
+	return reader->state == READ_DONE;
+}
@@ -0,0 +1,172 @@
+/**
+ ******************************************************************************
+ *
+ * Copyright (c) 2025 KaiserEngineering, LLC
+ * Author Matthew Kaiser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************
+ */
+
+#include "ke_config_mmap.h"
+
+#ifndef ESP_PLATFORM
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ke_config.h"
+
+// The whole memory map, what direct storage needs at the least
+#define MMAP_MIN_SIZE 0x0200
+
+static uint8_t *image = NULL;
+static uint32_t image_size = 0;
+static int image_fd = -1;
+
+// Sticky until the next open, the backend calls cannot return an error
+static bool image_error = false;
+
+static void mmap_write_block(uint16_t bAdd, const uint8_t *pData, uint16_t len)
+{
+	if ((uint32_t)bAdd + len <= image_size)
+		memcpy(&image[bAdd], pData, len);
+	else
+		image_error = true;
+}
+
+static void mmap_read_block(uint16_t bAdd, uint8_t *pData, uint16_t len)
+{
+	if ((uint32_t)bAdd + len <= image_size)
+		memcpy(pData, &image[bAdd], len);
+	else
+	{
+		memset(pData, 0xFF, len);
+		image_error = true;
+	}
+}
+
+static void mmap_sync(void)
+{
+	if ((msync(image, image_size, MS_SYNC) != 0) || (fsync(image_fd) != 0))
+		image_error = true;
+}
+
+// The mapping takes any range in one copy, so there is no page limit
+static SETTINGS_BACKEND mmap_backend = {
+	.open = NULL,
+	.read_range = mmap_read_block,
+	.write_range = mmap_write_block,
+	.erase = NULL,
+	.sync = NULL,
+	.caps = {
+		.page_size = 0,
+		.write_granularity = 1,
+		.endurance = 0
+	}
+};
+
+static void mmap_close_image(void)
+{
+	if (msync(image, image_size, MS_SYNC) != 0)
+		image_error = true;
+	munmap(image, image_size);
+	close(image_fd);
+
+	image = NULL;
+	image_size = 0;
+	image_fd = -1;
+}
+
+bool settings_mmap_open(const char *path, uint32_t size, bool sync_on_commit)
+{
+	struct stat st;
+
+	if (image || !path || (size < MMAP_MIN_SIZE) || (size > 0x10000))
+		return false;
+
+	int fd = open(path, O_RDWR | O_CREAT, 0644);
+	if (fd < 0)
+		return false;
+
+	if (fstat(fd, &st) != 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	uint32_t file_size = (st.st_size < (off_t)size) ? (uint32_t)st.st_size : size;
+	if ((st.st_size < (off_t)size) && (ftruncate(fd, size) != 0))
+	{
+		close(fd);
+		return false;
+	}
+
+	uint8_t *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED)
+	{
+		close(fd);
+		return false;
+	}
+
+	// Bytes past the end of the old file read as erased EEPROM
+	if (file_size < size)
+		memset(&map[file_size], 0xFF, size - file_size);
+
+	image = map;
+	image_size = size;
+	image_fd = fd;
+	image_error = false;
+
+	mmap_backend.sync = sync_on_commit ? mmap_sync : NULL;
+	if (!settings_set_backend(&mmap_backend))
+	{
+		mmap_close_image();
+		return false;
+	}
+
+	return true;
+}
+
+void settings_mmap_close(void)
+{
+	if (!image)
+		return;
+
+	// Commits pending pages to the mapping before it goes away
+	if (settings_get_backend() == &mmap_backend)
+		settings_set_backend(NULL);
+
+	mmap_close_image();
+}
+
+uint8_t *settings_mmap_image(void)
+{
+	return image;
+}
+
+bool settings_mmap_error(void)
+{
+	return image_error;
+}
+
+#endif /* ESP_PLATFORM */